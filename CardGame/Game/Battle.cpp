@@ -2,6 +2,8 @@
 #include "Game/Cards/Card.h"
 #include "Game/Frameworks/Game.h"
 #include "Game/Deck.h"
+#include "Engine/Core/Profiler.h"
+#include "Engine/Core/AllocationTracker.h"
 
 Battle::Battle( EnemyInfo const& enemyInfo )
 {
@@ -150,6 +152,8 @@ void Battle::PerformNextStep()
 
 void Battle::Update( float deltaSeconds )
 {
+	PROFILE_SCOPE( "Battle::Update" );
+	ALLOCATION_TAG_SCOPE( "Battle::Update" );
 	HandleMouseInput();
 
 	if (m_battleState == BattleState::SelfStartTurn) {
@@ -226,28 +230,24 @@ void Battle::Update( float deltaSeconds )
 	}
 
 	UpdateCardPosition();
+}
 
-	for (auto card : m_myCardsInBattleLine) {
-		card->Update( deltaSeconds );
-	}
-	for (auto card : m_enemyCardsInBattleLine) {
-		card->Update( deltaSeconds );
-	}
-	for (auto card : m_myCardsInWaitingList) {
-		card->Update( deltaSeconds );
-	}
-	for (auto card : m_enemyCardsInWaitingList) {
-		card->Update( deltaSeconds );
-	}
+void Battle::GetEntitiesToUpdate( std::vector<EntityBase*>& out_entities ) const
+{
+	out_entities.insert( out_entities.end(), m_myCardsInBattleLine.begin(), m_myCardsInBattleLine.end() );
+	out_entities.insert( out_entities.end(), m_enemyCardsInBattleLine.begin(), m_enemyCardsInBattleLine.end() );
+	out_entities.insert( out_entities.end(), m_myCardsInWaitingList.begin(), m_myCardsInWaitingList.end() );
+	out_entities.insert( out_entities.end(), m_enemyCardsInWaitingList.begin(), m_enemyCardsInWaitingList.end() );
 	if (m_currentCardToPlay && m_currentCardToPlayIndex == -1) {
-		m_currentCardToPlay->Update( deltaSeconds );
+		out_entities.push_back( m_currentCardToPlay );
 	}
-	m_myDeck->Update( deltaSeconds );
-	m_enemyDeck->Update( deltaSeconds );
+	out_entities.push_back( m_myDeck );
+	out_entities.push_back( m_enemyDeck );
 }
 
 void Battle::Render() const
 {
+	ALLOCATION_TAG_SCOPE( "Battle::Render" );
 	for (auto card : m_myCardsInBattleLine) {
 		card->Render();
 	}
@@ -388,13 +388,13 @@ void Battle::RemoveDeadCards( bool isSelf )
 		Card* card = m_myCardsInBattleLine[i];
 		Vec2 centerPos = Vec2( BattleLineLeftX + i * CardsSpacing, -BattleLineY );
 		card->m_cardBounds2D = AABB2( centerPos - Vec2( CardWidth * 0.5f, CardHeight * 0.5f ), centerPos + Vec2( CardWidth * 0.5f, CardHeight * 0.5f ) );
-		card->m_position = Vec3( BattleLineLeftX + i * CardsSpacing, -BattleLineY, CardsInBattleLineHeight );
+		card->SetPosition( Vec3( BattleLineLeftX + i * CardsSpacing, -BattleLineY, CardsInBattleLineHeight ) );
 	}
 	for (size_t i = 0; i < m_enemyCardsInBattleLine.size(); ++i) {
 		Card* card = m_enemyCardsInBattleLine[i];
 		Vec2 centerPos = Vec2( BattleLineLeftX + i * CardsSpacing, BattleLineY );
 		card->m_cardBounds2D = AABB2( centerPos - Vec2( CardWidth * 0.5f, CardHeight * 0.5f ), centerPos + Vec2( CardWidth * 0.5f, CardHeight * 0.5f ) );
-		card->m_position = Vec3( BattleLineLeftX + i * CardsSpacing, BattleLineY, CardsInBattleLineHeight );
+		card->SetPosition( Vec3( BattleLineLeftX + i * CardsSpacing, BattleLineY, CardsInBattleLineHeight ) );
 	}
 	for (size_t i = 0; i < m_myCardsInBattleLine.size(); ++i) {
 		m_myCardsInBattleLine[i]->m_targetPosInBattleLine = (uint32_t)i;
@@ -410,25 +410,25 @@ void Battle::UpdateCardPosition()
  		Card* card = m_myCardsInBattleLine[i];
  		Vec2 centerPos = Vec2( BattleLineLeftX + i * CardsSpacing, -BattleLineY );
  		card->m_cardBounds2D = AABB2( centerPos - Vec2( CardWidth * 0.5f, CardHeight * 0.5f ), centerPos + Vec2( CardWidth * 0.5f, CardHeight * 0.5f ) );
-// 		card->m_position = Vec3( BattleLineLeftX + i * CardsSpacing, -BattleLineY, CardsInBattleLineHeight );
+// 		card->SetPosition( Vec3( BattleLineLeftX + i * CardsSpacing, -BattleLineY, CardsInBattleLineHeight ) );
  	}
 	for (size_t i = 0; i < m_enemyCardsInBattleLine.size(); ++i) {
 		Card* card = m_enemyCardsInBattleLine[i];
 		Vec2 centerPos = Vec2( BattleLineLeftX + i * CardsSpacing, BattleLineY );
 		card->m_cardBounds2D = AABB2( centerPos - Vec2( CardWidth * 0.5f, CardHeight * 0.5f ), centerPos + Vec2( CardWidth * 0.5f, CardHeight * 0.5f ) );
-		card->m_position = Vec3( BattleLineLeftX + i * CardsSpacing, BattleLineY, CardsInBattleLineHeight );
+		card->SetPosition( Vec3( BattleLineLeftX + i * CardsSpacing, BattleLineY, CardsInBattleLineHeight ) );
 	}
 	for (size_t i = 0; i < m_myCardsInWaitingList.size(); ++i) {
 		Card* card = m_myCardsInWaitingList[i];
 		Vec2 centerPos = Vec2( HandsLineLeftX + i * CardsSpacing, -HandsLineY );
 		card->m_cardBounds2D = AABB2( centerPos - Vec2( CardWidth * 0.5f, CardHeight * 0.5f ), centerPos + Vec2( CardWidth * 0.5f, CardHeight * 0.5f ) );
-		card->m_position = Vec3( HandsLineLeftX + i * CardsSpacing, -HandsLineY, CardsInHandsHeight );
+		card->SetPosition( Vec3( HandsLineLeftX + i * CardsSpacing, -HandsLineY, CardsInHandsHeight ) );
 	}
 	for (size_t i = 0; i < m_enemyCardsInWaitingList.size(); ++i) {
 		Card* card = m_enemyCardsInWaitingList[i];
 		Vec2 centerPos = Vec2( HandsLineLeftX + i * CardsSpacing, HandsLineY );
 		card->m_cardBounds2D = AABB2( centerPos - Vec2( CardWidth * 0.5f, CardHeight * 0.5f ), centerPos + Vec2( CardWidth * 0.5f, CardHeight * 0.5f ) );
-		card->m_position = Vec3( HandsLineLeftX + i * CardsSpacing, HandsLineY, CardsInHandsHeight );
+		card->SetPosition( Vec3( HandsLineLeftX + i * CardsSpacing, HandsLineY, CardsInHandsHeight ) );
 	}
 }
 
@@ -491,7 +491,7 @@ void Battle::HandleMouseInput()
 			if (m_currentCardToPlayIndex == -1) {
 				m_currentCardToPlayIndex = index;
 				m_myCardsInBattleLine.insert( m_myCardsInBattleLine.begin() + index, m_currentCardToPlay );
-				m_currentCardToPlay->m_position = Vec3( BattleLineLeftX + index * CardsSpacing, -BattleLineY, CardsInBattleLineHeight );
+				m_currentCardToPlay->SetPosition( Vec3( BattleLineLeftX + index * CardsSpacing, -BattleLineY, CardsInBattleLineHeight ) );
 				m_currentCardToPlay->m_notShowCard = false;
 				m_currentCardToPlay->m_showDetail = true;
 				refreshCardsIndex = true;
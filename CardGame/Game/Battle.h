@@ -16,7 +16,10 @@ public:
 	~Battle();
 	void BeginPlay();
 	void PerformNextStep();
+	/// serial part of the frame: mouse input, the step timer and the card slots, the cards themselves are updated by the game
 	void Update( float deltaSeconds );
+	/// the cards and decks to update this frame, in the order they are drawn
+	void GetEntitiesToUpdate( std::vector<EntityBase*>& out_entities ) const;
 	void Render() const;
 
 protected:
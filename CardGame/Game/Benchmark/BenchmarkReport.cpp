@@ -0,0 +1,255 @@
+#include "Game/Benchmark/BenchmarkReport.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/// timing changes smaller than this are reported as noise
+constexpr double BenchmarkTimingTolerance = 0.1;
+
+BenchmarkReport::BenchmarkReport( std::string const& sceneName, uint32_t entityCount, std::string const& rendererName, uint32_t warmupFrames, uint64_t frames )
+	:m_sceneName( sceneName ), m_rendererName( rendererName ), m_entityCount( entityCount ), m_warmupFrames( warmupFrames )
+{
+	m_cpuFrameMilliseconds.reserve( frames );
+}
+
+void BenchmarkReport::SetAllocationBudget( AllocationBudget const& budget )
+{
+	m_hasAllocationBudget = true;
+	m_allocationBudget = budget;
+}
+
+void BenchmarkReport::SetRegressionThreshold( double threshold )
+{
+	m_hasRegressionThreshold = true;
+	m_regressionThreshold = threshold;
+}
+
+void BenchmarkReport::AddFrame( double cpuFrameMilliseconds, RendererFrameStatistics const& statistics, AllocationFrameStatistics const& allocations )
+{
+	++m_frames;
+	RendererFrameStatistics& peak = m_statisticsPeak;
+	peak.m_sharedVertexBuffer.m_size = std::max( peak.m_sharedVertexBuffer.m_size, statistics.m_sharedVertexBuffer.m_size );
+	peak.m_sharedIndexBuffer.m_size = std::max( peak.m_sharedIndexBuffer.m_size, statistics.m_sharedIndexBuffer.m_size );
+	peak.m_sharedUniformBuffer.m_size = std::max( peak.m_sharedUniformBuffer.m_size, statistics.m_sharedUniformBuffer.m_size );
+	// the first frames include spawning and pipeline warm up
+	if (m_frames <= m_warmupFrames) {
+		return;
+	}
+	m_cpuFrameMilliseconds.push_back( cpuFrameMilliseconds );
+	RendererFrameStatistics& sum = m_statisticsSum;
+	sum.m_draws += statistics.m_draws;
+	sum.m_pipelineBinds += statistics.m_pipelineBinds;
+	sum.m_descriptorSetWrites += statistics.m_descriptorSetWrites;
+	sum.m_vertexUploadBytes += statistics.m_vertexUploadBytes;
+	sum.m_indexUploadBytes += statistics.m_indexUploadBytes;
+	sum.m_uniformUploadBytes += statistics.m_uniformUploadBytes;
+	sum.m_vertexBytesDrawn += statistics.m_vertexBytesDrawn;
+	sum.m_indexBytesDrawn += statistics.m_indexBytesDrawn;
+	sum.m_stagingBytesUsed += statistics.m_stagingBytesUsed;
+
+	m_allocationsSum += allocations.m_allocations;
+	m_allocatedBytesSum += allocations.m_bytes;
+	if (allocations.m_allocations > m_worstAllocationFrame.m_allocations) {
+		m_worstAllocationFrame = allocations;
+	}
+	if (m_hasAllocationBudget && m_allocationBudget.IsExceededBy( allocations )) {
+		++m_framesOverAllocationBudget;
+	}
+}
+
+/// nearest rank percentile of sorted values
+static double GetPercentile( std::vector<double> const& sortedValues, double percentile )
+{
+	if (sortedValues.empty()) {
+		return 0.0;
+	}
+	size_t rank = (size_t)std::ceil( percentile / 100.0 * sortedValues.size() );
+	rank = std::clamp( rank, (size_t)1, sortedValues.size() );
+	return sortedValues[rank - 1];
+}
+
+void BenchmarkReport::Finish()
+{
+	std::vector<double> sorted = m_cpuFrameMilliseconds;
+	std::sort( sorted.begin(), sorted.end() );
+	double sum = 0.0;
+	for (double value : sorted) {
+		sum += value;
+	}
+	double measuredFrames = sorted.empty() ? 1.0 : (double)sorted.size();
+
+	m_values.clear();
+	AddValue( "count", m_entityCount );
+	AddValue( "frames", m_frames );
+	AddValue( "measuredFrames", (double)sorted.size() );
+	AddValue( "cpuFrameMeanMs", sum / measuredFrames );
+	AddValue( "cpuFrameP50Ms", GetPercentile( sorted, 50.0 ) );
+	AddValue( "cpuFrameP90Ms", GetPercentile( sorted, 90.0 ) );
+	AddValue( "cpuFrameP95Ms", GetPercentile( sorted, 95.0 ) );
+	AddValue( "cpuFrameP99Ms", GetPercentile( sorted, 99.0 ) );
+	AddValue( "cpuFrameMaxMs", sorted.empty() ? 0.0 : sorted.back() );
+	AddValue( "drawsPerFrame", m_statisticsSum.m_draws / measuredFrames );
+	AddValue( "pipelineBindsPerFrame", m_statisticsSum.m_pipelineBinds / measuredFrames );
+	AddValue( "descriptorWritesPerFrame", m_statisticsSum.m_descriptorSetWrites / measuredFrames );
+	AddValue( "vertexUploadBytesPerFrame", m_statisticsSum.m_vertexUploadBytes / measuredFrames );
+	AddValue( "indexUploadBytesPerFrame", m_statisticsSum.m_indexUploadBytes / measuredFrames );
+	AddValue( "uniformUploadBytesPerFrame", m_statisticsSum.m_uniformUploadBytes / measuredFrames );
+	AddValue( "vertexBytesDrawnPerFrame", m_statisticsSum.m_vertexBytesDrawn / measuredFrames );
+	AddValue( "indexBytesDrawnPerFrame", m_statisticsSum.m_indexBytesDrawn / measuredFrames );
+	AddValue( "stagingBytesPerFrame", m_statisticsSum.m_stagingBytesUsed / measuredFrames );
+	AddValue( "allocationsPerFrame", m_allocationsSum / measuredFrames );
+	AddValue( "allocatedBytesPerFrame", m_allocatedBytesSum / measuredFrames );
+	AddValue( "maxAllocationsPerFrame", (double)m_worstAllocationFrame.m_allocations );
+	if (m_hasAllocationBudget) {
+		AddValue( "framesOverAllocationBudget", m_framesOverAllocationBudget );
+	}
+	AddValue( "peakSharedVertexBufferBytes", (double)m_statisticsPeak.m_sharedVertexBuffer.m_size );
+	AddValue( "peakSharedIndexBufferBytes", (double)m_statisticsPeak.m_sharedIndexBuffer.m_size );
+	AddValue( "peakSharedUniformBufferBytes", (double)m_statisticsPeak.m_sharedUniformBuffer.m_size );
+}
+
+bool BenchmarkReport::HasFailed() const
+{
+	return m_framesOverAllocationBudget > 0;
+}
+
+void BenchmarkReport::AddValue( char const* key, double value )
+{
+	m_values.emplace_back( key, value );
+}
+
+bool BenchmarkReport::WriteJson( std::string const& path ) const
+{
+	FILE* file = nullptr;
+	fopen_s( &file, path.c_str(), "w" );
+	if (!file) {
+		return false;
+	}
+	fprintf( file, "{\n\t\"scene\": \"%s\",\n\t\"renderer\": \"%s\"", m_sceneName.c_str(), m_rendererName.c_str() );
+	for (auto const& value : m_values) {
+		fprintf( file, ",\n\t\"%s\": %.6g", value.first.c_str(), value.second );
+	}
+	fprintf( file, "\n}\n" );
+	fclose( file );
+	return true;
+}
+
+void BenchmarkReport::Print() const
+{
+	printf( "Benchmark %s x%u on %s\n", m_sceneName.c_str(), m_entityCount, m_rendererName.c_str() );
+	for (auto const& value : m_values) {
+		printf( "  %-30s %14.3f\n", value.first.c_str(), value.second );
+	}
+	if (m_worstAllocationFrame.m_allocations > 0) {
+		AllocationTracker::PrintFrame( m_worstAllocationFrame, "Frame with the most allocations" );
+	}
+	if (HasFailed()) {
+		printf( "FAILED: %u frames went over the allocation budget (", m_framesOverAllocationBudget );
+		if (m_allocationBudget.m_maxAllocations != UINT64_MAX) {
+			printf( " %llu allocations", m_allocationBudget.m_maxAllocations );
+		}
+		if (m_allocationBudget.m_maxBytes != UINT64_MAX) {
+			printf( " %llu bytes", m_allocationBudget.m_maxBytes );
+		}
+		printf( " per frame )\n" );
+	}
+}
+
+/// read the numbers of a flat JSON object, strings and nesting are skipped
+static bool ReadJsonNumbers( std::string const& path, std::vector<std::pair<std::string, double>>& out_values )
+{
+	FILE* file = nullptr;
+	fopen_s( &file, path.c_str(), "r" );
+	if (!file) {
+		return false;
+	}
+	std::string text;
+	char chunk[4096];
+	size_t readSize;
+	while ((readSize = fread( chunk, 1, sizeof( chunk ), file )) > 0) {
+		text.append( chunk, readSize );
+	}
+	fclose( file );
+
+	size_t pos = 0;
+	while ((pos = text.find( '"', pos )) != std::string::npos) {
+		size_t keyEnd = text.find( '"', pos + 1 );
+		if (keyEnd == std::string::npos) {
+			break;
+		}
+		std::string key = text.substr( pos + 1, keyEnd - pos - 1 );
+		size_t valueStart = text.find_first_not_of( " \t\r\n", keyEnd + 1 );
+		if (valueStart == std::string::npos || text[valueStart] != ':') {
+			pos = keyEnd + 1;
+			continue;
+		}
+		valueStart = text.find_first_not_of( " \t\r\n", valueStart + 1 );
+		if (valueStart == std::string::npos) {
+			break;
+		}
+		char* numberEnd = nullptr;
+		double value = strtod( text.c_str() + valueStart, &numberEnd );
+		if (numberEnd != text.c_str() + valueStart) {
+			out_values.emplace_back( key, value );
+			pos = numberEnd - text.c_str();
+		}
+		else if (text[valueStart] == '"') {
+			// a string value, skip it as a whole so it is not read as a key
+			size_t valueEnd = text.find( '"', valueStart + 1 );
+			if (valueEnd == std::string::npos) {
+				// truncated file, the rest is part of the unterminated string
+				break;
+			}
+			pos = valueEnd + 1;
+		}
+		else {
+			pos = valueStart + 1;
+		}
+	}
+	return true;
+}
+
+bool BenchmarkReport::CompareWithBaseline( std::string const& baselinePath ) const
+{
+	std::vector<std::pair<std::string, double>> baseline;
+	if (!ReadJsonNumbers( baselinePath, baseline )) {
+		printf( "Cannot read benchmark baseline %s\n", baselinePath.c_str() );
+		return false;
+	}
+
+	printf( "Compared with %s\n", baselinePath.c_str() );
+	printf( "  %-30s %14s %14s %9s\n", "", "baseline", "current", "change" );
+	uint32_t regressionCount = 0;
+	for (auto const& value : m_values) {
+		auto it = std::find_if( baseline.begin(), baseline.end(), [&value]( auto const& other ) { return other.first == value.first; } );
+		if (it == baseline.end()) {
+			printf( "  %-30s %14s %14.3f\n", value.first.c_str(), "-", value.second );
+			continue;
+		}
+		double change = it->second != 0.0 ? (value.second - it->second) / it->second : (value.second != 0.0 ? 1.0 : 0.0);
+		bool isTiming = value.first.ends_with( "Ms" );
+		bool isBytes = value.first.find( "Bytes" ) != std::string::npos;
+		char const* note = "";
+		if ((isTiming || isBytes) && m_hasRegressionThreshold && change > m_regressionThreshold) {
+			note = " REGRESSION";
+			++regressionCount;
+		}
+		else if (isTiming && change > BenchmarkTimingTolerance) {
+			note = " slower";
+		}
+		else if (isTiming && change < -BenchmarkTimingTolerance) {
+			note = " faster";
+		}
+		else if (!isTiming && value.second != it->second) {
+			note = " changed";
+		}
+		printf( "  %-30s %14.3f %14.3f %+8.1f%%%s\n", value.first.c_str(), it->second, value.second, change * 100.0, note );
+	}
+	if (regressionCount > 0) {
+		printf( "FAILED: %u timing or byte values grew by more than %.1f%% over the baseline\n", regressionCount, m_regressionThreshold * 100.0 );
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "Engine/Graphics/RendererInterface.h"
+#include "Engine/Core/AllocationTracker.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+/// Frame times and renderer statistics of one benchmark run, written as a flat JSON object
+/// Keys ending in Ms are timings, everything else is a count that should not change between runs of the same build
+/// AddFrame does not allocate, so the report does not show up in the allocation counts of the frames it measures
+class BenchmarkReport {
+public:
+	BenchmarkReport( std::string const& sceneName, uint32_t entityCount, std::string const& rendererName, uint32_t warmupFrames, uint64_t frames );
+
+	/// the run fails if a frame after the warmup goes over the budget
+	void SetAllocationBudget( AllocationBudget const& budget );
+	/// CompareWithBaseline fails if a timing or byte value grew by more than this fraction of the baseline
+	void SetRegressionThreshold( double threshold );
+	void AddFrame( double cpuFrameMilliseconds, RendererFrameStatistics const& statistics, AllocationFrameStatistics const& allocations );
+	/// compute the results, call once after the last frame
+	void Finish();
+	bool HasFailed() const;
+
+	bool WriteJson( std::string const& path ) const;
+	void Print() const;
+	/// print every value next to the one in a JSON file written by an older run
+	/// false if the baseline cannot be read or a value regressed past the regression threshold
+	bool CompareWithBaseline( std::string const& baselinePath ) const;
+
+protected:
+	void AddValue( char const* key, double value );
+
+	std::string m_sceneName;
+	std::string m_rendererName;
+	uint32_t m_entityCount = 0;
+	uint32_t m_warmupFrames = 0;
+	uint32_t m_frames = 0;
+	std::vector<double> m_cpuFrameMilliseconds;
+	RendererFrameStatistics m_statisticsSum;
+	RendererFrameStatistics m_statisticsPeak;
+	uint64_t m_allocationsSum = 0;
+	uint64_t m_allocatedBytesSum = 0;
+	bool m_hasAllocationBudget = false;
+	AllocationBudget m_allocationBudget;
+	uint32_t m_framesOverAllocationBudget = 0;
+	bool m_hasRegressionThreshold = false;
+	double m_regressionThreshold = 0.0;
+	/// the measured frame with the most allocations, printed with its tags
+	AllocationFrameStatistics m_worstAllocationFrame;
+	std::vector<std::pair<std::string, double>> m_values;
+};
@@ -0,0 +1,186 @@
+#include "Game/Benchmark/BenchmarkScene.h"
+#include "Engine/Graphics/GraphicsFwd.h"
+#include "Engine/Graphics/Font.h"
+#include "Engine/Core/Profiler.h"
+#include "Engine/Core/AllocationTracker.h"
+#include "Engine/Core/StringUtils.h"
+#include "Engine/Entity/EntitySystems.h"
+#include "Game/Cards/Card.h"
+#include <cmath>
+#include <cstring>
+#include <string>
+
+constexpr float BenchmarkEntitySpacing = 1.5f;
+constexpr float BenchmarkTextSpacing = 24.f;
+
+/// quad with a counter on it, the text is laid out again every frame
+class BenchmarkLabel : public Entity3D {
+public:
+	BenchmarkLabel( Vec3 const& position, uint32_t index )
+		:Entity3D( position ), m_index( index )
+	{
+		m_quadBounds = AABB2( Vec2( -10.f, -4.f ), Vec2( 10.f, 4.f ) );
+	}
+
+	virtual void BeginPlay() override
+	{
+		Entity3D::BeginPlay();
+		m_fontTextureBinding.m_texture = g_defaultFont->GetTexture();
+		m_textShader = g_theResourceManager->GetOrLoadShader( g_defaultFont->GetShaderName() );
+	}
+
+	virtual void Update( float deltaSeconds ) override
+	{
+		Entity3D::Update( deltaSeconds );
+		++m_updateCount;
+		// laid out here so it runs on the job workers, the vector keeps its capacity and stops allocating after the first frames
+		char textBuffer[32];
+		FixedStringBuilder text( textBuffer, sizeof( textBuffer ) );
+		text.Append( (int)m_index ).Append( ":" ).Append( (int)m_updateCount );
+		m_textVerts.clear();
+		g_defaultFont->AddVertsForTextInBox2D( m_textVerts, text.GetView(), AABB2( Vec2( -9.f, -3.f ), Vec2( 9.f, 3.f ) ), Rgba8( 0, 0, 0 ), 6.f, Vec2( 0.5f, 0.5f ), TextBoxMode::SHRINK_TO_FIT, 0.1f );
+	}
+
+	virtual void LateUpdate() override
+	{
+		Entity3D::LateUpdate();
+		// only the copy into this frame's transient vertices is left for the serial phase
+		TransientVertexAllocation allocation = g_theRenderer->AllocateTransientVertices( (uint32_t)m_textVerts.size() );
+		memcpy( allocation.m_vertices, m_textVerts.data(), m_textVerts.size() * sizeof( VertexPCU3D ) );
+		m_textVertexBufferBinding = allocation.m_binding;
+	}
+
+	virtual void Render() const override
+	{
+		Entity3D::Render();
+		g_theRenderer->BindShader( m_textShader );
+		g_theRenderer->BeginDrawCommands( GetRenderComponent().m_uniformBufferBinding, m_fontTextureBinding );
+		g_theRenderer->DrawQuads( m_textVertexBufferBinding );
+	}
+
+	uint32_t m_index = 0;
+	uint32_t m_updateCount = 0;
+	std::vector<VertexPCU3D> m_textVerts;
+	VertexBufferBinding m_textVertexBufferBinding;
+	TextureBinding m_fontTextureBinding;
+	Shader* m_textShader = nullptr;
+};
+
+BenchmarkScene::BenchmarkScene( BenchmarkSceneType type, uint32_t entityCount )
+	:m_type( type ), m_entityCount( entityCount )
+{
+}
+
+BenchmarkScene::~BenchmarkScene()
+{
+	for (auto entity : m_entities) {
+		delete entity;
+	}
+	delete m_camera;
+}
+
+void BenchmarkScene::Initialize()
+{
+	float spacing = BenchmarkEntitySpacing;
+	if (m_type == BenchmarkSceneType::CARDS) {
+		spacing = CardsSpacing;
+	}
+	else if (m_type == BenchmarkSceneType::TEXT) {
+		spacing = BenchmarkTextSpacing;
+	}
+
+	// square grid centered on the origin
+	uint32_t columns = (uint32_t)std::ceil( std::sqrt( (double)m_entityCount ) );
+	if (columns == 0) {
+		columns = 1;
+	}
+	float gridExtent = columns * spacing;
+	Vec3 gridOrigin = Vec3( -0.5f * gridExtent + 0.5f * spacing, -0.5f * gridExtent + 0.5f * spacing, 0.f );
+
+	if (m_type == BenchmarkSceneType::ENTITIES) {
+		// quads that turn at a fixed rate, rows of the scene's store driven by the entity systems only
+		EntityMesh const* mesh = m_entityStore.GetQuadMesh( AABB2( Vec2( -0.5f, -0.5f ), Vec2( 0.5f, 0.5f ) ) );
+		Shader* shader = g_theResourceManager->GetOrLoadShader( "shader" );
+		Texture* texture = g_theResourceManager->GetWhiteTexture();
+		for (uint32_t i = 0; i < m_entityCount; ++i) {
+			EntityId id = m_entityStore.CreateEntity( gridOrigin + Vec3( (i % columns) * spacing, (i / columns) * spacing, 0.f ) );
+			m_entityStore.AddRenderComponent( id, mesh, shader, texture );
+			m_entityStore.m_motions[m_entityStore.GetRow( id )].m_angularVelocity.yaw = 30.f + (float)(i % 7) * 15.f;
+		}
+	}
+	else {
+		m_entities.reserve( m_entityCount );
+		for (uint32_t i = 0; i < m_entityCount; ++i) {
+			Vec3 position = gridOrigin + Vec3( (i % columns) * spacing, (i / columns) * spacing, 0.f );
+			EntityBase* entity = nullptr;
+			if (m_type == BenchmarkSceneType::CARDS) {
+				entity = new Card( CardDefinition::GetDefinition( "Elf Warrior" ), position );
+			}
+			else {
+				entity = new BenchmarkLabel( position, i );
+			}
+			entity->BeginPlay();
+			m_entities.push_back( entity );
+		}
+	}
+
+	// back off until the whole grid fits into the 60 degrees field of view
+	float distance = 0.6f * gridExtent * CosDegrees( 30.f ) / SinDegrees( 30.f ) + 10.f;
+	m_camera = new PerspectiveCamera();
+	m_camera->BeginPlay();
+	m_camera->m_aspect = g_theRenderer->GetSwapChainExtentRatio();
+	m_camera->m_fov = 60.f;
+	m_camera->m_zNear = 0.1f;
+	m_camera->m_zFar = distance + 100.f;
+	m_camera->m_position = Vec3( 0.f, 0.f, distance );
+	m_camera->m_orientation = Euler( 90.f, 90.f, 0.f );
+}
+
+void BenchmarkScene::Update( float deltaSeconds )
+{
+	PROFILE_SCOPE( "BenchmarkScene::Update" );
+	ALLOCATION_TAG_SCOPE( "BenchmarkScene::Update" );
+	UpdateEntityMotion( m_entityStore, deltaSeconds );
+	UpdateEntityModelMatrices( m_entityStore );
+	UploadEntityModelMatrices( m_entityStore );
+	UpdateEntities( m_entities, deltaSeconds );
+}
+
+void BenchmarkScene::Render() const
+{
+	PROFILE_SCOPE( "BenchmarkScene::Render" );
+	ALLOCATION_TAG_SCOPE( "BenchmarkScene::Render" );
+	g_theRenderer->BeginCamera( m_camera );
+	RenderEntities( m_entityStore );
+	for (auto entity : m_entities) {
+		entity->Render();
+	}
+	g_theRenderer->EndCamera( m_camera );
+}
+
+bool BenchmarkScene::ParseSceneType( std::string const& name, BenchmarkSceneType& out_type )
+{
+	if (name == "entities") {
+		out_type = BenchmarkSceneType::ENTITIES;
+	}
+	else if (name == "cards") {
+		out_type = BenchmarkSceneType::CARDS;
+	}
+	else if (name == "text") {
+		out_type = BenchmarkSceneType::TEXT;
+	}
+	else {
+		return false;
+	}
+	return true;
+}
+
+char const* BenchmarkScene::GetSceneTypeName( BenchmarkSceneType type )
+{
+	switch (type) {
+	case BenchmarkSceneType::ENTITIES: return "entities";
+	case BenchmarkSceneType::CARDS: return "cards";
+	case BenchmarkSceneType::TEXT: return "text";
+	}
+	return "unknown";
+}
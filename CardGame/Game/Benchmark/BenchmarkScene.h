@@ -0,0 +1,31 @@
+#pragma once
+#include "Game/Frameworks/GameCommon.h"
+#include <string>
+#include <vector>
+
+enum class BenchmarkSceneType {
+	ENTITIES, CARDS, TEXT,
+};
+
+/// A fixed number of entities of one kind laid out on a grid, updated and rendered through the same paths as the game
+/// Nothing depends on wall clock time or randomness, so two runs with the same clock step submit the same work
+class BenchmarkScene {
+public:
+	BenchmarkScene( BenchmarkSceneType type, uint32_t entityCount );
+	~BenchmarkScene();
+	void Initialize();
+	void Update( float deltaSeconds );
+	void Render() const;
+
+	/// entities, cards or text
+	static bool ParseSceneType( std::string const& name, BenchmarkSceneType& out_type );
+	static char const* GetSceneTypeName( BenchmarkSceneType type );
+
+	BenchmarkSceneType m_type = BenchmarkSceneType::ENTITIES;
+	uint32_t m_entityCount = 0;
+	PerspectiveCamera* m_camera = nullptr;
+	/// rows of the entities scene, updated and drawn by the entity systems without an object per entity
+	EntityStore m_entityStore;
+	/// cards and labels, objects over rows of g_theEntityStore
+	std::vector<EntityBase*> m_entities;
+};
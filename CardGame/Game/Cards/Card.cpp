@@ -1,45 +1,36 @@
 #include "Game/Cards/Card.h"
 #include "Engine/Graphics/GraphicsFwd.h"
+#include "Engine/Core/AllocationTracker.h"
+#include "Engine/Core/StringUtils.h"
 
 
 Card::Card( CardDefinition const& def, Vec3 const& position /*= Vec3()*/, Euler const& orientation /*= Euler()*/ )
 	:Entity3D(position, orientation), m_def(def)
 {
+	m_quadBounds = AABB2( Vec2( -CardWidth * 0.5f, -CardHeight * 0.5f ), Vec2( CardWidth * 0.5f, CardHeight * 0.5f ) );
 }
 
 Card::~Card()
 {
 	g_theRenderer->ReturnMemoryToSharedBuffer( m_UIBinding );
-	g_theRenderer->ReturnMemoryToSharedBuffer( m_vertexBufferBinding, m_indexBufferBinding, m_uniformBufferBinding );
-	g_theRenderer->DeferredDestroyBuffer( m_textVertexBufferBinding.m_vertexBuffer, false );
+	if (m_UISwingNode.IsValid()) {
+		g_theSceneGraph->DestroyNode( m_UISwingNode );
+	}
 }
 
 void Card::BeginPlay()
 {
-	m_vertices = { {Vec3{-CardWidth * 0.5f, -CardHeight * 0.5f, 0.0f}, Rgba8{255, 255, 255, 255}, Vec2{0.0f, 0.0f}},
-				{Vec3{CardWidth * 0.5f, -CardHeight * 0.5f, 0.0f}, Rgba8{255, 255, 255, 255}, Vec2{1.0f, 0.0f}},
-				{Vec3{CardWidth * 0.5f, CardHeight * 0.5f, 0.0f}, Rgba8{255, 255, 255, 255}, Vec2{1.0f, 1.0f}},
-				{Vec3{-CardWidth * 0.5f, CardHeight * 0.5f, 0.0f}, Rgba8{255, 255, 255, 255}, Vec2{0.0f, 1.0f}}, };
-	m_indices = { 0, 1, 2, 2, 3, 0, };
-	m_useIndexBuffer = true;
-	// initialize rendering objects
-	m_vertexBufferBinding = g_theRenderer->AddVertsDataToSharedVertexBuffer( (void*)m_vertices.data(), sizeof( m_vertices[0] ) * m_vertices.size(), (uint32_t)m_vertices.size() );
-	if (m_useIndexBuffer) {
-		m_indexBufferBinding = g_theRenderer->AddIndicesDataToSharedIndexBuffer( (void*)m_indices.data(), sizeof( m_indices[0] ) * m_indices.size(), (uint32_t)m_indices.size() );
-	}
-	
-	m_textVertexBufferBinding.m_vertexBuffer = g_theRenderer->CreateDynamicVertexBuffer( PerFrameTextDataSize * MAX_FRAMES_IN_FLIGHT );
-	m_textVertexBufferBinding.m_vertexBufferVertexCount = PerFrameTextVertexCount;
-
-	//m_textureBinding.m_texture = g_theResourceManager->GetOrLoadTexture( "Data/Textures/texture.png" );
-	m_textureBinding.m_texture = g_theResourceManager->GetWhiteTexture();
+	// the card quad, its uniform buffer and shader are the entity's render component
+	Entity3D::BeginPlay();
 	m_fontTextureBinding.m_texture = g_defaultFont->GetTexture();
 
 	// initialize uniform buffers
-	m_uniformBufferBinding = g_theRenderer->AddDataToSharedUniformBuffer( UNIFORM_BUFFER_USE_MODEL_CONSTANTS_BINDING_2 );
 	m_UIBinding = g_theRenderer->AddDataToSharedUniformBuffer( UNIFORM_BUFFER_USE_MODEL_CONSTANTS_BINDING_2 );
+	// the card hangs off the swing by its left edge, so it turns about the hinge
+	m_UISwingNode = g_theSceneGraph->CreateNode( GetDetailPanelNode() );
+	m_UINode = g_theSceneGraph->CreateNode( m_UISwingNode, Mat44( Vec3( 1.f, 0.f, 0.f ), Vec3( 0.f, 1.f, 0.f ), Vec3( 0.f, 0.f, 1.f ), Vec3( -CardWidth * 0.5f, 0.f, 0.f ) ) );
 
-	m_shader = g_theResourceManager->GetOrLoadShader( "shader" );
+	m_textShader = g_theResourceManager->GetOrLoadShader( g_defaultFont->GetShaderName() );
 
 	m_curCoolDown = m_def.m_coolDown;
 	m_curHealth = m_def.m_health;
@@ -48,6 +39,7 @@ void Card::BeginPlay()
 
 void Card::Update( float deltaSeconds )
 {
+	ALLOCATION_TAG_SCOPE( "Card::Update" );
 	if (m_isHovering) {
 		m_hoveringTimer += deltaSeconds;
 	}
@@ -58,100 +50,99 @@ void Card::Update( float deltaSeconds )
 	// update position
 	if (m_inBattleLine) {
 		if (m_isFriendly) {
-			float curX = m_position.x;
+			float curX = GetPosition().x;
 			float targetX = BattleLineLeftX + m_targetPosInBattleLine * CardsSpacing;
 			float dist = abs( curX - targetX ) < 1.f ? 1.f : abs( curX - targetX );
-			m_position = Vec3( MoveTowards( curX, targetX, 10.f * deltaSeconds * dist ), -BattleLineY, CardsInBattleLineHeight );
+			SetPosition( Vec3( MoveTowards( curX, targetX, 10.f * deltaSeconds * dist ), -BattleLineY, CardsInBattleLineHeight ) );
 		}
 		else {
-			m_position = Vec3( BattleLineLeftX + m_targetPosInBattleLine * CardsSpacing, BattleLineY, CardsInBattleLineHeight );
+			SetPosition( Vec3( BattleLineLeftX + m_targetPosInBattleLine * CardsSpacing, BattleLineY, CardsInBattleLineHeight ) );
 		}
 	}
 
-	CalculateModelMatrix( m_modelMatrix );
+	// hovering scales the card up, so the model matrix is built again when it starts or stops
+	if (m_isHovering != m_isModelMatrixHovering) {
+		m_isModelMatrixHovering = m_isHovering;
+		MarkTransformChanged();
+	}
+	// a card at rest neither rebuilds nor uploads its model matrix, the upload is left to LateUpdate
+	GetRenderComponent().m_isVisible = !m_notShowCard;
+	UpdateModelMatrix();
 
-	// update the text(health, damage, cool down)
-	m_textVerts.clear();
+	// update the text(health, damage, cool down), it is only laid out again when a number changes
+	char coolDownText[16];
+	char damageText[16];
+	char healthText[16];
+	m_textMesh.BeginTexts();
 	if (!m_inBattleLine) {
-		g_defaultFont->AddVertsForTextInBox2D( m_textVerts, std::to_string( m_curCoolDown ), AABB2( Vec2( -32.f, 30.f ), Vec2( -15.f, 50.f ) ), Rgba8( 0, 0, 0 ), 20.f, Vec2( 0.f, 1.f ), TextBoxMode::SHRINK_TO_FIT, 1.f );
+		m_textMesh.AddTextInBox2D( g_defaultFont, FormatInteger( m_curCoolDown, coolDownText, sizeof( coolDownText ) ), AABB2( Vec2( -32.f, 30.f ), Vec2( -15.f, 50.f ) ), Rgba8( 0, 0, 0 ), 20.f, Vec2( 0.f, 1.f ), TextBoxMode::SHRINK_TO_FIT, 1.f );
 	}
 	if (m_curDamage < m_def.m_damage) {
-		g_defaultFont->AddVertsForTextInBox2D( m_textVerts, std::to_string( m_curDamage ), AABB2( Vec2( -32.f, -43.f ), Vec2(-15.f, -23.f) ), Rgba8( 255, 0, 0 ), 20.f, Vec2( 0.f, 0.5f ), TextBoxMode::SHRINK_TO_FIT, 1.f );
+		m_textMesh.AddTextInBox2D( g_defaultFont, FormatInteger( m_curDamage, damageText, sizeof( damageText ) ), AABB2( Vec2( -32.f, -43.f ), Vec2(-15.f, -23.f) ), Rgba8( 255, 0, 0 ), 20.f, Vec2( 0.f, 0.5f ), TextBoxMode::SHRINK_TO_FIT, 1.f );
 	}
 	else if (m_curDamage > m_def.m_damage) {
-		g_defaultFont->AddVertsForTextInBox2D( m_textVerts, std::to_string( m_curDamage ), AABB2( Vec2( -32.f, -43.f ), Vec2(-15.f, -23.f)), Rgba8( 0, 255, 0 ), 20.f, Vec2( 0.f, 0.5f ), TextBoxMode::SHRINK_TO_FIT, 1.f );
+		m_textMesh.AddTextInBox2D( g_defaultFont, FormatInteger( m_curDamage, damageText, sizeof( damageText ) ), AABB2( Vec2( -32.f, -43.f ), Vec2(-15.f, -23.f)), Rgba8( 0, 255, 0 ), 20.f, Vec2( 0.f, 0.5f ), TextBoxMode::SHRINK_TO_FIT, 1.f );
 	}
 	else {
-		g_defaultFont->AddVertsForTextInBox2D( m_textVerts, std::to_string( m_curDamage ), AABB2( Vec2( -32.f, -43.f ), Vec2( -15.f, -23.f ) ), Rgba8( 0, 0, 0 ), 20.f, Vec2( 0.f, 0.5f ), TextBoxMode::SHRINK_TO_FIT, 1.f );
+		m_textMesh.AddTextInBox2D( g_defaultFont, FormatInteger( m_curDamage, damageText, sizeof( damageText ) ), AABB2( Vec2( -32.f, -43.f ), Vec2( -15.f, -23.f ) ), Rgba8( 0, 0, 0 ), 20.f, Vec2( 0.f, 0.5f ), TextBoxMode::SHRINK_TO_FIT, 1.f );
 	}
 
 	if (m_curHealth < m_def.m_health) {
-		g_defaultFont->AddVertsForTextInBox2D( m_textVerts, std::to_string( m_curHealth ), AABB2(Vec2( 15.f, -43.f ), Vec2(32.f, -23.f)), Rgba8(255, 0, 0), 20.f, Vec2( 1.f, 0.5f ), TextBoxMode::SHRINK_TO_FIT, 1.f);
+		m_textMesh.AddTextInBox2D( g_defaultFont, FormatInteger( m_curHealth, healthText, sizeof( healthText ) ), AABB2(Vec2( 15.f, -43.f ), Vec2(32.f, -23.f)), Rgba8(255, 0, 0), 20.f, Vec2( 1.f, 0.5f ), TextBoxMode::SHRINK_TO_FIT, 1.f);
 	}
 	else if (m_curHealth > m_def.m_health) {
-		g_defaultFont->AddVertsForTextInBox2D( m_textVerts, std::to_string( m_curHealth ), AABB2(Vec2( 15.f, -43.f ), Vec2(32.f, -23.f)), Rgba8( 0, 255, 0 ), 20.f, Vec2( 1.f, 0.5f ), TextBoxMode::SHRINK_TO_FIT, 1.f );
+		m_textMesh.AddTextInBox2D( g_defaultFont, FormatInteger( m_curHealth, healthText, sizeof( healthText ) ), AABB2(Vec2( 15.f, -43.f ), Vec2(32.f, -23.f)), Rgba8( 0, 255, 0 ), 20.f, Vec2( 1.f, 0.5f ), TextBoxMode::SHRINK_TO_FIT, 1.f );
 	}
 	else {
-		g_defaultFont->AddVertsForTextInBox2D( m_textVerts, std::to_string( m_curHealth ), AABB2(Vec2( 15.f, -43.f ), Vec2(32.f, -23.f)), Rgba8( 0, 0, 0 ), 20.f, Vec2( 1.f, 0.5f ), TextBoxMode::SHRINK_TO_FIT, 1.f );
+		m_textMesh.AddTextInBox2D( g_defaultFont, FormatInteger( m_curHealth, healthText, sizeof( healthText ) ), AABB2(Vec2( 15.f, -43.f ), Vec2(32.f, -23.f)), Rgba8( 0, 0, 0 ), 20.f, Vec2( 1.f, 0.5f ), TextBoxMode::SHRINK_TO_FIT, 1.f );
 	}
 
-	g_defaultFont->AddVertsForTextInBox2D( m_textVerts, m_def.m_name, AABB2( Vec2( -20.f, 31.f ), Vec2( 20.f, 45.f ) ), Rgba8( 0, 0, 0 ), 12.f, Vec2( 0.5f, 0.5f ), TextBoxMode::SHRINK_TO_FIT, 1.f );
+	m_textMesh.AddTextInBox2D( g_defaultFont, m_def.m_name, AABB2( Vec2( -20.f, 31.f ), Vec2( 20.f, 45.f ) ), Rgba8( 0, 0, 0 ), 12.f, Vec2( 0.5f, 0.5f ), TextBoxMode::SHRINK_TO_FIT, 1.f );
+	m_textMesh.EndTexts();
 
-	m_textVertexBufferBinding.m_vertexBufferVertexCount = (uint32_t)m_textVerts.size();
-	uint32_t frameIndex = g_theRenderer->GetCurFrameNumber();
-	uint32_t offset = frameIndex * PerFrameTextDataSize;
-	//g_theRenderer->CopyDataToVertexBufferThroughStagingBuffer( m_textVerts.data(), m_textVertexBufferBinding.m_vertexBufferVertexCount * sizeof( VertexPCU3D ), m_textVertexBufferBinding.m_vertexBuffer, offset );
-	memcpy((char*)m_textVertexBufferBinding.m_vertexBuffer->m_mappedData + offset, m_textVerts.data(), m_textVertexBufferBinding.m_vertexBufferVertexCount * sizeof(VertexPCU3D));
-	m_textVertexBufferBinding.m_vertexBufferOffset = offset;
-	   
-	if (!m_notShowCard) {
-		// copy the ubo data to the graphics card
-		g_theRenderer->UpdateSharedModelUniformBuffer( m_uniformBufferBinding, (void*)&m_modelMatrix, sizeof( m_modelMatrix ) );
+	if (m_isHovering || m_showDetail) {
+		CalculateUIMatrix();
 	}
+}
 
+void Card::LateUpdate()
+{
+	Entity3D::LateUpdate();
+	m_textMesh.UploadTexts();
 	if (m_isHovering || m_showDetail) {
 		// copy the ubo data to the graphics card
-		g_theRenderer->UpdateSharedModelUniformBuffer( m_UIBinding, (void*)&m_UIMatrix, sizeof( m_UIMatrix ) );
+		g_theRenderer->UpdateSharedModelUniformBuffer( m_UIBinding, (void*)&g_theSceneGraph->GetWorldMatrix( m_UINode ), sizeof( Mat44 ) );
 	}
 }
 
 void Card::Render() const
 {
-	// if the current pipeline is not my shader's pipeline, bind my shader's pipeline
-	g_theRenderer->BindShader( m_shader );
+	EntityRenderComponent const& render = GetRenderComponent();
 	if (!m_notShowCard) {
 		// -------------------------------Draw Card-----------------------------------
-		// acquire and set the descriptor set for this specific entity
-		g_theRenderer->BeginDrawCommands( m_uniformBufferBinding, m_textureBinding );
-		if (m_useIndexBuffer) {
-			// draw the entity
-			g_theRenderer->DrawIndexed( m_vertexBufferBinding, m_indexBufferBinding );
-		}
-		else {
-			// draw the entity
-			g_theRenderer->Draw( m_vertexBufferBinding );
-		}
+		Entity3D::Render();
 
 		// ----------------------------------Draw texts--------------------------------
 		// acquire and set the descriptor set for this specific entity
-		g_theRenderer->BeginDrawCommands( m_uniformBufferBinding, m_fontTextureBinding );
-		g_theRenderer->Draw( m_textVertexBufferBinding );
+		if (!m_textMesh.IsEmpty()) {
+			g_theRenderer->BindShader( m_textShader );
+			g_theRenderer->BeginDrawCommands( render.m_uniformBufferBinding, m_fontTextureBinding );
+			g_theRenderer->DrawQuads( m_textMesh.GetVertexBufferBinding() );
+		}
 	}
 	
 	//-----------------------------------Hovering: show as UI----------------------
 	if (m_isHovering || m_showDetail) {
+		g_theRenderer->BindShader( render.m_shader );
 		// acquire and set the descriptor set for this specific entity
-		g_theRenderer->BeginDrawCommands( m_UIBinding, m_textureBinding );
-		if (m_useIndexBuffer) {
-			// draw the entity
-			g_theRenderer->DrawIndexed( m_vertexBufferBinding, m_indexBufferBinding );
+		g_theRenderer->BeginDrawCommands( m_UIBinding, render.m_textureBinding );
+		// draw the entity
+		g_theRenderer->DrawIndexed( render.m_mesh->m_vertexBufferBinding, render.m_mesh->m_indexBufferBinding );
+		if (!m_textMesh.IsEmpty()) {
+			g_theRenderer->BindShader( m_textShader );
+			g_theRenderer->BeginDrawCommands( m_UIBinding, m_fontTextureBinding );
+			g_theRenderer->DrawQuads( m_textMesh.GetVertexBufferBinding() );
 		}
-		else {
-			// draw the entity
-			g_theRenderer->Draw( m_vertexBufferBinding );
-		}
-		g_theRenderer->BeginDrawCommands( m_UIBinding, m_fontTextureBinding );
-		g_theRenderer->Draw( m_textVertexBufferBinding );
 	}
 }
 
@@ -166,27 +157,36 @@ uint32_t Card::GetDamage( int damage )
 
 void Card::CalculateModelMatrix( Mat44& modelMat )
 {
-	modelMat = Mat44( Vec3( 1.f, 0.f, 0.f ), Vec3( 0.f, 1.f, 0.f ), Vec3( 0.f, 0.f, 1.f ), m_position );
-	modelMat.Append( m_orientation.GetMatrix() );
+	Entity3D::CalculateModelMatrix( modelMat );
 	if (m_isHovering) {
 		modelMat.Append( Mat44( Vec3( 1.06f, 0.f, 0.f ), Vec3( 0.f, 1.06f, 0.f ), Vec3( 0.f, 0.f, 1.06f ), Vec3( 0.f, 0.f, 0.f ) ) );
 	}
+}
 
+void Card::CalculateUIMatrix()
+{
+	// the detail view rests where the hovering swing ends
+	float rollAngle = 0.f;
 	if (m_isHovering) {
 		constexpr float startAngle = -35.f;
 		constexpr float maxShowingTime = 0.35f;
 		float normalizedTime = SmoothStop2( RangeMapClamped( m_hoveringTimer, 0.f, maxShowingTime, 0.f, 1.f ) );
-		float rollAngle = RangeMap( normalizedTime, 0.f, 1.f, startAngle, 0.f );
-		Vec3 centerPos = Vec3( 160.f, 0.f, 200.f ) + Vec3( -CosDegrees( rollAngle ), 0.f, SinDegrees( rollAngle ) ) * CardWidth * 0.5f;
-		m_UIMatrix = Mat44( Vec3( 1.f, 0.f, 0.f ), Vec3( 0.f, 1.f, 0.f ), Vec3( 0.f, 0.f, 1.f ), centerPos );
-		m_UIMatrix.Append( Euler( 0.f, rollAngle, 0.f ).GetMatrix() );
+		rollAngle = RangeMap( normalizedTime, 0.f, 1.f, startAngle, 0.f );
 	}
-	else if(m_showDetail){
-		Vec3 centerPos = Vec3( 160.f - CardWidth * 0.5f, 0.f, 200.f );
-		m_UIMatrix = Mat44( Vec3( 1.f, 0.f, 0.f ), Vec3( 0.f, 1.f, 0.f ), Vec3( 0.f, 0.f, 1.f ), centerPos );
+	// the card node below the swing follows in the next UpdateWorldMatrices
+	g_theSceneGraph->SetLocalMatrix( m_UISwingNode, Euler( 0.f, rollAngle, 0.f ).GetMatrix() );
+}
+
+SceneNodeId Card::GetDetailPanelNode()
+{
+	if (!g_theSceneGraph->IsAlive( s_detailPanelNode )) {
+		s_detailPanelNode = g_theSceneGraph->CreateNode( SceneNodeId(), Mat44( Vec3( 1.f, 0.f, 0.f ), Vec3( 0.f, 1.f, 0.f ), Vec3( 0.f, 0.f, 1.f ), Vec3( 160.f, 0.f, 200.f ) ) );
 	}
+	return s_detailPanelNode;
 }
 
+SceneNodeId Card::s_detailPanelNode;
+
 CardDefinition::CardDefinition()
 {
 
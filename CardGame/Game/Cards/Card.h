@@ -1,7 +1,9 @@
 #pragma once
 #include "Engine/Entity/Entity.h"
+#include "Engine/Entity/SceneGraph.h"
 #include "Game/Frameworks/GameCommon.h"
 #include "Engine/Core/XmlUtils.h"
+#include "Engine/Graphics/TextMesh.h"
 
 enum class CardRarity {
 	Beginning, Common, Rare, Legendary,
@@ -37,6 +39,8 @@ public:
 	virtual void BeginPlay() override;
 	/// Update will be called each frame
 	virtual void Update( float deltaSeconds ) override;
+	/// LateUpdate will be called each frame after every entity's Update
+	virtual void LateUpdate() override;
 	/// Render will be called each frame
 	virtual void Render() const override;
 
@@ -44,6 +48,10 @@ public:
 
 protected:
 	virtual void CalculateModelMatrix( Mat44& modelMat );
+	/// swing of the hovering or detail view around the detail panel's hinge, it follows the hovering timer
+	void CalculateUIMatrix();
+	/// root of every card's hovering and detail view, the hinge they swing in around
+	static SceneNodeId GetDetailPanelNode();
 public:
 
 	CardDefinition const& m_def;
@@ -54,13 +62,22 @@ public:
 	float m_hoveringTimer = 0.f;
 	bool m_inBattleLine = false;
 	bool m_isHovering = false;
+	/// hovering state the model matrix was built with
+	bool m_isModelMatrixHovering = false;
 	bool m_showDetail = false;
 	bool m_notShowCard = false;
 	bool m_isFriendly = false;
 	AABB2 m_cardBounds2D;
-	std::vector<VertexPCU3D> m_textVerts;
-	VertexBufferBinding m_textVertexBufferBinding;
+	TextMesh m_textMesh;
 	TextureBinding m_fontTextureBinding;
+	/// the font's shader, the same as the entity's shader unless the font has an SDF atlas
+	Shader* m_textShader = nullptr;
 	UniformBufferBinding m_UIBinding;
-	Mat44 m_UIMatrix;
+	/// child of the detail panel node turning about the hinge
+	SceneNodeId m_UISwingNode;
+	/// child of the swing, the card with its texts as shown in the hovering or detail view
+	SceneNodeId m_UINode;
+
+protected:
+	static SceneNodeId s_detailPanelNode;
 };
\ No newline at end of file
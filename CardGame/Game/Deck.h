@@ -1,16 +1,19 @@
 #pragma once
 #include "Engine/Entity/Entity.h"
+#include "Engine/Graphics/TextMesh.h"
+#include "Game/Frameworks/GameCommon.h"
 class Battle;
 
 class Deck : public Entity3D {
 public:
 	Deck( Vec3 const& position, Euler const& orientation = Euler() );
-	~Deck();
 
 	/// Begin play will be called right after an entity is created
 	virtual void BeginPlay() override;
 	/// Update will be called each frame
 	virtual void Update( float deltaSeconds ) override;
+	/// LateUpdate will be called each frame after every entity's Update
+	virtual void LateUpdate() override;
 	/// Render will be called each frame
 	virtual void Render() const override;
 
@@ -19,7 +22,8 @@ public:
 	AABB2 m_cardBounds2D;
 	Battle* m_battle = nullptr;
 protected:
-	std::vector<VertexPCU3D> m_textVerts;
-	VertexBufferBinding m_textVertexBufferBinding;
+	TextMesh m_textMesh;
 	TextureBinding m_fontTextureBinding;
+	/// the font's shader, the same as the entity's shader unless the font has an SDF atlas
+	Shader* m_textShader = nullptr;
 };
\ No newline at end of file
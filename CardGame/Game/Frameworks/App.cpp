@@ -1,31 +1,223 @@
 #include "Game/Frameworks/App.h"
 
 #include "Engine/Graphics/Renderer.h"
+#include "Engine/Graphics/NullRenderer.h"
+#include "Engine/Graphics/CaptureRenderer.h"
+#include "Engine/Graphics/RendererStatisticsOverlay.h"
 #include "Engine/Window/Window.h"
 #include "Engine/Input/InputSystem.h"
+#include "Engine/Core/TaskGraph.h"
+#include "Engine/Core/JobSystem.h"
+#include "Engine/Entity/SceneGraph.h"
+#include "Engine/Core/Profiler.h"
+#include "Engine/Core/AllocationTracker.h"
+#include "Engine/Core/Clock.h"
+#include "Engine/Core/HitchDetector.h"
 
 #include "Game/Frameworks/Game.h"
 #include "Game/Frameworks/GameCommon.h"
+#include "Game/Benchmark/BenchmarkScene.h"
+#include "Game/Benchmark/BenchmarkReport.h"
 
 #include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
 #include <thread>
 
+constexpr char const* DefaultFontPath = "Data/Fonts/arial.ttf";
+constexpr char const* DefaultShaderName = "shader";
+constexpr uint64_t BenchmarkDefaultFrames = 300;
+constexpr uint32_t BenchmarkWarmupFrames = 10;
+constexpr double BenchmarkFixedDeltaSeconds = 1.0 / 60.0;
+
+void App::ParseCommandLine( int argc, char* argv[] )
+{
+	for (int i = 1; i < argc; ++i) {
+		std::string_view arg = argv[i];
+		if (arg == "-headless") {
+			m_isHeadless = true;
+		}
+		else if (arg == "-nullrenderer") {
+			m_useNullRenderer = true;
+			m_isHeadless = true;
+		}
+		else if (arg.starts_with( "-frames=" )) {
+			m_maxFrames = std::strtoull( argv[i] + strlen( "-frames=" ), nullptr, 10 );
+		}
+		else if (arg.starts_with( "-screenshot=" )) {
+			m_screenshotPath = argv[i] + strlen( "-screenshot=" );
+		}
+		else if (arg == "-pipelinestats") {
+			m_usePipelineStatistics = true;
+		}
+		else if (arg == "-stats") {
+			m_showRendererStatistics = true;
+		}
+		else if (arg == "-sdffont") {
+			m_fontAtlasMode = FontAtlasMode::SDF;
+		}
+		else if (arg.starts_with( "-profile=" )) {
+			m_profilePath = argv[i] + strlen( "-profile=" );
+		}
+		else if (arg.starts_with( "-benchmark=" )) {
+			m_benchmarkSceneName = argv[i] + strlen( "-benchmark=" );
+		}
+		else if (arg.starts_with( "-count=" )) {
+			m_benchmarkEntityCount = (uint32_t)std::strtoul( argv[i] + strlen( "-count=" ), nullptr, 10 );
+		}
+		else if (arg.starts_with( "-benchmarkout=" )) {
+			m_benchmarkOutputPath = argv[i] + strlen( "-benchmarkout=" );
+		}
+		else if (arg.starts_with( "-benchmarkbaseline=" )) {
+			m_benchmarkBaselinePath = argv[i] + strlen( "-benchmarkbaseline=" );
+		}
+		else if (arg.starts_with( "-benchmarkregression=" )) {
+			m_benchmarkRegressionPercent = std::strtod( argv[i] + strlen( "-benchmarkregression=" ), nullptr );
+			m_hasBenchmarkRegressionThreshold = true;
+		}
+		else if (arg.starts_with( "-allocbudget=" )) {
+			m_allocationBudget.m_maxAllocations = std::strtoull( argv[i] + strlen( "-allocbudget=" ), nullptr, 10 );
+			m_hasAllocationBudget = true;
+		}
+		else if (arg.starts_with( "-allocbytesbudget=" )) {
+			m_allocationBudget.m_maxBytes = std::strtoull( argv[i] + strlen( "-allocbytesbudget=" ), nullptr, 10 );
+			m_hasAllocationBudget = true;
+		}
+		else if (arg.starts_with( "-hitchms=" )) {
+			Clock::GetSystemHitchDetector().SetThresholdSeconds( std::strtod( argv[i] + strlen( "-hitchms=" ), nullptr ) * 0.001 );
+		}
+		else if (arg.starts_with( "-capture=" )) {
+			m_capturePath = argv[i] + strlen( "-capture=" );
+		}
+		else if (arg.starts_with( "-capturestart=" )) {
+			m_captureFirstFrame = std::strtoull( argv[i] + strlen( "-capturestart=" ), nullptr, 10 );
+		}
+		else if (arg.starts_with( "-captureframes=" )) {
+			m_captureFrameCount = std::strtoull( argv[i] + strlen( "-captureframes=" ), nullptr, 10 );
+		}
+		else if (arg.starts_with( "-jobworkers=" )) {
+			m_jobWorkerCount = (int)std::strtol( argv[i] + strlen( "-jobworkers=" ), nullptr, 10 );
+		}
+	}
+
+	if (!m_benchmarkSceneName.empty() && m_maxFrames == 0) {
+		m_maxFrames = BenchmarkDefaultFrames;
+	}
+}
+
+/// write RGBA8 pixels as a binary PPM, alpha is dropped
+static void SaveFrameAsPPM( std::string const& path, std::vector<unsigned char> const& pixels, uint32_t width, uint32_t height )
+{
+	FILE* file = nullptr;
+	fopen_s( &file, path.c_str(), "wb" );
+	if (!file) {
+		printf( "Cannot write screenshot %s\n", path.c_str() );
+		return;
+	}
+	fprintf( file, "P6\n%u %u\n255\n", width, height );
+	std::vector<unsigned char> row( (size_t)width * 3 );
+	for (uint32_t y = 0; y < height; ++y) {
+		for (uint32_t x = 0; x < width; ++x) {
+			size_t src = ((size_t)y * width + x) * 4;
+			row[x * 3 + 0] = pixels[src + 0];
+			row[x * 3 + 1] = pixels[src + 1];
+			row[x * 3 + 2] = pixels[src + 2];
+		}
+		fwrite( row.data(), 1, row.size(), file );
+	}
+	fclose( file );
+}
+
 void App::Initialize()
 {
-	g_mainWindow = new Window();
-	g_mainWindow->InitWindow();
+	Profiler::SetThreadName( "Main" );
 	g_theResourceManager = new ResourceManager();
+	g_theEntityStore = new EntityStore();
+	g_theSceneGraph = new SceneGraph();
+	g_theJobSystem = new JobSystem( m_jobWorkerCount );
 
-	g_theInput = new InputSystem();
-	g_theInput->Initialize();
+	// window, device and game setup stay on the main thread, file loading, parsing
+	// and font packing run on workers while the device is being created
+	TaskGraph startup;
+	std::vector<TaskHandle> windowDependency;
+	if (!m_isHeadless) {
+		windowDependency.push_back( startup.AddTask( "Window", []() {
+			g_mainWindow = new Window();
+			g_mainWindow->InitWindow();
+			}, {}, TaskThread::MAIN ) );
+	}
+	TaskHandle input = startup.AddTask( "Input", []() {
+		g_theInput = new InputSystem();
+		g_theInput->Initialize();
+		}, windowDependency, TaskThread::MAIN );
+	TaskHandle renderer = startup.AddTask( "Renderer", [this]() {
+		RendererConfig config;
+		config.m_headless = m_isHeadless;
+		config.m_readbackFrames = m_isHeadless && !m_screenshotPath.empty();
+		config.m_gpuPipelineStatistics = m_usePipelineStatistics;
+		if (m_useNullRenderer) {
+			g_theRenderer = new NullRenderer();
+		}
+		else {
+			g_theRenderer = new Renderer();
+		}
+		if (!m_capturePath.empty()) {
+			g_theRenderer = new CaptureRenderer( g_theRenderer, m_capturePath, m_captureFirstFrame, m_captureFrameCount );
+		}
+		g_theRenderer->Initialize( config );
+		}, windowDependency, TaskThread::MAIN );
 
-	g_theRenderer = new Renderer();
-	g_theRenderer->Initialize();
+	TaskHandle definitions = startup.AddTask( "Card definitions", []() {
+		Game::LoadDefinitions();
+		} );
+	TaskHandle fontPacking = startup.AddTask( "Font packing", [this]() {
+		g_theResourceManager->PrepareFont( DefaultFontPath, m_fontAtlasMode );
+		} );
+	TaskHandle shaderLoading = startup.AddTask( "Shader loading", [this]() {
+		g_theResourceManager->PrepareShader( DefaultShaderName );
+		if (m_fontAtlasMode == FontAtlasMode::SDF) {
+			g_theResourceManager->PrepareShader( FONT_SDF_SHADER_NAME );
+		}
+		} );
+
+	// pipeline creation needs the device but not the queue, so it can still overlap with the font upload
+	TaskHandle pipelines = startup.AddTask( "Pipelines", [this]() {
+		g_theResourceManager->GetOrLoadShader( DefaultShaderName );
+		if (m_fontAtlasMode == FontAtlasMode::SDF) {
+			g_theResourceManager->GetOrLoadShader( FONT_SDF_SHADER_NAME );
+		}
+		}, { renderer, shaderLoading } );
+	TaskHandle fontUpload = startup.AddTask( "Font upload", [this]() {
+		g_defaultFont = g_theResourceManager->GetOrLoadFont( DefaultFontPath, m_fontAtlasMode );
+		}, { renderer, fontPacking }, TaskThread::MAIN );
 
-	g_defaultFont = g_theResourceManager->GetOrLoadFont( "Data/Fonts/arial.ttf" );
+	startup.AddTask( "Game", [this]() {
+		if (m_benchmarkSceneName.empty()) {
+			g_theGame = new Game();
+			g_theGame->Initialize();
+			g_theGame->m_statisticsOverlay->SetVisible( m_showRendererStatistics );
+			return;
+		}
+		BenchmarkSceneType type = BenchmarkSceneType::ENTITIES;
+		ASSERT_OR_ERROR( BenchmarkScene::ParseSceneType( m_benchmarkSceneName, type ), "unknown benchmark scene " + m_benchmarkSceneName );
+		m_benchmarkScene = new BenchmarkScene( type, m_benchmarkEntityCount );
+		m_benchmarkScene->Initialize();
+		char const* rendererName = m_useNullRenderer ? "null" : (m_isHeadless ? "vulkan-headless" : "vulkan");
+		m_benchmarkReport = new BenchmarkReport( BenchmarkScene::GetSceneTypeName( type ), m_benchmarkEntityCount, rendererName, BenchmarkWarmupFrames, m_maxFrames );
+		if (m_hasAllocationBudget) {
+			m_benchmarkReport->SetAllocationBudget( m_allocationBudget );
+		}
+		if (m_hasBenchmarkRegressionThreshold) {
+			m_benchmarkReport->SetRegressionThreshold( m_benchmarkRegressionPercent * 0.01 );
+		}
+		// every run advances the scene by the same steps, whatever the frame times are
+		Clock::SetSystemFixedDeltaSeconds( BenchmarkFixedDeltaSeconds );
+		}, { input, definitions, pipelines, fontUpload }, TaskThread::MAIN );
 
-	g_theGame = new Game();
-	g_theGame->Initialize();
+	// on the job system's threads, a second pool of startup threads would compete with its workers
+	startup.Execute( *g_theJobSystem );
+	startup.PrintTimeline( "Engine startup" );
 
 	//g_mainWindow->SetCursorInputMode( CursorInputMode::OFFSET );
 }
@@ -39,9 +231,19 @@ void App::Run()
 		BeginFrame();
 		RunFrame();
 		EndFrame();
+		++m_frameCount;
 
-		// fit the max frame rate
 		auto currentTime = std::chrono::high_resolution_clock::now();
+		if (m_benchmarkReport) {
+			m_benchmarkReport->AddFrame( std::chrono::duration<double, std::milli>( currentTime - startTime ).count(), g_theRenderer->GetLastFrameStatistics(), AllocationTracker::GetLastFrame() );
+		}
+
+		// headless runs and benchmarks are paced by the GPU only
+		if (m_isHeadless || m_benchmarkScene) {
+			continue;
+		}
+
+		// fit the max frame rate
 		float frameTime = std::chrono::duration<float, std::chrono::milliseconds::period>( currentTime - startTime ).count();
 		while (frameTime < TARGET_FRAME_TIME_MILLISECONDS) {
 			std::this_thread::yield();
@@ -56,27 +258,76 @@ void App::Run()
 void App::Exit()
 {
 	g_theRenderer->WaitForCleanup();
+	if (!m_screenshotPath.empty()) {
+		std::vector<unsigned char> pixels;
+		uint32_t width, height;
+		if (g_theRenderer->ReadLastFrame( pixels, width, height )) {
+			SaveFrameAsPPM( m_screenshotPath, pixels, width, height );
+		}
+	}
+	if (m_benchmarkReport) {
+		m_benchmarkReport->Finish();
+		m_benchmarkReport->Print();
+		if (!m_benchmarkOutputPath.empty() && !m_benchmarkReport->WriteJson( m_benchmarkOutputPath )) {
+			printf( "Cannot write benchmark results %s\n", m_benchmarkOutputPath.c_str() );
+		}
+		if (!m_benchmarkBaselinePath.empty() && !m_benchmarkReport->CompareWithBaseline( m_benchmarkBaselinePath )) {
+			m_exitCode = 1;
+		}
+		if (m_benchmarkReport->HasFailed()) {
+			m_exitCode = 1;
+		}
+		delete m_benchmarkReport;
+	}
+	delete m_benchmarkScene;
 	delete g_theGame;
+	// returns the entity meshes to the renderer's shared buffers
+	delete g_theEntityStore;
+	delete g_theSceneGraph;
+	delete g_theJobSystem;
 	delete g_theResourceManager;
 	g_theRenderer->Cleanup();
 	delete g_theRenderer;
 	delete g_theInput;
 	delete g_mainWindow;
 
+	Clock::GetSystemHitchDetector().PrintSummary();
+#ifdef NO_PROFILER
+	if (!m_profilePath.empty()) {
+		printf( "No profile written to %s, the profiler is compiled out in this configuration\n", m_profilePath.c_str() );
+	}
+#else
+	if (!m_profilePath.empty() && !Profiler::WriteChromeTrace( m_profilePath )) {
+		printf( "Cannot write profile %s\n", m_profilePath.c_str() );
+	}
+#endif
+
 }
 
 void App::BeginFrame()
 {
+	PROFILE_FRAME_MARK();
 	Clock::TickSystemClock();
-	g_mainWindow->BeginFrame();
+	if (g_mainWindow) {
+		g_mainWindow->BeginFrame();
+	}
 	g_theInput->BeginFrame();
+	g_theJobSystem->RunMainThreadJobs();
+	// glyph uploads are recorded by the renderer's BeginFrame, ahead of the text drawn this frame
+	g_theResourceManager->UpdateFonts();
 	g_theRenderer->BeginFrame();
 }
 
 void App::RunFrame()
 {
-	g_theGame->Update( (float)Clock::GetSystemClock()->GetDeltaSeconds() );
-	g_theGame->Render();
+	if (m_benchmarkScene) {
+		m_benchmarkScene->Update( (float)Clock::GetSystemClock()->GetDeltaSeconds() );
+		m_benchmarkScene->Render();
+	}
+	else {
+		g_theGame->Update( (float)Clock::GetSystemClock()->GetDeltaSeconds() );
+		g_theGame->Render();
+	}
 
 	if (g_theInput->WasKeyJustReleased( ENGINE_KEY_ESCAPE )) {
 		m_shouldQuit = true;
@@ -87,11 +338,20 @@ void App::EndFrame()
 {
 	g_theInput->EndFrame();
 	g_theRenderer->EndFrame();
+	ALLOCATION_FRAME_END();
+}
+
+int App::GetExitCode() const
+{
+	return m_exitCode;
 }
 
 bool App::AppShouldQuit() const
 {
-	return g_mainWindow->IsQuitting() || m_shouldQuit;
+	if (m_maxFrames != 0 && m_frameCount >= m_maxFrames) {
+		return true;
+	}
+	return (g_mainWindow && g_mainWindow->IsQuitting()) || m_shouldQuit;
 }
 
 void App::SetMaxFrameRate( int maxFrameRate )
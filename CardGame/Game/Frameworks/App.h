@@ -1,8 +1,25 @@
 #pragma once
 #include "Engine/Core/EngineFwdMinor.h"
+#include "Engine/Core/AllocationTracker.h"
+
+class BenchmarkScene;
+class BenchmarkReport;
 
 class App {
 public:
+	/// -headless: render offscreen without a window, -frames=N: quit after N frames, -screenshot=path.ppm: save the last frame (headless only)
+	/// -nullrenderer: no window and no GPU, renderer calls are only counted
+	/// -profile=path.json: write the CPU profiler zones as a Chrome trace on exit, not in Release which defines NO_PROFILER, -pipelinestats: query GPU pipeline statistics
+	/// -benchmark=entities|cards|text: run a benchmark scene with -count=N entities instead of the game, with a fixed clock step,
+	/// -benchmarkout=path.json: write the results, -benchmarkbaseline=path.json: compare the results with an older run
+	/// -benchmarkregression=PCT: fail the comparison (exit code 1) if a timing or byte value grew by more than PCT percent, a missing baseline fails too
+	/// -allocbudget=N, -allocbytesbudget=N: fail the benchmark (exit code 1) if a frame after the warmup allocates more
+	/// -stats: show the renderer statistics overlay from the start (F3 toggles it)
+	/// -hitchms=N: log frames longer than N ms with their longest profiler zones, the frame time summary is printed on exit
+	/// -capture=path.bin: record the renderer calls of -captureframes=N frames (default 60) from frame -capturestart=N on, see RendererReplay
+	/// -jobworkers=N: worker threads of the job system, 0 runs every job on the main thread, by default one less than the hardware threads
+	/// -sdffont: signed distance field atlas for the default font, drawn with the text_sdf shaders, Data/Shaders/compile.bat rebuilds them
+	void ParseCommandLine( int argc, char* argv[] );
 	void Initialize();
 	void Run();
 	void Exit();
@@ -12,9 +29,34 @@ public:
 	void EndFrame();
 
 	bool AppShouldQuit() const;
+	int GetExitCode() const;
 
 	void SetMaxFrameRate( int maxFrameRate );
 protected:
 	bool m_shouldQuit = false;
+	bool m_isHeadless = false;
+	bool m_useNullRenderer = false;
+	bool m_usePipelineStatistics = false;
+	bool m_showRendererStatistics = false;
+	FontAtlasMode m_fontAtlasMode = FontAtlasMode::BITMAP;
+	uint64_t m_maxFrames = 0;
+	uint64_t m_frameCount = 0;
+	std::string m_screenshotPath;
+	std::string m_profilePath;
+	std::string m_benchmarkSceneName;
+	uint32_t m_benchmarkEntityCount = 1000;
+	std::string m_benchmarkOutputPath;
+	std::string m_benchmarkBaselinePath;
+	bool m_hasBenchmarkRegressionThreshold = false;
+	double m_benchmarkRegressionPercent = 0.0;
+	BenchmarkScene* m_benchmarkScene = nullptr;
+	BenchmarkReport* m_benchmarkReport = nullptr;
+	bool m_hasAllocationBudget = false;
+	AllocationBudget m_allocationBudget;
+	std::string m_capturePath;
+	uint64_t m_captureFirstFrame = 0;
+	uint64_t m_captureFrameCount = 60;
+	int m_jobWorkerCount = -1;
+	int m_exitCode = 0;
 public:
 };
\ No newline at end of file
@@ -2,6 +2,9 @@
 #include "Game/Frameworks/GameCommon.h"
 #include "Engine/Graphics/Renderer.h"
 #include "Engine/Window/Window.h"
+#include "Engine/Core/Profiler.h"
+#include "Engine/Core/AllocationTracker.h"
+#include "Engine/Graphics/RendererStatisticsOverlay.h"
 #include "Game/Cards/Card.h"
 #include "Game/Battle.h"
 #include "Game/EnemyInfo.h"
@@ -17,11 +20,16 @@ Game::~Game()
 	}
 	delete m_gameDefault3DCamera;
 	delete m_gameDefault2DCamera;
+	delete m_statisticsOverlay;
 }
 
-void Game::Initialize()
+void Game::LoadDefinitions()
 {
 	CardDefinition::SetUpCardDefinitions();
+}
+
+void Game::Initialize()
+{
 	m_gameDefault3DCamera = new PerspectiveCamera();
 	m_gameDefault3DCamera->BeginPlay();
 	m_gameDefault3DCamera->m_aspect = g_theRenderer->GetSwapChainExtentRatio();
@@ -37,6 +45,8 @@ void Game::Initialize()
 	m_gameDefault2DCamera->m_far = -1.f;
 	m_gameDefault2DCamera->m_bounds = AABB2( Vec2( 0.f, 0.f ), Vec2( 1600.f, 800.f ) );
 
+	m_statisticsOverlay = new RendererStatisticsOverlay( g_defaultFont, m_gameDefault2DCamera->m_bounds );
+
 
 	EnemyInfo info;
 	m_currentBattle = new Battle( info );
@@ -44,6 +54,8 @@ void Game::Initialize()
 
 void Game::Update( float deltaSeconds )
 {
+	PROFILE_SCOPE( "Game::Update" );
+	ALLOCATION_TAG_SCOPE( "Game::Update" );
 	// test code
 // 	Vec3 fwdVec, leftVec, UpVec;
 // 	m_gameDefault3DCamera->m_orientation.GetForwardAndLeftAndUpVector( fwdVec, leftVec, UpVec );
@@ -66,20 +78,31 @@ void Game::Update( float deltaSeconds )
 // 
 // 	m_gameDefault3DCamera->m_orientation.pitch = GetClamped( m_gameDefault3DCamera->m_orientation.pitch, -85.f, 85.f );
 
+	// input and the card slots first, the cards read them in their update
+	m_entitiesToUpdate.clear();
 	if (m_gameState == GameState::InBattle) {
 		m_currentBattle->Update( deltaSeconds );
-		if (m_currentBattle->m_readyToPerformNextStep) {
-			m_currentBattle->PerformNextStep();
-		}
+		m_currentBattle->GetEntitiesToUpdate( m_entitiesToUpdate );
 	}
+	m_entitiesToUpdate.insert( m_entitiesToUpdate.end(), entities.begin(), entities.end() );
+	// every entity only changes itself, the uploads run afterwards in this order
+	UpdateEntities( m_entitiesToUpdate, deltaSeconds );
 
-	for (auto entity : entities) {
-		entity->Update(deltaSeconds);
+	// battle steps add, move and delete cards, so they wait until no card is updating
+	if (m_gameState == GameState::InBattle && m_currentBattle->m_readyToPerformNextStep) {
+		m_currentBattle->PerformNextStep();
 	}
+
+	if (g_theInput->WasKeyJustReleased( ENGINE_KEY_F3 )) {
+		m_statisticsOverlay->ToggleVisible();
+	}
+	m_statisticsOverlay->Update( deltaSeconds );
 }
 
 void Game::Render() const
 {
+	PROFILE_SCOPE( "Game::Render" );
+	ALLOCATION_TAG_SCOPE( "Game::Render" );
 	g_theRenderer->BeginCamera( m_gameDefault3DCamera );
 	for (auto entity : entities) {
 		entity->Render();
@@ -89,6 +112,6 @@ void Game::Render() const
 	}
 	g_theRenderer->EndCamera( m_gameDefault3DCamera );
 	g_theRenderer->BeginCamera( m_gameDefault2DCamera );
-
+	m_statisticsOverlay->Render();
 	g_theRenderer->EndCamera( m_gameDefault2DCamera );
 }
@@ -3,6 +3,8 @@
 
 class Card;
 class Battle;
+class EntityBase;
+class RendererStatisticsOverlay;
 
 enum class GameState {
 	InBattle,
@@ -11,14 +13,20 @@ enum class GameState {
 class Game {
 public:
 	~Game();
+	/// CPU only, thread safe. Called by the app during startup
+	static void LoadDefinitions();
 	void Initialize();
 	void Update( float deltaSeconds );
 	void Render() const;
 
 	PerspectiveCamera* m_gameDefault3DCamera = nullptr;
 	OrthographicCamera* m_gameDefault2DCamera = nullptr;
+	/// toggled with F3
+	RendererStatisticsOverlay* m_statisticsOverlay = nullptr;
 
 	GameState m_gameState = GameState::InBattle;
 	std::vector<Card*> m_myDeck;
 	Battle* m_currentBattle;
+	/// every entity updated this frame, kept so gathering them does not allocate
+	std::vector<EntityBase*> m_entitiesToUpdate;
 };
\ No newline at end of file
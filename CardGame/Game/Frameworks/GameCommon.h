@@ -19,6 +19,4 @@ constexpr float BattleLineLeftX = -290.f;
 constexpr float HandsLineY = 140.f;
 constexpr float HandsLineLeftX = -250.f;
 constexpr float DeckCenterX = -350.f;
-constexpr float DeckCenterY = 150.f;
-constexpr uint32_t PerFrameTextVertexCount = 600;
-constexpr uint32_t PerFrameTextDataSize = PerFrameTextVertexCount * sizeof( VertexPCU3D );
\ No newline at end of file
+constexpr float DeckCenterY = 150.f;
\ No newline at end of file
@@ -10,9 +10,10 @@
 int main( int argc, char* argv[] )
 {
 	g_theApp = new App;
+	g_theApp->ParseCommandLine( argc, argv );
 	g_theApp->Initialize();
 	g_theApp->Run();
 	g_theApp->Exit();
 
-	return 0;
+	return g_theApp->GetExitCode();
 }
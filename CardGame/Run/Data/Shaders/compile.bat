@@ -1,3 +1,9 @@
 C:/VulkanSDK/1.4.309.0/Bin/glslc.exe shader.vert -o shader_vert.spv
 C:/VulkanSDK/1.4.309.0/Bin/glslc.exe shader.frag -o shader_frag.spv
-pause
\ No newline at end of file
+C:/VulkanSDK/1.4.309.0/Bin/glslc.exe shader.vert -o text_sdf_vert.spv
+C:/VulkanSDK/1.4.309.0/Bin/glslc.exe text_sdf.frag -o text_sdf_frag.spv
+C:/VulkanSDK/1.4.309.0/Bin/glslc.exe shader_2d.vert -o shader_2d_vert.spv
+C:/VulkanSDK/1.4.309.0/Bin/glslc.exe shader.frag -o shader_2d_frag.spv
+C:/VulkanSDK/1.4.309.0/Bin/glslc.exe shader_2d.vert -o text_sdf_2d_vert.spv
+C:/VulkanSDK/1.4.309.0/Bin/glslc.exe text_sdf.frag -o text_sdf_2d_frag.spv
+pause
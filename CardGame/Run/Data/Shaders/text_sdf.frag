@@ -0,0 +1,18 @@
+#version 450
+layout(location = 0) in vec4 fragColor;
+layout(location = 1) in vec2 fragTexCoord;
+
+layout(binding = 2) uniform sampler2D texSampler;
+
+layout(location = 0) out vec4 outColor;
+
+// the atlas alpha is the distance to the glyph edge, FONT_SDF_ON_EDGE_VALUE on the edge and larger inside
+const float onEdgeValue = 128.0 / 255.0;
+
+void main() {
+    float distance = texture(texSampler, fragTexCoord).a;
+    // antialias over about one screen pixel whatever the text size is
+    float smoothing = max(fwidth(distance) * 0.75, 0.001);
+    float alpha = smoothstep(onEdgeValue - smoothing, onEdgeValue + smoothing, distance);
+    outColor = vec4(fragColor.rgb, fragColor.a * alpha);
+}
\ No newline at end of file
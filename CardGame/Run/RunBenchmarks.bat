@@ -0,0 +1,19 @@
+@echo off
+rem Runs every benchmark scene at every size headless and writes Benchmarks\<scene>_<count>.json
+rem Pass a folder of older results to compare with, e.g. RunBenchmarks.bat Baseline
+rem With a baseline a timing or byte value more than 10%% worse fails the run, the exit code is 1 if any run failed
+rem To run on the CPU with lavapipe, point VK_ICD_FILENAMES to lvp_icd.x86_64.json first
+setlocal
+set FAILED=0
+if not exist Benchmarks mkdir Benchmarks
+for %%s in (entities cards text) do (
+	for %%c in (100 1000 10000 100000) do (
+		if "%~1"=="" (
+			CardGame_Release_x64.exe -headless -benchmark=%%s -count=%%c -frames=300 -benchmarkout=Benchmarks\%%s_%%c.json
+		) else (
+			CardGame_Release_x64.exe -headless -benchmark=%%s -count=%%c -frames=300 -benchmarkout=Benchmarks\%%s_%%c.json -benchmarkbaseline=%~1\%%s_%%c.json -benchmarkregression=10
+		)
+		if errorlevel 1 set FAILED=1
+	)
+)
+exit /b %FAILED%
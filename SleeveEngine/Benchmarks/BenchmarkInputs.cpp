@@ -0,0 +1,57 @@
+#include "Benchmarks/BenchmarkInputs.h"
+
+std::vector<Mat44> MakeBenchmarkModelMatrices( size_t count )
+{
+	std::mt19937 random( BenchmarkRandomSeed );
+	std::uniform_real_distribution<float> position( -500.f, 500.f );
+	std::uniform_real_distribution<float> angle( -180.f, 180.f );
+	std::vector<Mat44> matrices;
+	matrices.reserve( count );
+	for (size_t i = 0; i < count; ++i) {
+		Mat44 matrix( Vec3( 1.f, 0.f, 0.f ), Vec3( 0.f, 1.f, 0.f ), Vec3( 0.f, 0.f, 1.f ), Vec3( position( random ), position( random ), position( random ) ) );
+		matrix.Append( Euler( angle( random ), angle( random ), angle( random ) ).GetMatrix() );
+		matrices.push_back( matrix );
+	}
+	return matrices;
+}
+
+std::vector<Euler> MakeBenchmarkEulerAngles( size_t count )
+{
+	std::mt19937 random( BenchmarkRandomSeed );
+	std::uniform_real_distribution<float> angle( -180.f, 180.f );
+	std::vector<Euler> angles;
+	angles.reserve( count );
+	for (size_t i = 0; i < count; ++i) {
+		angles.emplace_back( angle( random ), angle( random ), angle( random ) );
+	}
+	return angles;
+}
+
+std::string MakeBenchmarkText( size_t length, std::mt19937& random )
+{
+	static char const* const punctuation = ".,!?:;'-+()";
+	std::uniform_int_distribution<int> wordLength( 2, 10 );
+	std::uniform_int_distribution<int> letter( 'a', 'z' );
+	std::uniform_int_distribution<int> digit( '0', '9' );
+	std::uniform_int_distribution<int> kind( 0, 9 );
+	std::uniform_int_distribution<int> punctuationIndex( 0, 10 );
+	std::string text;
+	text.reserve( length );
+	while (text.size() < length) {
+		if (!text.empty()) {
+			text.push_back( ' ' );
+		}
+		int wordKind = kind( random );
+		int letters = wordLength( random );
+		for (int i = 0; i < letters && text.size() < length; ++i) {
+			// one word in ten is a number, like damage and health values
+			char c = wordKind == 0 ? (char)digit( random ) : (char)letter( random );
+			text.push_back( i == 0 && wordKind == 1 ? (char)(c - 'a' + 'A') : c );
+		}
+		if (wordKind == 2 && text.size() < length) {
+			text.push_back( punctuation[punctuationIndex( random )] );
+		}
+	}
+	text.resize( length );
+	return text;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "Engine/Math/MathFwd.h"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+/// Deterministic inputs shared by the benchmarks, every run and every build sees the same values
+/// Pool sizes used as arguments: 16 stays in L1, 4096 in L2, 262144 spills out of the last level cache
+
+constexpr uint32_t BenchmarkRandomSeed = 20240612;
+
+/// model matrices like the entities build them: a translation in the play area and a rotation
+std::vector<Mat44> MakeBenchmarkModelMatrices( size_t count );
+/// yaw, pitch and roll anywhere in a full turn, like free rotating objects and cameras
+std::vector<Euler> MakeBenchmarkEulerAngles( size_t count );
+/// printable ASCII text of the given length with words of 2-10 letters, numbers and punctuation like card texts
+std::string MakeBenchmarkText( size_t length, std::mt19937& random );
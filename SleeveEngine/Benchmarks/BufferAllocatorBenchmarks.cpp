@@ -0,0 +1,102 @@
+#include "Benchmarks/Microbenchmark.h"
+#include "Benchmarks/BenchmarkInputs.h"
+#include "Engine/Graphics/NullRenderer.h"
+#include "Engine/Graphics/GraphicsFwd.h"
+
+/// The shared buffers of the Vulkan and the null renderer use the same first fit FindProperPositionForSizeInBuffer
+/// and ReturnMemory, the null renderer runs them without a device. Each iteration frees one random live
+/// allocation and allocates a new one of a random size, the argument is the number of live allocations
+
+constexpr uint32_t BenchmarkMaxVertexCount = 1024;
+
+/// 60% quads, 20% boxes, 15% text of 1-40 glyphs, 5% bigger meshes
+static uint32_t GetRandomVertexCount( std::mt19937& random )
+{
+	std::uniform_int_distribution<int> percent( 0, 99 );
+	int kind = percent( random );
+	if (kind < 60) {
+		return 4;
+	}
+	if (kind < 80) {
+		return 24;
+	}
+	if (kind < 95) {
+		return 6 * std::uniform_int_distribution<uint32_t>( 1, 40 )( random );
+	}
+	return std::uniform_int_distribution<uint32_t>( 256, BenchmarkMaxVertexCount )( random );
+}
+
+static void SharedVertexBufferChurn( MicrobenchmarkState& state )
+{
+	NullRenderer renderer;
+	renderer.Initialize();
+	std::vector<VertexPCU3D> vertexData( BenchmarkMaxVertexCount );
+	std::mt19937 random( BenchmarkRandomSeed );
+	std::vector<VertexBufferBinding> live( (size_t)state.GetArgument() );
+	for (auto& binding : live) {
+		uint32_t vertexCount = GetRandomVertexCount( random );
+		binding = renderer.AddVertsDataToSharedVertexBuffer( vertexData.data(), vertexCount * sizeof( VertexPCU3D ), vertexCount );
+	}
+	std::uniform_int_distribution<size_t> slot( 0, live.size() - 1 );
+
+	for (auto _ : state) {
+		VertexBufferBinding& binding = live[slot( random )];
+		renderer.ReturnMemoryToSharedBuffer( binding );
+		uint32_t vertexCount = GetRandomVertexCount( random );
+		binding = renderer.AddVertsDataToSharedVertexBuffer( vertexData.data(), vertexCount * sizeof( VertexPCU3D ), vertexCount );
+		Microbenchmark::DoNotOptimize( binding );
+	}
+	state.SetItemsProcessed( (int64_t)state.GetIterations() );
+	renderer.Cleanup();
+}
+MICROBENCHMARK( SharedVertexBufferChurn )->Arg( 64 )->Arg( 1024 )->Arg( 16384 );
+
+static void SharedIndexBufferChurn( MicrobenchmarkState& state )
+{
+	NullRenderer renderer;
+	renderer.Initialize();
+	std::vector<uint16_t> indexData( BenchmarkMaxVertexCount * 2 );
+	std::mt19937 random( BenchmarkRandomSeed );
+	std::vector<IndexBufferBinding> live( (size_t)state.GetArgument() );
+	// two triangles per four vertices
+	auto getIndexCount = [&random]() { return GetRandomVertexCount( random ) * 6 / 4; };
+	for (auto& binding : live) {
+		uint32_t indexCount = getIndexCount();
+		binding = renderer.AddIndicesDataToSharedIndexBuffer( indexData.data(), indexCount * sizeof( uint16_t ), indexCount );
+	}
+	std::uniform_int_distribution<size_t> slot( 0, live.size() - 1 );
+
+	for (auto _ : state) {
+		IndexBufferBinding& binding = live[slot( random )];
+		renderer.ReturnMemoryToSharedBuffer( binding );
+		uint32_t indexCount = getIndexCount();
+		binding = renderer.AddIndicesDataToSharedIndexBuffer( indexData.data(), indexCount * sizeof( uint16_t ), indexCount );
+		Microbenchmark::DoNotOptimize( binding );
+	}
+	state.SetItemsProcessed( (int64_t)state.GetIterations() );
+	renderer.Cleanup();
+}
+MICROBENCHMARK( SharedIndexBufferChurn )->Arg( 64 )->Arg( 1024 )->Arg( 16384 );
+
+/// fixed size model constants, one allocation per entity and frame in flight
+static void SharedUniformBufferChurn( MicrobenchmarkState& state )
+{
+	NullRenderer renderer;
+	renderer.Initialize();
+	std::mt19937 random( BenchmarkRandomSeed );
+	std::vector<UniformBufferBinding> live( (size_t)state.GetArgument() );
+	for (auto& binding : live) {
+		binding = renderer.AddDataToSharedUniformBuffer( UNIFORM_BUFFER_USE_MODEL_CONSTANTS_BINDING_2 );
+	}
+	std::uniform_int_distribution<size_t> slot( 0, live.size() - 1 );
+
+	for (auto _ : state) {
+		UniformBufferBinding& binding = live[slot( random )];
+		renderer.ReturnMemoryToSharedBuffer( binding );
+		binding = renderer.AddDataToSharedUniformBuffer( UNIFORM_BUFFER_USE_MODEL_CONSTANTS_BINDING_2 );
+		Microbenchmark::DoNotOptimize( binding );
+	}
+	state.SetItemsProcessed( (int64_t)state.GetIterations() );
+	renderer.Cleanup();
+}
+MICROBENCHMARK( SharedUniformBufferChurn )->Arg( 64 )->Arg( 1024 )->Arg( 16384 );
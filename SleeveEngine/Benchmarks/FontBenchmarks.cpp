@@ -0,0 +1,93 @@
+#include "Benchmarks/Microbenchmark.h"
+#include "Benchmarks/BenchmarkInputs.h"
+#include "Engine/Graphics/Font.h"
+
+#include <cstdio>
+#include <memory>
+
+/// relative to CardGame/Run, where the benchmark executable is copied to
+constexpr char const* BenchmarkFontPath = "Data/Fonts/arial.ttf";
+constexpr size_t BenchmarkTextPoolSize = 256;
+
+/// CPU side font only, no atlas texture, so no renderer is needed
+static Font const* GetBenchmarkFont()
+{
+	static std::unique_ptr<Font> s_font;
+	static bool s_isLoaded = false;
+	if (!s_isLoaded) {
+		s_isLoaded = true;
+		FILE* file = nullptr;
+		fopen_s( &file, BenchmarkFontPath, "rb" );
+		if (file) {
+			fclose( file );
+			s_font = std::make_unique<Font>( BenchmarkFontPath, false );
+		}
+	}
+	return s_font.get();
+}
+
+/// 2 characters: health and damage numbers, 16: card names, 128: descriptions
+static std::vector<std::string> MakeTextPool( size_t length )
+{
+	std::mt19937 random( BenchmarkRandomSeed );
+	std::vector<std::string> texts;
+	for (size_t i = 0; i < BenchmarkTextPoolSize; ++i) {
+		texts.push_back( MakeBenchmarkText( length, random ) );
+	}
+	return texts;
+}
+
+static void FontGetTextWidth( MicrobenchmarkState& state )
+{
+	Font const* font = GetBenchmarkFont();
+	if (!font) {
+		state.SkipWithError( std::string( "cannot find " ) + BenchmarkFontPath );
+		return;
+	}
+	size_t length = (size_t)state.GetArgument();
+	std::vector<std::string> texts = MakeTextPool( length );
+	size_t index = 0;
+	for (auto _ : state) {
+		float width = font->GetTextWidth( 20.f, texts[index] );
+		Microbenchmark::DoNotOptimize( width );
+		index = (index + 1) % BenchmarkTextPoolSize;
+	}
+	state.SetItemsProcessed( (int64_t)(state.GetIterations() * length) );
+}
+MICROBENCHMARK( FontGetTextWidth )->Arg( 2 )->Arg( 16 )->Arg( 128 );
+
+static void AddVertsForTextInBox2D( MicrobenchmarkState& state, TextBoxMode mode )
+{
+	Font const* font = GetBenchmarkFont();
+	if (!font) {
+		state.SkipWithError( std::string( "cannot find " ) + BenchmarkFontPath );
+		return;
+	}
+	size_t length = (size_t)state.GetArgument();
+	std::vector<std::string> texts = MakeTextPool( length );
+	// the vertex vector is reused like the card text vertices are, so only the layout is measured
+	std::vector<VertexPCU3D> verts;
+	verts.reserve( Font::GetMaxVertexCount( texts[0] ) );
+	AABB2 box( Vec2( -32.f, -43.f ), Vec2( 32.f, 43.f ) );
+	size_t index = 0;
+	for (auto _ : state) {
+		verts.clear();
+		font->AddVertsForTextInBox2D( verts, texts[index], box, Rgba8( 0, 0, 0 ), 12.f, Vec2( 0.5f, 0.5f ), mode, 1.f );
+		Microbenchmark::DoNotOptimize( verts.data() );
+		Microbenchmark::ClobberMemory();
+		index = (index + 1) % BenchmarkTextPoolSize;
+	}
+	state.SetItemsProcessed( (int64_t)(state.GetIterations() * length) );
+}
+
+static void FontAddVertsShrinkToFit( MicrobenchmarkState& state )
+{
+	AddVertsForTextInBox2D( state, TextBoxMode::SHRINK_TO_FIT );
+}
+MICROBENCHMARK( FontAddVertsShrinkToFit )->Arg( 2 )->Arg( 16 )->Arg( 128 );
+
+static void FontAddVertsAutoNewLine( MicrobenchmarkState& state )
+{
+	AddVertsForTextInBox2D( state, TextBoxMode::AUTO_NEW_LINE );
+}
+MICROBENCHMARK( FontAddVertsAutoNewLine )->Arg( 16 )->Arg( 128 );
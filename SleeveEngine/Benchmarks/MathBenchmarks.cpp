@@ -0,0 +1,66 @@
+#include "Benchmarks/Microbenchmark.h"
+#include "Benchmarks/BenchmarkInputs.h"
+
+static void Mat44Append( MicrobenchmarkState& state )
+{
+	size_t count = (size_t)state.GetArgument();
+	std::vector<Mat44> lhs = MakeBenchmarkModelMatrices( count );
+	std::vector<Mat44> rhs = MakeBenchmarkModelMatrices( count + 1 );
+	size_t index = 0;
+	for (auto _ : state) {
+		lhs[index].Append( rhs[index + 1] );
+		Microbenchmark::DoNotOptimize( lhs[index] );
+		index = index + 1 == count ? 0 : index + 1;
+	}
+	state.SetItemsProcessed( (int64_t)state.GetIterations() );
+}
+MICROBENCHMARK( Mat44Append )->Arg( 16 )->Arg( 4096 )->Arg( 262144 );
+
+static void Mat44MultiplyRight( MicrobenchmarkState& state )
+{
+	size_t count = (size_t)state.GetArgument();
+	std::vector<Mat44> lhs = MakeBenchmarkModelMatrices( count );
+	std::vector<Mat44> rhs = MakeBenchmarkModelMatrices( count + 1 );
+	std::vector<Mat44> results( count );
+	size_t index = 0;
+	for (auto _ : state) {
+		results[index] = lhs[index].MultiplyRight( rhs[index + 1] );
+		Microbenchmark::DoNotOptimize( results[index] );
+		index = index + 1 == count ? 0 : index + 1;
+	}
+	state.SetItemsProcessed( (int64_t)state.GetIterations() );
+}
+MICROBENCHMARK( Mat44MultiplyRight )->Arg( 16 )->Arg( 4096 )->Arg( 262144 );
+
+static void EulerGetMatrix( MicrobenchmarkState& state )
+{
+	size_t count = (size_t)state.GetArgument();
+	std::vector<Euler> angles = MakeBenchmarkEulerAngles( count );
+	std::vector<Mat44> results( count );
+	size_t index = 0;
+	for (auto _ : state) {
+		results[index] = angles[index].GetMatrix();
+		Microbenchmark::DoNotOptimize( results[index] );
+		index = index + 1 == count ? 0 : index + 1;
+	}
+	state.SetItemsProcessed( (int64_t)state.GetIterations() );
+}
+MICROBENCHMARK( EulerGetMatrix )->Arg( 16 )->Arg( 4096 )->Arg( 262144 );
+
+/// the whole model matrix of Entity3D::CalculateModelMatrix: translation, then rotation appended
+static void EntityModelMatrix( MicrobenchmarkState& state )
+{
+	size_t count = (size_t)state.GetArgument();
+	std::vector<Euler> angles = MakeBenchmarkEulerAngles( count );
+	std::vector<Mat44> results( count );
+	size_t index = 0;
+	for (auto _ : state) {
+		Mat44& modelMatrix = results[index];
+		modelMatrix = Mat44( Vec3( 1.f, 0.f, 0.f ), Vec3( 0.f, 1.f, 0.f ), Vec3( 0.f, 0.f, 1.f ), Vec3( (float)index, 0.f, 0.f ) );
+		modelMatrix.Append( angles[index].GetMatrix() );
+		Microbenchmark::DoNotOptimize( modelMatrix );
+		index = index + 1 == count ? 0 : index + 1;
+	}
+	state.SetItemsProcessed( (int64_t)state.GetIterations() );
+}
+MICROBENCHMARK( EntityModelMatrix )->Arg( 16 )->Arg( 4096 )->Arg( 262144 );
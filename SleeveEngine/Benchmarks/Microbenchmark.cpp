@@ -0,0 +1,406 @@
+#include "Benchmarks/Microbenchmark.h"
+#include "Engine/Core/Time.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <regex>
+#include <string_view>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+constexpr uint64_t MicrobenchmarkMaxIterations = 1000000000;
+
+static std::vector<MicrobenchmarkRegistration*>& GetRegistrations()
+{
+	// function local so registrations from static initializers of other files always find it constructed
+	static std::vector<MicrobenchmarkRegistration*> s_registrations;
+	return s_registrations;
+}
+
+/// CPU time of the calling thread, so time spent preempted is not counted
+static double GetThreadCpuSeconds()
+{
+#ifdef _WIN32
+	FILETIME creationTime, exitTime, kernelTime, userTime;
+	GetThreadTimes( GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime );
+	uint64_t kernel = ((uint64_t)kernelTime.dwHighDateTime << 32) | kernelTime.dwLowDateTime;
+	uint64_t user = ((uint64_t)userTime.dwHighDateTime << 32) | userTime.dwLowDateTime;
+	return (kernel + user) * 1e-7;
+#else
+	timespec time;
+	clock_gettime( CLOCK_THREAD_CPUTIME_ID, &time );
+	return time.tv_sec + time.tv_nsec * 1e-9;
+#endif
+}
+
+MicrobenchmarkState::MicrobenchmarkState( int64_t argument, uint64_t iterations )
+	:m_argument( argument ), m_iterations( iterations )
+{
+}
+
+MicrobenchmarkState::Iterator MicrobenchmarkState::begin()
+{
+	ResumeTiming();
+	return Iterator{ this, m_errorMessage.empty() ? m_iterations : 0 };
+}
+
+MicrobenchmarkState::Iterator MicrobenchmarkState::end()
+{
+	return Iterator{ this, 0 };
+}
+
+void MicrobenchmarkState::FinishLoop()
+{
+	PauseTiming();
+}
+
+int64_t MicrobenchmarkState::GetArgument() const
+{
+	return m_argument;
+}
+
+uint64_t MicrobenchmarkState::GetIterations() const
+{
+	return m_iterations;
+}
+
+void MicrobenchmarkState::PauseTiming()
+{
+	if (m_isTiming) {
+		m_elapsedSeconds += GetCurrentTimeSeconds() - m_startSeconds;
+		m_elapsedCpuSeconds += GetThreadCpuSeconds() - m_startCpuSeconds;
+		m_isTiming = false;
+	}
+}
+
+void MicrobenchmarkState::ResumeTiming()
+{
+	if (!m_isTiming) {
+		m_isTiming = true;
+		m_startCpuSeconds = GetThreadCpuSeconds();
+		m_startSeconds = GetCurrentTimeSeconds();
+	}
+}
+
+void MicrobenchmarkState::SetItemsProcessed( int64_t items )
+{
+	m_itemsProcessed = items;
+}
+
+void MicrobenchmarkState::SetBytesProcessed( int64_t bytes )
+{
+	m_bytesProcessed = bytes;
+}
+
+void MicrobenchmarkState::SetLabel( std::string const& label )
+{
+	m_label = label;
+}
+
+void MicrobenchmarkState::SkipWithError( std::string const& message )
+{
+	m_errorMessage = message;
+}
+
+MicrobenchmarkRegistration::MicrobenchmarkRegistration( char const* name, MicrobenchmarkFunction function )
+	:m_name( name ), m_function( function )
+{
+}
+
+MicrobenchmarkRegistration* MicrobenchmarkRegistration::Arg( int64_t argument )
+{
+	m_arguments.push_back( argument );
+	return this;
+}
+
+MicrobenchmarkRegistration* Microbenchmark::Register( char const* name, MicrobenchmarkFunction function )
+{
+	// registrations live until the program ends
+	MicrobenchmarkRegistration* registration = new MicrobenchmarkRegistration( name, function );
+	GetRegistrations().push_back( registration );
+	return registration;
+}
+
+MicrobenchmarkConfig Microbenchmark::ParseCommandLine( int argc, char* argv[] )
+{
+	MicrobenchmarkConfig config;
+	for (int i = 1; i < argc; ++i) {
+		std::string_view arg = argv[i];
+		if (arg.starts_with( "-filter=" )) {
+			config.m_filter = argv[i] + strlen( "-filter=" );
+		}
+		else if (arg.starts_with( "-out=" )) {
+			config.m_outputPath = argv[i] + strlen( "-out=" );
+		}
+		else if (arg.starts_with( "-mintime=" )) {
+			config.m_minSeconds = std::strtod( argv[i] + strlen( "-mintime=" ), nullptr );
+		}
+		else if (arg.starts_with( "-repetitions=" )) {
+			config.m_repetitions = std::max( 1u, (uint32_t)std::strtoul( argv[i] + strlen( "-repetitions=" ), nullptr, 10 ) );
+		}
+		else if (arg == "-list") {
+			config.m_listOnly = true;
+		}
+	}
+	return config;
+}
+
+void Microbenchmark::ClobberMemory()
+{
+	std::atomic_signal_fence( std::memory_order_seq_cst );
+}
+
+void Microbenchmark::Escape( void const volatile* pointer )
+{
+	// defined out of line so the compiler has to assume the value is read
+	static void const volatile* volatile s_sink;
+	s_sink = pointer;
+	std::atomic_signal_fence( std::memory_order_seq_cst );
+}
+
+struct MicrobenchmarkResult {
+	std::string m_name;
+	std::string m_runName;
+	std::string m_runType = "iteration";
+	std::string m_aggregateName;
+	std::string m_label;
+	std::string m_errorMessage;
+	uint32_t m_repetitionIndex = 0;
+	uint64_t m_iterations = 0;
+	double m_realNanoseconds = 0.0;
+	double m_cpuNanoseconds = 0.0;
+	double m_itemsPerSecond = 0.0;
+	double m_bytesPerSecond = 0.0;
+};
+
+MicrobenchmarkResult Microbenchmark::RunOnce( MicrobenchmarkRegistration const& registration, std::string const& name, int64_t argument, uint64_t iterations )
+{
+	MicrobenchmarkState state( argument, iterations );
+	registration.m_function( state );
+	state.PauseTiming();
+
+	MicrobenchmarkResult result;
+	result.m_name = name;
+	result.m_runName = name;
+	result.m_iterations = iterations;
+	result.m_label = state.m_label;
+	result.m_errorMessage = state.m_errorMessage;
+	result.m_realNanoseconds = state.m_elapsedSeconds * 1e9 / (double)iterations;
+	result.m_cpuNanoseconds = state.m_elapsedCpuSeconds * 1e9 / (double)iterations;
+	if (state.m_elapsedSeconds > 0.0) {
+		result.m_itemsPerSecond = state.m_itemsProcessed / state.m_elapsedSeconds;
+		result.m_bytesPerSecond = state.m_bytesProcessed / state.m_elapsedSeconds;
+	}
+	return result;
+}
+
+MicrobenchmarkResult Microbenchmark::RunCalibrated( MicrobenchmarkRegistration const& registration, std::string const& name, int64_t argument, double minSeconds, uint64_t& out_iterations )
+{
+	uint64_t iterations = 1;
+	while (true) {
+		MicrobenchmarkResult result = RunOnce( registration, name, argument, iterations );
+		double seconds = result.m_realNanoseconds * 1e-9 * (double)iterations;
+		if (!result.m_errorMessage.empty() || seconds >= minSeconds || iterations >= MicrobenchmarkMaxIterations) {
+			out_iterations = iterations;
+			return result;
+		}
+		// aim 40% past the minimum so the next run most likely ends the calibration, but never grow more than 10x
+		double multiplier = seconds > 0.0 ? minSeconds * 1.4 / seconds : 10.0;
+		multiplier = std::clamp( multiplier, 2.0, 10.0 );
+		iterations = std::min( MicrobenchmarkMaxIterations, (uint64_t)std::ceil( iterations * multiplier ) );
+	}
+}
+
+static void AddAggregates( std::vector<MicrobenchmarkResult> const& repetitions, std::vector<MicrobenchmarkResult>& out_results )
+{
+	size_t count = repetitions.size();
+	auto makeAggregate = [&]( char const* aggregateName, auto getValue ) {
+		MicrobenchmarkResult aggregate = repetitions[0];
+		aggregate.m_name = repetitions[0].m_runName + "_" + aggregateName;
+		aggregate.m_runType = "aggregate";
+		aggregate.m_aggregateName = aggregateName;
+		aggregate.m_realNanoseconds = getValue( &MicrobenchmarkResult::m_realNanoseconds );
+		aggregate.m_cpuNanoseconds = getValue( &MicrobenchmarkResult::m_cpuNanoseconds );
+		aggregate.m_itemsPerSecond = getValue( &MicrobenchmarkResult::m_itemsPerSecond );
+		aggregate.m_bytesPerSecond = getValue( &MicrobenchmarkResult::m_bytesPerSecond );
+		out_results.push_back( aggregate );
+	};
+	auto mean = [&]( double MicrobenchmarkResult::* field ) {
+		double sum = 0.0;
+		for (auto const& result : repetitions) {
+			sum += result.*field;
+		}
+		return sum / count;
+	};
+	makeAggregate( "mean", mean );
+	makeAggregate( "median", [&]( double MicrobenchmarkResult::* field ) {
+		std::vector<double> values;
+		for (auto const& result : repetitions) {
+			values.push_back( result.*field );
+		}
+		std::sort( values.begin(), values.end() );
+		return count % 2 == 1 ? values[count / 2] : 0.5 * (values[count / 2 - 1] + values[count / 2]);
+		} );
+	makeAggregate( "stddev", [&]( double MicrobenchmarkResult::* field ) {
+		double average = mean( field );
+		double sum = 0.0;
+		for (auto const& result : repetitions) {
+			sum += (result.*field - average) * (result.*field - average);
+		}
+		return count > 1 ? std::sqrt( sum / (count - 1) ) : 0.0;
+		} );
+}
+
+static void PrintResult( MicrobenchmarkResult const& result )
+{
+	if (!result.m_errorMessage.empty()) {
+		printf( "%-48s ERROR: %s\n", result.m_name.c_str(), result.m_errorMessage.c_str() );
+		return;
+	}
+	printf( "%-48s %13.2f ns %13.2f ns %12llu", result.m_name.c_str(), result.m_realNanoseconds, result.m_cpuNanoseconds, result.m_iterations );
+	if (result.m_itemsPerSecond > 0.0) {
+		printf( " %10.3fM items/s", result.m_itemsPerSecond * 1e-6 );
+	}
+	if (result.m_bytesPerSecond > 0.0) {
+		printf( " %10.3f MB/s", result.m_bytesPerSecond * 1e-6 );
+	}
+	if (!result.m_label.empty()) {
+		printf( " %s", result.m_label.c_str() );
+	}
+	printf( "\n" );
+}
+
+static void WriteJsonString( FILE* file, std::string const& string )
+{
+	fputc( '"', file );
+	for (char c : string) {
+		if (c == '"' || c == '\\') {
+			fputc( '\\', file );
+		}
+		fputc( c, file );
+	}
+	fputc( '"', file );
+}
+
+static bool WriteJson( std::string const& path, std::vector<MicrobenchmarkResult> const& results, uint32_t repetitions )
+{
+	FILE* file = nullptr;
+	fopen_s( &file, path.c_str(), "w" );
+	if (!file) {
+		return false;
+	}
+	char date[64] = {};
+	time_t now = time( nullptr );
+	tm localTime;
+#ifdef _WIN32
+	localtime_s( &localTime, &now );
+#else
+	localtime_r( &now, &localTime );
+#endif
+	strftime( date, sizeof( date ), "%Y-%m-%dT%H:%M:%S", &localTime );
+#ifdef NDEBUG
+	char const* buildType = "release";
+#else
+	char const* buildType = "debug";
+#endif
+	fprintf( file, "{\n  \"context\": {\n    \"date\": \"%s\",\n    \"num_cpus\": %u,\n    \"library_build_type\": \"%s\"\n  },\n  \"benchmarks\": [",
+		date, std::thread::hardware_concurrency(), buildType );
+	for (size_t i = 0; i < results.size(); ++i) {
+		MicrobenchmarkResult const& result = results[i];
+		fprintf( file, "%s\n    {\n      \"name\": ", i == 0 ? "" : "," );
+		WriteJsonString( file, result.m_name );
+		fprintf( file, ",\n      \"run_name\": " );
+		WriteJsonString( file, result.m_runName );
+		fprintf( file, ",\n      \"run_type\": \"%s\",\n      \"repetitions\": %u,\n      \"repetition_index\": %u,\n      \"threads\": 1",
+			result.m_runType.c_str(), repetitions, result.m_repetitionIndex );
+		if (!result.m_aggregateName.empty()) {
+			fprintf( file, ",\n      \"aggregate_name\": \"%s\"", result.m_aggregateName.c_str() );
+		}
+		if (!result.m_errorMessage.empty()) {
+			fprintf( file, ",\n      \"error_occurred\": true,\n      \"error_message\": " );
+			WriteJsonString( file, result.m_errorMessage );
+		}
+		fprintf( file, ",\n      \"iterations\": %llu,\n      \"real_time\": %.6e,\n      \"cpu_time\": %.6e,\n      \"time_unit\": \"ns\"",
+			result.m_iterations, result.m_realNanoseconds, result.m_cpuNanoseconds );
+		if (result.m_itemsPerSecond > 0.0) {
+			fprintf( file, ",\n      \"items_per_second\": %.6e", result.m_itemsPerSecond );
+		}
+		if (result.m_bytesPerSecond > 0.0) {
+			fprintf( file, ",\n      \"bytes_per_second\": %.6e", result.m_bytesPerSecond );
+		}
+		if (!result.m_label.empty()) {
+			fprintf( file, ",\n      \"label\": " );
+			WriteJsonString( file, result.m_label );
+		}
+		fprintf( file, "\n    }" );
+	}
+	fprintf( file, "\n  ]\n}\n" );
+	fclose( file );
+	return true;
+}
+
+int Microbenchmark::RunAll( MicrobenchmarkConfig const& config )
+{
+	std::regex filter( config.m_filter.empty() ? ".*" : config.m_filter );
+	std::vector<MicrobenchmarkResult> results;
+	int failedCount = 0;
+
+	if (!config.m_listOnly) {
+		printf( "%-48s %16s %16s %12s\n", "Benchmark", "Time", "CPU", "Iterations" );
+	}
+	for (MicrobenchmarkRegistration const* registration : GetRegistrations()) {
+		std::vector<int64_t> arguments = registration->m_arguments;
+		bool hasArguments = !arguments.empty();
+		if (!hasArguments) {
+			arguments.push_back( 0 );
+		}
+		for (int64_t argument : arguments) {
+			std::string name = hasArguments ? registration->m_name + "/" + std::to_string( argument ) : registration->m_name;
+			if (!std::regex_search( name, filter )) {
+				continue;
+			}
+			if (config.m_listOnly) {
+				printf( "%s\n", name.c_str() );
+				continue;
+			}
+
+			// calibrate once, then every repetition runs the same number of iterations
+			uint64_t iterations = 0;
+			MicrobenchmarkResult first = RunCalibrated( *registration, name, argument, config.m_minSeconds, iterations );
+			std::vector<MicrobenchmarkResult> repetitions = { first };
+			for (uint32_t i = 1; i < config.m_repetitions && first.m_errorMessage.empty(); ++i) {
+				repetitions.push_back( RunOnce( *registration, name, argument, iterations ) );
+				repetitions.back().m_repetitionIndex = i;
+			}
+			for (auto const& result : repetitions) {
+				PrintResult( result );
+				results.push_back( result );
+			}
+			if (!first.m_errorMessage.empty()) {
+				++failedCount;
+			}
+			else if (repetitions.size() > 1) {
+				size_t aggregateStart = results.size();
+				AddAggregates( repetitions, results );
+				for (size_t i = aggregateStart; i < results.size(); ++i) {
+					PrintResult( results[i] );
+				}
+			}
+		}
+	}
+
+	if (!config.m_outputPath.empty() && !config.m_listOnly && !WriteJson( config.m_outputPath, results, config.m_repetitions )) {
+		printf( "Cannot write benchmark results %s\n", config.m_outputPath.c_str() );
+	}
+	return failedCount;
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct MicrobenchmarkResult;
+/// Per run state handed to a benchmark function, the timed loop is written as
+///     for (auto _ : state) { ... }
+/// and runs GetIterations() times
+class MicrobenchmarkState {
+public:
+	struct Iterator {
+		MicrobenchmarkState* m_state = nullptr;
+		uint64_t m_remaining = 0;
+		bool operator!=( Iterator const& ) const
+		{
+			if (m_remaining != 0) {
+				return true;
+			}
+			m_state->FinishLoop();
+			return false;
+		}
+		void operator++() { --m_remaining; }
+		int operator*() const { return 0; }
+	};
+
+	Iterator begin();
+	Iterator end();
+
+	/// argument of the current variant, see MicrobenchmarkRegistration::Arg
+	int64_t GetArgument() const;
+	uint64_t GetIterations() const;
+	/// exclude setup inside the loop from the measurement
+	void PauseTiming();
+	void ResumeTiming();
+	/// reported as items_per_second / bytes_per_second
+	void SetItemsProcessed( int64_t items );
+	void SetBytesProcessed( int64_t bytes );
+	void SetLabel( std::string const& label );
+	/// stop the benchmark, the message shows up in the results instead of timings
+	void SkipWithError( std::string const& message );
+
+protected:
+	friend class Microbenchmark;
+	MicrobenchmarkState( int64_t argument, uint64_t iterations );
+	void FinishLoop();
+
+	int64_t m_argument = 0;
+	uint64_t m_iterations = 0;
+	int64_t m_itemsProcessed = 0;
+	int64_t m_bytesProcessed = 0;
+	std::string m_label;
+	std::string m_errorMessage;
+	bool m_isTiming = false;
+	double m_startSeconds = 0.0;
+	double m_startCpuSeconds = 0.0;
+	double m_elapsedSeconds = 0.0;
+	double m_elapsedCpuSeconds = 0.0;
+};
+
+typedef void (*MicrobenchmarkFunction)( MicrobenchmarkState& state );
+
+class MicrobenchmarkRegistration {
+public:
+	MicrobenchmarkRegistration( char const* name, MicrobenchmarkFunction function );
+	/// add a variant, the benchmark is run once per argument and named name/argument
+	MicrobenchmarkRegistration* Arg( int64_t argument );
+
+	std::string m_name;
+	MicrobenchmarkFunction m_function = nullptr;
+	std::vector<int64_t> m_arguments;
+};
+
+/// settings of one harness run, parsed from the command line
+struct MicrobenchmarkConfig {
+	/// regular expression, only matching benchmark names run
+	std::string m_filter;
+	/// JSON results in the Google Benchmark format, so its compare tools can diff two runs
+	std::string m_outputPath;
+	double m_minSeconds = 0.5;
+	uint32_t m_repetitions = 1;
+	bool m_listOnly = false;
+};
+
+/// Registry and runner of microbenchmarks. Each benchmark is calibrated until one run takes m_minSeconds,
+/// then run m_repetitions times; with more than one repetition mean, median and stddev are reported too
+class Microbenchmark {
+public:
+	static MicrobenchmarkRegistration* Register( char const* name, MicrobenchmarkFunction function );
+	/// -filter=regex -out=path.json -mintime=seconds -repetitions=N -list
+	static MicrobenchmarkConfig ParseCommandLine( int argc, char* argv[] );
+	/// returns the number of benchmarks that failed
+	static int RunAll( MicrobenchmarkConfig const& config );
+
+	/// keep the compiler from optimizing away a value that is never read
+	template<typename T>
+	static void DoNotOptimize( T const& value );
+	/// keep the compiler from assuming memory is unchanged across this point
+	static void ClobberMemory();
+
+protected:
+	static void Escape( void const volatile* pointer );
+	static MicrobenchmarkResult RunOnce( MicrobenchmarkRegistration const& registration, std::string const& name, int64_t argument, uint64_t iterations );
+	/// grow the iteration count until one run takes the minimum time, then return the result of that run
+	static MicrobenchmarkResult RunCalibrated( MicrobenchmarkRegistration const& registration, std::string const& name, int64_t argument, double minSeconds, uint64_t& out_iterations );
+};
+
+template<typename T>
+void Microbenchmark::DoNotOptimize( T const& value )
+{
+	Escape( &value );
+}
+
+#define MICROBENCHMARK_CONCAT_IMPL( a, b ) a##b
+#define MICROBENCHMARK_CONCAT( a, b ) MICROBENCHMARK_CONCAT_IMPL( a, b )
+/// register a function void Name( MicrobenchmarkState& state ), chain ->Arg( N ) to add variants
+#define MICROBENCHMARK( function ) \
+	static MicrobenchmarkRegistration* MICROBENCHMARK_CONCAT( s_microbenchmark_, __LINE__ ) = Microbenchmark::Register( #function, function )
@@ -0,0 +1,51 @@
+#include "Benchmarks/Microbenchmark.h"
+#include "Benchmarks/BenchmarkInputs.h"
+#include "Engine/Core/StringUtils.h"
+
+/// comma separated numbers like the XML attributes of definitions, "0.5, 1, 2.25"
+static std::string MakeNumberList( size_t fieldCount, std::mt19937& random )
+{
+	std::uniform_real_distribution<float> value( -100.f, 100.f );
+	std::string list;
+	for (size_t i = 0; i < fieldCount; ++i) {
+		if (i != 0) {
+			list += ", ";
+		}
+		list += std::to_string( value( random ) );
+	}
+	return list;
+}
+
+static void SplitNumberList( MicrobenchmarkState& state, bool removeExtraSpace )
+{
+	size_t fieldCount = (size_t)state.GetArgument();
+	std::mt19937 random( BenchmarkRandomSeed );
+	std::vector<std::string> lists;
+	int64_t bytes = 0;
+	for (int i = 0; i < 64; ++i) {
+		lists.push_back( MakeNumberList( fieldCount, random ) );
+	}
+	Strings results;
+	size_t index = 0;
+	for (auto _ : state) {
+		int count = SplitStringOnDelimiter( results, lists[index], ',', removeExtraSpace );
+		Microbenchmark::DoNotOptimize( count );
+		bytes += (int64_t)lists[index].size();
+		index = (index + 1) % lists.size();
+	}
+	state.SetItemsProcessed( (int64_t)(state.GetIterations() * fieldCount) );
+	state.SetBytesProcessed( bytes );
+}
+
+/// 3 fields: Vec3 and Rgba8 attributes, 16: a row of a table, 256: a long data line
+static void SplitStringOnComma( MicrobenchmarkState& state )
+{
+	SplitNumberList( state, false );
+}
+MICROBENCHMARK( SplitStringOnComma )->Arg( 3 )->Arg( 16 )->Arg( 256 );
+
+static void SplitStringOnCommaRemoveSpace( MicrobenchmarkState& state )
+{
+	SplitNumberList( state, true );
+}
+MICROBENCHMARK( SplitStringOnCommaRemoveSpace )->Arg( 3 )->Arg( 16 )->Arg( 256 );
@@ -0,0 +1,9 @@
+#include "Benchmarks/Microbenchmark.h"
+
+/// Runs the engine microbenchmarks, see Microbenchmark::ParseCommandLine for the options
+/// Run from CardGame/Run so the font benchmarks find their font
+int main( int argc, char* argv[] )
+{
+	MicrobenchmarkConfig config = Microbenchmark::ParseCommandLine( argc, argv );
+	return Microbenchmark::RunAll( config ) == 0 ? 0 : 1;
+}
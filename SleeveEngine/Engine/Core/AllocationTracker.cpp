@@ -0,0 +1,212 @@
+#include "Core/AllocationTracker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include <new>
+
+// everything here is constant initialized, operator new can run before any dynamic initializer
+struct AllocationTagCounters {
+	std::atomic<char const*> m_name = nullptr;
+	std::atomic<uint64_t> m_allocations = 0;
+	std::atomic<uint64_t> m_bytes = 0;
+};
+
+static AllocationTagCounters s_tags[ALLOCATION_TRACKER_MAX_TAGS];
+// tag 0 is the untagged one
+static std::atomic<uint32_t> s_tagCount = 1;
+static std::atomic<uint64_t> s_frees = 0;
+static std::atomic_flag s_registerLock = ATOMIC_FLAG_INIT;
+static AllocationFrameStatistics s_lastFrame;
+
+static thread_local uint32_t t_tagStack[ALLOCATION_TRACKER_MAX_TAG_DEPTH];
+static thread_local uint32_t t_tagDepth = 0;
+
+static uint32_t FindTag( char const* name, uint32_t tagCount )
+{
+	for (uint32_t i = 1; i < tagCount; ++i) {
+		char const* tagName = s_tags[i].m_name.load( std::memory_order_acquire );
+		// the same literal can have different addresses in different translation units
+		if (tagName == name || strcmp( tagName, name ) == 0) {
+			return i;
+		}
+	}
+	return 0;
+}
+
+static uint32_t FindOrRegisterTag( char const* name )
+{
+	uint32_t index = FindTag( name, s_tagCount.load( std::memory_order_acquire ) );
+	if (index != 0) {
+		return index;
+	}
+	while (s_registerLock.test_and_set( std::memory_order_acquire )) {
+	}
+	uint32_t tagCount = s_tagCount.load( std::memory_order_relaxed );
+	index = FindTag( name, tagCount );
+	if (index == 0 && tagCount < ALLOCATION_TRACKER_MAX_TAGS) {
+		index = tagCount;
+		s_tags[index].m_name.store( name, std::memory_order_release );
+		s_tagCount.store( tagCount + 1, std::memory_order_release );
+	}
+	s_registerLock.clear( std::memory_order_release );
+	return index;
+}
+
+bool AllocationBudget::IsExceededBy( AllocationFrameStatistics const& frame ) const
+{
+	return frame.m_allocations > m_maxAllocations || frame.m_bytes > m_maxBytes;
+}
+
+void AllocationTracker::EndFrame()
+{
+	AllocationFrameStatistics& frame = s_lastFrame;
+	frame.m_allocations = 0;
+	frame.m_bytes = 0;
+	frame.m_tagCount = 0;
+	uint32_t tagCount = s_tagCount.load( std::memory_order_acquire );
+	for (uint32_t i = 0; i < tagCount; ++i) {
+		uint64_t allocations = s_tags[i].m_allocations.exchange( 0, std::memory_order_relaxed );
+		uint64_t bytes = s_tags[i].m_bytes.exchange( 0, std::memory_order_relaxed );
+		if (allocations == 0) {
+			continue;
+		}
+		AllocationTagStatistics& tag = frame.m_tags[frame.m_tagCount++];
+		tag.m_name = i == 0 ? "Untagged" : s_tags[i].m_name.load( std::memory_order_relaxed );
+		tag.m_allocations = allocations;
+		tag.m_bytes = bytes;
+		frame.m_allocations += allocations;
+		frame.m_bytes += bytes;
+	}
+	frame.m_frees = s_frees.exchange( 0, std::memory_order_relaxed );
+}
+
+AllocationFrameStatistics const& AllocationTracker::GetLastFrame()
+{
+	return s_lastFrame;
+}
+
+void AllocationTracker::PrintFrame( AllocationFrameStatistics const& frame, char const* title )
+{
+	printf( "%s: %llu allocations, %llu bytes, %llu frees\n", title, frame.m_allocations, frame.m_bytes, frame.m_frees );
+	std::array<AllocationTagStatistics, ALLOCATION_TRACKER_MAX_TAGS> tags = frame.m_tags;
+	std::sort( tags.begin(), tags.begin() + frame.m_tagCount, []( AllocationTagStatistics const& a, AllocationTagStatistics const& b ) {
+		return a.m_allocations > b.m_allocations;
+		} );
+	for (uint32_t i = 0; i < frame.m_tagCount; ++i) {
+		printf( "  %-32s %10llu %14llu bytes\n", tags[i].m_name, tags[i].m_allocations, tags[i].m_bytes );
+	}
+}
+
+void AllocationTracker::PushTag( char const* name )
+{
+	uint32_t index = FindOrRegisterTag( name );
+	if (t_tagDepth < ALLOCATION_TRACKER_MAX_TAG_DEPTH) {
+		t_tagStack[t_tagDepth] = index;
+	}
+	++t_tagDepth;
+}
+
+void AllocationTracker::PopTag()
+{
+	if (t_tagDepth > 0) {
+		--t_tagDepth;
+	}
+}
+
+void AllocationTracker::RecordAllocation( size_t size )
+{
+	uint32_t index = 0;
+	if (t_tagDepth > 0) {
+		// scopes deeper than the limit count for the deepest recorded one
+		index = t_tagStack[std::min( t_tagDepth, ALLOCATION_TRACKER_MAX_TAG_DEPTH ) - 1];
+	}
+	s_tags[index].m_allocations.fetch_add( 1, std::memory_order_relaxed );
+	s_tags[index].m_bytes.fetch_add( size, std::memory_order_relaxed );
+}
+
+void AllocationTracker::RecordFree()
+{
+	s_frees.fetch_add( 1, std::memory_order_relaxed );
+}
+
+#ifndef NO_ALLOCATION_TRACKER
+void* operator new( size_t size )
+{
+	AllocationTracker::RecordAllocation( size );
+	void* memory = malloc( size > 0 ? size : 1 );
+	if (!memory) {
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* operator new[]( size_t size )
+{
+	return operator new( size );
+}
+
+void* operator new( size_t size, std::align_val_t alignment )
+{
+	AllocationTracker::RecordAllocation( size );
+	void* memory = _aligned_malloc( size > 0 ? size : 1, (size_t)alignment );
+	if (!memory) {
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* operator new[]( size_t size, std::align_val_t alignment )
+{
+	return operator new( size, alignment );
+}
+
+void operator delete( void* memory ) noexcept
+{
+	if (memory) {
+		AllocationTracker::RecordFree();
+		free( memory );
+	}
+}
+
+void operator delete[]( void* memory ) noexcept
+{
+	operator delete( memory );
+}
+
+void operator delete( void* memory, size_t size ) noexcept
+{
+	operator delete( memory );
+}
+
+void operator delete[]( void* memory, size_t size ) noexcept
+{
+	operator delete( memory );
+}
+
+void operator delete( void* memory, std::align_val_t alignment ) noexcept
+{
+	if (memory) {
+		AllocationTracker::RecordFree();
+		_aligned_free( memory );
+	}
+}
+
+void operator delete[]( void* memory, std::align_val_t alignment ) noexcept
+{
+	operator delete( memory, alignment );
+}
+
+void operator delete( void* memory, size_t size, std::align_val_t alignment ) noexcept
+{
+	operator delete( memory, alignment );
+}
+
+void operator delete[]( void* memory, size_t size, std::align_val_t alignment ) noexcept
+{
+	operator delete( memory, alignment );
+}
+#endif
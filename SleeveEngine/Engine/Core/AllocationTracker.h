@@ -0,0 +1,67 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+constexpr uint32_t ALLOCATION_TRACKER_MAX_TAGS = 128; // tags after this are counted as untagged
+constexpr uint32_t ALLOCATION_TRACKER_MAX_TAG_DEPTH = 32;
+
+struct AllocationTagStatistics {
+	char const* m_name = nullptr;
+	uint64_t m_allocations = 0;
+	uint64_t m_bytes = 0;
+};
+
+/// Heap allocations made between two AllocationTracker::EndFrame calls, tags without allocations are left out
+struct AllocationFrameStatistics {
+	uint64_t m_allocations = 0;
+	uint64_t m_bytes = 0;
+	uint64_t m_frees = 0;
+	uint32_t m_tagCount = 0;
+	std::array<AllocationTagStatistics, ALLOCATION_TRACKER_MAX_TAGS> m_tags = {};
+};
+
+/// Most allocations (and bytes) a steady state frame may make, a budget of zero allocations means allocation free frames
+struct AllocationBudget {
+	uint64_t m_maxAllocations = UINT64_MAX;
+	uint64_t m_maxBytes = UINT64_MAX;
+
+	bool IsExceededBy( AllocationFrameStatistics const& frame ) const;
+};
+
+/// Counts every global operator new and delete, allocations are attributed to the innermost ALLOCATION_TAG_SCOPE of the calling thread
+/// Counting is lock free and never allocates, tag names must be static strings
+/// Define NO_ALLOCATION_TRACKER to keep the default operator new and compile the ALLOCATION_* macros out
+class AllocationTracker {
+public:
+	/// called by App::EndFrame, the statistics of the frame are available in GetLastFrame afterwards
+	static void EndFrame();
+	static AllocationFrameStatistics const& GetLastFrame();
+	/// print the totals and the tags sorted by allocation count
+	static void PrintFrame( AllocationFrameStatistics const& frame, char const* title );
+
+	static void PushTag( char const* name );
+	static void PopTag();
+
+	/// used by the global operator new and delete
+	static void RecordAllocation( size_t size );
+	static void RecordFree();
+};
+
+/// RAII tag, use ALLOCATION_TAG_SCOPE instead of declaring it directly
+class AllocationTagScope {
+public:
+	explicit AllocationTagScope( char const* name ) { AllocationTracker::PushTag( name ); }
+	~AllocationTagScope() { AllocationTracker::PopTag(); }
+	AllocationTagScope( AllocationTagScope const& scope ) = delete;
+};
+
+#ifdef NO_ALLOCATION_TRACKER
+#define ALLOCATION_TAG_SCOPE(name)
+#define ALLOCATION_FRAME_END()
+#else
+#define ALLOCATION_TAG_CONCAT_INNER(a, b) a##b
+#define ALLOCATION_TAG_CONCAT(a, b) ALLOCATION_TAG_CONCAT_INNER(a, b)
+#define ALLOCATION_TAG_SCOPE(name) AllocationTagScope ALLOCATION_TAG_CONCAT( allocationTag, __LINE__ )( name )
+#define ALLOCATION_FRAME_END() AllocationTracker::EndFrame()
+#endif
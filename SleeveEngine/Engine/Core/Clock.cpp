@@ -1,5 +1,6 @@
 #include "Core/Clock.h"
 #include "Core/Time.h"
+#include "Core/HitchDetector.h"
 #include "Math/MathUtils.h"
 
 Clock::Clock()
@@ -87,17 +88,35 @@ double Clock::GetSystemMaxDeltaSeconds()
 	return s_systemClock->m_maxDeltaSeconds;
 }
 
+void Clock::SetSystemFixedDeltaSeconds( double fixedDeltaSeconds )
+{
+	s_systemClock->m_fixedDeltaSeconds = fixedDeltaSeconds;
+}
+
 Clock* Clock::GetSystemClock()
 {
 	return s_systemClock;
 }
 
+HitchDetector& Clock::GetSystemHitchDetector()
+{
+	static HitchDetector s_hitchDetector;
+	return s_hitchDetector;
+}
+
 void Clock::Tick()
 {
 	double curSeconds = GetCurrentTimeSeconds();
 	double deltaSeconds = curSeconds - m_lastFrameTimeSeconds;
 	m_lastFrameTimeSeconds = curSeconds;
+	// the first tick has no previous frame
+	if (this == s_systemClock && m_frameCount > 0) {
+		GetSystemHitchDetector().AddFrame( deltaSeconds, m_frameCount );
+	}
 	deltaSeconds = GetClamped( deltaSeconds, 0.0, m_maxDeltaSeconds );
+	if (m_fixedDeltaSeconds > 0.0) {
+		deltaSeconds = m_fixedDeltaSeconds;
+	}
 	Advance( deltaSeconds );
 }
 
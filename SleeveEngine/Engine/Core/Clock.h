@@ -2,6 +2,8 @@
 #include <cstdint>
 #include <vector>
 
+class HitchDetector;
+
 class Clock {
 public:
 	Clock();
@@ -26,7 +28,11 @@ public:
 	static void TickSystemClock();
 	static void SetSystemMaxDeltaSeconds( double maxDeltaSeconds );
 	static double GetSystemMaxDeltaSeconds();
+	/// advance the system clock by a fixed step each tick instead of the real time, 0 to use the real time again
+	static void SetSystemFixedDeltaSeconds( double fixedDeltaSeconds );
 	static Clock* GetSystemClock();
+	/// every system clock tick adds its real frame time, before the max delta clamp and the fixed step
+	static HitchDetector& GetSystemHitchDetector();
 protected:
 	void Tick();
 	void Advance( double deltaSeconds );
@@ -42,6 +48,7 @@ protected:
 	double m_totalSeconds = 0.0;
 	uint64_t m_frameCount = 0;
 	double m_maxDeltaSeconds = 0.1;
+	double m_fixedDeltaSeconds = 0.0;
 	float m_timeScale = 1.f;
 	bool m_isPaused = false;
 
@@ -1,8 +1,11 @@
 #include "Core/EngineCommon.h"
 #include "Core/Clock.h"
 
-Renderer* g_theRenderer = nullptr;
+RendererInterface* g_theRenderer = nullptr;
 InputSystem* g_theInput = nullptr;
 Window* g_mainWindow = nullptr;
 ResourceManager* g_theResourceManager = nullptr;
+EntityStore* g_theEntityStore = nullptr;
+JobSystem* g_theJobSystem = nullptr;
+SceneGraph* g_theSceneGraph = nullptr;
 float TARGET_FRAME_TIME_MILLISECONDS = 1000.f / 200.f;
\ No newline at end of file
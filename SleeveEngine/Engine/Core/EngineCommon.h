@@ -1,16 +1,24 @@
 #pragma once
 
-class Renderer;
+class RendererInterface;
 class App;
 class ResourceManager;
 class Clock;
 class InputSystem;
 class Window;
+class EntityStore;
+class JobSystem;
+class SceneGraph;
 
 // global variables
-extern Renderer* g_theRenderer;
+extern RendererInterface* g_theRenderer;
 extern App* g_theApp;
 extern ResourceManager* g_theResourceManager;
 extern InputSystem* g_theInput;
 extern Window* g_mainWindow;
+/// rows of the Entity3D objects, created by the app before any entity
+extern EntityStore* g_theEntityStore;
+extern JobSystem* g_theJobSystem;
+/// parent and child transforms, UpdateEntities brings its world matrices up to date between Update and LateUpdate
+extern SceneGraph* g_theSceneGraph;
 extern float TARGET_FRAME_TIME_MILLISECONDS;
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "Core/FrameTimeHistogram.h"
+
+#include <algorithm>
+#include <bit>
+
+constexpr uint64_t FRAME_TIME_HISTOGRAM_LINEAR_LIMIT = 2 * FRAME_TIME_HISTOGRAM_SUB_BUCKETS;
+constexpr uint64_t FRAME_TIME_HISTOGRAM_MAX_VALUE = (2ull << FRAME_TIME_HISTOGRAM_MAX_EXPONENT) - 1;
+constexpr uint32_t FRAME_TIME_HISTOGRAM_SUB_BUCKET_BITS = std::bit_width( FRAME_TIME_HISTOGRAM_SUB_BUCKETS ) - 1;
+
+static_assert(std::has_single_bit( FRAME_TIME_HISTOGRAM_SUB_BUCKETS ), "Frame time histogram sub buckets must be a power of two");
+
+void FrameTimeHistogram::RecordMicroseconds( uint64_t microseconds )
+{
+	++m_counts[GetBucketIndex( microseconds )];
+	++m_count;
+	m_sumMicroseconds += microseconds;
+	m_minMicroseconds = std::min( m_minMicroseconds, microseconds );
+	m_maxMicroseconds = std::max( m_maxMicroseconds, microseconds );
+}
+
+void FrameTimeHistogram::RecordSeconds( double seconds )
+{
+	RecordMicroseconds( seconds > 0.0 ? (uint64_t)(seconds * 1000000.0 + 0.5) : 0 );
+}
+
+void FrameTimeHistogram::Reset()
+{
+	m_counts.fill( 0 );
+	m_count = 0;
+	m_sumMicroseconds = 0;
+	m_minMicroseconds = UINT64_MAX;
+	m_maxMicroseconds = 0;
+}
+
+uint64_t FrameTimeHistogram::GetCount() const
+{
+	return m_count;
+}
+
+double FrameTimeHistogram::GetPercentileMilliseconds( double percentile ) const
+{
+	if (m_count == 0) {
+		return 0.0;
+	}
+	uint64_t rank = std::max( (uint64_t)1, (uint64_t)(std::clamp( percentile, 0.0, 100.0 ) * 0.01 * (double)m_count + 0.5) );
+	uint64_t seen = 0;
+	for (uint32_t i = 0; i < FRAME_TIME_HISTOGRAM_BUCKETS; ++i) {
+		seen += m_counts[i];
+		if (seen >= rank) {
+			// the bucket bound can be above anything recorded
+			return (double)std::min( GetBucketHighestValue( i ), m_maxMicroseconds ) * 0.001;
+		}
+	}
+	return GetMaxMilliseconds();
+}
+
+double FrameTimeHistogram::GetMinMilliseconds() const
+{
+	return m_count == 0 ? 0.0 : (double)m_minMicroseconds * 0.001;
+}
+
+double FrameTimeHistogram::GetMaxMilliseconds() const
+{
+	return (double)m_maxMicroseconds * 0.001;
+}
+
+double FrameTimeHistogram::GetMeanMilliseconds() const
+{
+	return m_count == 0 ? 0.0 : (double)m_sumMicroseconds * 0.001 / (double)m_count;
+}
+
+uint32_t FrameTimeHistogram::GetBucketIndex( uint64_t microseconds )
+{
+	if (microseconds < FRAME_TIME_HISTOGRAM_LINEAR_LIMIT) {
+		return (uint32_t)microseconds;
+	}
+	microseconds = std::min( microseconds, FRAME_TIME_HISTOGRAM_MAX_VALUE );
+	// the top bits below the leading one select the sub bucket of the power of two
+	uint32_t exponent = (uint32_t)std::bit_width( microseconds ) - 1;
+	uint32_t shift = exponent - FRAME_TIME_HISTOGRAM_SUB_BUCKET_BITS;
+	uint32_t subBucket = (uint32_t)(microseconds >> shift) - FRAME_TIME_HISTOGRAM_SUB_BUCKETS;
+	return (uint32_t)FRAME_TIME_HISTOGRAM_LINEAR_LIMIT + (exponent - FRAME_TIME_HISTOGRAM_SUB_BUCKET_BITS - 1) * FRAME_TIME_HISTOGRAM_SUB_BUCKETS + subBucket;
+}
+
+uint64_t FrameTimeHistogram::GetBucketHighestValue( uint32_t index )
+{
+	if (index < FRAME_TIME_HISTOGRAM_LINEAR_LIMIT) {
+		return index;
+	}
+	uint32_t logarithmicIndex = index - (uint32_t)FRAME_TIME_HISTOGRAM_LINEAR_LIMIT;
+	uint32_t shift = logarithmicIndex / FRAME_TIME_HISTOGRAM_SUB_BUCKETS + 1;
+	uint64_t subBucket = FRAME_TIME_HISTOGRAM_SUB_BUCKETS + logarithmicIndex % FRAME_TIME_HISTOGRAM_SUB_BUCKETS;
+	return ((subBucket + 1) << shift) - 1;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+constexpr uint32_t FRAME_TIME_HISTOGRAM_SUB_BUCKETS = 64; // buckets per power of two, about 1.6% precision
+constexpr uint32_t FRAME_TIME_HISTOGRAM_MAX_EXPONENT = 35; // about 9.5 hours in microseconds, longer frames are clamped
+constexpr uint32_t FRAME_TIME_HISTOGRAM_BUCKETS = 2 * FRAME_TIME_HISTOGRAM_SUB_BUCKETS + (FRAME_TIME_HISTOGRAM_MAX_EXPONENT - 6) * FRAME_TIME_HISTOGRAM_SUB_BUCKETS;
+
+/// HDR style histogram of frame times in microseconds: exact below 128 us, then a constant relative precision per bucket
+/// Recording is a few integer ops and never allocates, percentiles return the highest value of their bucket
+class FrameTimeHistogram {
+public:
+	void RecordMicroseconds( uint64_t microseconds );
+	void RecordSeconds( double seconds );
+	void Reset();
+
+	uint64_t GetCount() const;
+	/// percentile in [0, 100]
+	double GetPercentileMilliseconds( double percentile ) const;
+	double GetMinMilliseconds() const;
+	double GetMaxMilliseconds() const;
+	double GetMeanMilliseconds() const;
+
+	static uint32_t GetBucketIndex( uint64_t microseconds );
+	static uint64_t GetBucketHighestValue( uint32_t index );
+
+protected:
+	std::array<uint64_t, FRAME_TIME_HISTOGRAM_BUCKETS> m_counts = {};
+	uint64_t m_count = 0;
+	uint64_t m_sumMicroseconds = 0;
+	uint64_t m_minMicroseconds = UINT64_MAX;
+	uint64_t m_maxMicroseconds = 0;
+};
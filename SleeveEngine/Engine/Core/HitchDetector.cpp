@@ -0,0 +1,104 @@
+#include "Core/HitchDetector.h"
+#include "Core/Profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+
+constexpr uint32_t HITCH_DETECTOR_MAX_FRAME_ZONES = 4096;
+
+// only the thread ticking the system clock logs hitches, a static keeps logging allocation free
+static ProfilerEvent s_frameZones[HITCH_DETECTOR_MAX_FRAME_ZONES];
+
+static FrameTimePercentiles GetPercentiles( FrameTimeHistogram const& histogram )
+{
+	FrameTimePercentiles percentiles;
+	percentiles.m_frames = histogram.GetCount();
+	percentiles.m_p50Milliseconds = histogram.GetPercentileMilliseconds( 50.0 );
+	percentiles.m_p95Milliseconds = histogram.GetPercentileMilliseconds( 95.0 );
+	percentiles.m_p99Milliseconds = histogram.GetPercentileMilliseconds( 99.0 );
+	percentiles.m_maxMilliseconds = histogram.GetMaxMilliseconds();
+	return percentiles;
+}
+
+void HitchDetector::AddFrame( double frameSeconds, uint64_t frameNumber )
+{
+	m_windowHistogram.RecordSeconds( frameSeconds );
+	m_totalHistogram.RecordSeconds( frameSeconds );
+	m_windowElapsedSeconds += frameSeconds;
+	if (m_windowElapsedSeconds >= m_windowSeconds) {
+		m_lastWindow = GetPercentiles( m_windowHistogram );
+		m_windowHistogram.Reset();
+		m_windowElapsedSeconds = 0.0;
+	}
+
+	if (frameSeconds > m_thresholdSeconds) {
+		++m_hitchCount;
+		if (frameSeconds > m_worstHitchSeconds) {
+			m_worstHitchSeconds = frameSeconds;
+			m_worstHitchFrame = frameNumber;
+		}
+		LogHitch( frameSeconds, frameNumber );
+	}
+}
+
+void HitchDetector::SetThresholdSeconds( double thresholdSeconds )
+{
+	m_thresholdSeconds = thresholdSeconds;
+}
+
+double HitchDetector::GetThresholdSeconds() const
+{
+	return m_thresholdSeconds;
+}
+
+void HitchDetector::SetWindowSeconds( double windowSeconds )
+{
+	m_windowSeconds = windowSeconds;
+}
+
+FrameTimePercentiles const& HitchDetector::GetLastWindow() const
+{
+	return m_lastWindow;
+}
+
+FrameTimeHistogram const& HitchDetector::GetTotalHistogram() const
+{
+	return m_totalHistogram;
+}
+
+uint64_t HitchDetector::GetHitchCount() const
+{
+	return m_hitchCount;
+}
+
+void HitchDetector::PrintSummary() const
+{
+	FrameTimePercentiles total = GetPercentiles( m_totalHistogram );
+	printf( "Frame times over %llu frames: mean %.2f ms, p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, max %.2f ms\n", total.m_frames,
+		m_totalHistogram.GetMeanMilliseconds(), total.m_p50Milliseconds, total.m_p95Milliseconds, total.m_p99Milliseconds, total.m_maxMilliseconds );
+	if (m_hitchCount == 0) {
+		printf( "No hitches over %.1f ms\n", m_thresholdSeconds * 1000.0 );
+		return;
+	}
+	printf( "%llu hitches over %.1f ms (%.3f%% of frames), worst %.2f ms in frame %llu\n", m_hitchCount, m_thresholdSeconds * 1000.0,
+		100.0 * (double)m_hitchCount / (double)std::max( (uint64_t)1, total.m_frames ), m_worstHitchSeconds * 1000.0, m_worstHitchFrame );
+}
+
+void HitchDetector::LogHitch( double frameSeconds, uint64_t frameNumber ) const
+{
+	printf( "Hitch: frame %llu took %.2f ms (threshold %.1f ms)\n", frameNumber, frameSeconds * 1000.0, m_thresholdSeconds * 1000.0 );
+	uint32_t zoneCount = Profiler::GetLastFrameZones( s_frameZones, HITCH_DETECTOR_MAX_FRAME_ZONES );
+	if (zoneCount <= 1) {
+		return;
+	}
+	// the frame zone stays first, the longest zones follow
+	uint32_t loggedCount = std::min( zoneCount - 1, HITCH_DETECTOR_MAX_LOGGED_ZONES );
+	std::partial_sort( s_frameZones + 1, s_frameZones + 1 + loggedCount, s_frameZones + zoneCount, []( ProfilerEvent const& a, ProfilerEvent const& b ) {
+		return a.m_endNanoseconds - a.m_startNanoseconds > b.m_endNanoseconds - b.m_startNanoseconds;
+		} );
+	for (uint32_t i = 1; i <= loggedCount; ++i) {
+		ProfilerEvent const& zone = s_frameZones[i];
+		int indent = std::min( (int)(zone.m_depth - 1) * 2, 20 );
+		printf( "  %*s%-*s %8.2f ms\n", indent, "", 40 - indent, zone.m_name, (double)(zone.m_endNanoseconds - zone.m_startNanoseconds) * 0.000001 );
+	}
+}
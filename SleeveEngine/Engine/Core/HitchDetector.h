@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include "Core/FrameTimeHistogram.h"
+
+constexpr double HITCH_DETECTOR_DEFAULT_THRESHOLD_SECONDS = 0.05;
+constexpr double HITCH_DETECTOR_DEFAULT_WINDOW_SECONDS = 5.0;
+constexpr uint32_t HITCH_DETECTOR_MAX_LOGGED_ZONES = 12;
+
+/// Frame time percentiles of one finished window
+struct FrameTimePercentiles {
+	uint64_t m_frames = 0;
+	double m_p50Milliseconds = 0.0;
+	double m_p95Milliseconds = 0.0;
+	double m_p99Milliseconds = 0.0;
+	double m_maxMilliseconds = 0.0;
+};
+
+/// Fed the unclamped frame times by the system clock, see Clock::GetSystemHitchDetector
+/// Keeps a histogram of the current window and one of the whole run, frames over the threshold are logged
+/// with the longest profiler zones of the frame (the profiler zones of the main thread, none with NO_PROFILER)
+class HitchDetector {
+public:
+	void AddFrame( double frameSeconds, uint64_t frameNumber );
+
+	void SetThresholdSeconds( double thresholdSeconds );
+	double GetThresholdSeconds() const;
+	void SetWindowSeconds( double windowSeconds );
+
+	/// the last finished window, empty until the first one finished
+	FrameTimePercentiles const& GetLastWindow() const;
+	FrameTimeHistogram const& GetTotalHistogram() const;
+	uint64_t GetHitchCount() const;
+
+	/// frame time percentiles and hitches of the whole run, printed by App::Exit
+	void PrintSummary() const;
+
+protected:
+	void LogHitch( double frameSeconds, uint64_t frameNumber ) const;
+
+	double m_thresholdSeconds = HITCH_DETECTOR_DEFAULT_THRESHOLD_SECONDS;
+	double m_windowSeconds = HITCH_DETECTOR_DEFAULT_WINDOW_SECONDS;
+	double m_windowElapsedSeconds = 0.0;
+	FrameTimeHistogram m_windowHistogram;
+	FrameTimeHistogram m_totalHistogram;
+	FrameTimePercentiles m_lastWindow;
+	uint64_t m_hitchCount = 0;
+	double m_worstHitchSeconds = 0.0;
+	uint64_t m_worstHitchFrame = 0;
+};
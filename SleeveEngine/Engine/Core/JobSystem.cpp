@@ -0,0 +1,254 @@
+#include "Core/JobSystem.h"
+#include "Core/Error.h"
+#include "Core/Profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+
+static thread_local uint32_t t_jobThreadIndex = 0;
+
+void JobQueue::PushBack( Job const& job )
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	if (m_count == m_jobs.size()) {
+		// grow and unwrap the ring, it stops growing once the queue saw its busiest frame
+		std::vector<Job> jobs( std::max<size_t>( 64, m_jobs.size() * 2 ) );
+		for (size_t i = 0; i < m_count; ++i) {
+			jobs[i] = m_jobs[(m_head + i) % m_jobs.size()];
+		}
+		m_jobs.swap( jobs );
+		m_head = 0;
+	}
+	m_jobs[(m_head + m_count) % m_jobs.size()] = job;
+	++m_count;
+}
+
+bool JobQueue::PopBack( Job& out_job )
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	if (m_count == 0) {
+		return false;
+	}
+	--m_count;
+	out_job = m_jobs[(m_head + m_count) % m_jobs.size()];
+	return true;
+}
+
+bool JobQueue::PopFront( Job& out_job )
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	if (m_count == 0) {
+		return false;
+	}
+	out_job = m_jobs[m_head];
+	m_head = (m_head + 1) % m_jobs.size();
+	--m_count;
+	return true;
+}
+
+JobSystem::JobSystem( int workerCount )
+{
+	if (workerCount < 0) {
+		workerCount = std::max( (int)std::thread::hardware_concurrency() - 1, 0 );
+	}
+	m_mainThreadId = std::this_thread::get_id();
+	m_queueCount = (uint32_t)workerCount + 1;
+	m_queues = new JobQueue[m_queueCount];
+	m_workers.reserve( workerCount );
+	for (uint32_t i = 1; i < m_queueCount; ++i) {
+		m_workers.emplace_back( &JobSystem::WorkerMain, this, i );
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_sleepMutex );
+		m_isQuitting = true;
+	}
+	m_wakeCondition.notify_all();
+	for (std::thread& worker : m_workers) {
+		worker.join();
+	}
+	delete[] m_queues;
+}
+
+void JobSystem::Run( Job const& job )
+{
+	if (job.m_counter) {
+		job.m_counter->m_count.fetch_add( 1 );
+	}
+	if (job.m_dependency) {
+		std::lock_guard<std::mutex> lock( m_parkedMutex );
+		// counted before the check, so a dependency finishing right now either is seen as done here or sees the parked job
+		m_parkedJobCount.fetch_add( 1 );
+		if (!job.m_dependency->IsDone()) {
+			m_parkedJobs.push_back( job );
+			return;
+		}
+		m_parkedJobCount.fetch_sub( 1 );
+	}
+	PushJob( job );
+}
+
+void JobSystem::Wait( JobCounter const& counter )
+{
+	PROFILE_SCOPE( "JobSystem::Wait" );
+	uint32_t threadIndex = GetThreadIndex();
+	while (!counter.IsDone()) {
+		Job job;
+		if (TryGetJob( threadIndex, job )) {
+			Execute( job );
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobSystem::WaitRunningMainThreadJobs( JobCounter const& counter )
+{
+	ASSERT_OR_ERROR( std::this_thread::get_id() == m_mainThreadId, "Main thread jobs must be run on the main thread" );
+	if (m_workers.empty()) {
+		Wait( counter );
+		return;
+	}
+	PROFILE_SCOPE( "JobSystem::WaitRunningMainThreadJobs" );
+	while (!counter.IsDone()) {
+		Job job;
+		if (m_mainThreadQueue.PopFront( job )) {
+			Execute( job );
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobSystem::ParallelFor( char const* name, uint32_t count, uint32_t grainSize, JobFunction function, void* data )
+{
+	grainSize = std::max( grainSize, 1u );
+	if (count <= grainSize || m_workers.empty()) {
+		// the same ranges as on the workers, without going through the queues
+		PROFILE_SCOPE( name );
+		for (uint32_t begin = 0; begin < count; begin += std::min( grainSize, count - begin )) {
+			function( data, begin, begin + std::min( grainSize, count - begin ) );
+		}
+		return;
+	}
+
+	JobCounter counter;
+	Job job;
+	job.m_name = name;
+	job.m_function = function;
+	job.m_data = data;
+	job.m_counter = &counter;
+	for (uint32_t begin = 0; begin < count; begin += grainSize) {
+		job.m_begin = begin;
+		job.m_end = begin + std::min( grainSize, count - begin );
+		Run( job );
+		if (job.m_end == count) {
+			break;
+		}
+	}
+	Wait( counter );
+}
+
+void JobSystem::RunMainThreadJobs()
+{
+	ASSERT_OR_ERROR( std::this_thread::get_id() == m_mainThreadId, "Main thread jobs must be run on the main thread" );
+	Job job;
+	while (m_mainThreadQueue.PopFront( job )) {
+		Execute( job );
+	}
+}
+
+uint32_t JobSystem::GetWorkerCount() const
+{
+	return (uint32_t)m_workers.size();
+}
+
+uint32_t JobSystem::GetThreadIndex()
+{
+	return t_jobThreadIndex;
+}
+
+void JobSystem::WorkerMain( uint32_t threadIndex )
+{
+	t_jobThreadIndex = threadIndex;
+	char name[32];
+	snprintf( name, sizeof( name ), "Job worker %u", threadIndex );
+	Profiler::SetThreadName( name );
+
+	for (;;) {
+		Job job;
+		if (TryGetJob( threadIndex, job )) {
+			Execute( job );
+			continue;
+		}
+		std::unique_lock<std::mutex> lock( m_sleepMutex );
+		if (m_isQuitting) {
+			return;
+		}
+		m_wakeCondition.wait( lock, [this]() { return m_queuedJobCount.load() > 0 || m_isQuitting; } );
+	}
+}
+
+void JobSystem::PushJob( Job const& job )
+{
+	if (job.m_thread == JobThread::MAIN) {
+		m_mainThreadQueue.PushBack( job );
+		return;
+	}
+	m_queues[GetThreadIndex()].PushBack( job );
+	m_queuedJobCount.fetch_add( 1 );
+	// taking the lock orders the count before a worker going to sleep checks it
+	{
+		std::lock_guard<std::mutex> lock( m_sleepMutex );
+	}
+	m_wakeCondition.notify_one();
+}
+
+bool JobSystem::TryGetJob( uint32_t threadIndex, Job& out_job )
+{
+	if (std::this_thread::get_id() == m_mainThreadId && m_mainThreadQueue.PopFront( out_job )) {
+		return true;
+	}
+	// newest job of the own queue first while it is still in cache, then steal the oldest of the others
+	for (uint32_t i = 0; i < m_queueCount; ++i) {
+		uint32_t queueIndex = (threadIndex + i) % m_queueCount;
+		if (i == 0 ? m_queues[queueIndex].PopBack( out_job ) : m_queues[queueIndex].PopFront( out_job )) {
+			m_queuedJobCount.fetch_sub( 1 );
+			return true;
+		}
+	}
+	return false;
+}
+
+void JobSystem::Execute( Job const& job )
+{
+	{
+		PROFILE_SCOPE( job.m_name );
+		job.m_function( job.m_data, job.m_begin, job.m_end );
+	}
+	// the counter may be gone as soon as it reached zero, it is not touched after the decrement
+	if (job.m_counter && job.m_counter->m_count.fetch_sub( 1 ) == 1 && m_parkedJobCount.load() > 0) {
+		ReleaseParkedJobs();
+	}
+}
+
+void JobSystem::ReleaseParkedJobs()
+{
+	std::lock_guard<std::mutex> lock( m_parkedMutex );
+	for (size_t i = 0; i < m_parkedJobs.size();) {
+		if (m_parkedJobs[i].m_dependency->IsDone()) {
+			PushJob( m_parkedJobs[i] );
+			m_parkedJobs[i] = m_parkedJobs.back();
+			m_parkedJobs.pop_back();
+			m_parkedJobCount.fetch_sub( 1 );
+		}
+		else {
+			++i;
+		}
+	}
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+typedef void (*JobFunction)( void* data, uint32_t begin, uint32_t end );
+
+enum class JobThread {
+	ANY,
+	/// only the main thread runs it, in RunMainThreadJobs or while it waits
+	MAIN,
+};
+
+/// Number of unfinished jobs, wait on it or let other jobs depend on it
+/// It has to outlive the jobs counting on it and the jobs depending on it
+struct JobCounter {
+	std::atomic<uint32_t> m_count = 0;
+
+	bool IsDone() const { return m_count.load() == 0; }
+};
+
+/// A function over the range [m_begin, m_end) of some data, copied into the queues so running a job never allocates
+struct Job {
+	/// static string, the profiler zone of the job
+	char const* m_name = "Job";
+	JobFunction m_function = nullptr;
+	void* m_data = nullptr;
+	uint32_t m_begin = 0;
+	uint32_t m_end = 0;
+	/// incremented by Run, decremented once the job finished
+	JobCounter* m_counter = nullptr;
+	/// the job is only queued once this counter reached zero
+	JobCounter const* m_dependency = nullptr;
+	JobThread m_thread = JobThread::ANY;
+};
+
+/// Ring buffer of jobs, the owning thread pushes and pops at the back, other threads steal from the front
+class JobQueue {
+public:
+	void PushBack( Job const& job );
+	bool PopBack( Job& out_job );
+	bool PopFront( Job& out_job );
+
+protected:
+	std::mutex m_mutex;
+	std::vector<Job> m_jobs;
+	size_t m_head = 0;
+	size_t m_count = 0;
+};
+
+/// Worker threads with a work stealing queue each, sized from the CPU count
+/// A thread queues jobs into its own queue and idle workers steal them, a waiting thread runs jobs instead of blocking
+/// Every job is a profiler zone on the thread that ran it
+class JobSystem {
+public:
+	/// workerCount < 0 starts one worker less than the hardware threads, since the main thread runs jobs while it waits
+	explicit JobSystem( int workerCount = -1 );
+	JobSystem( JobSystem const& jobSystem ) = delete;
+	~JobSystem();
+
+	void Run( Job const& job );
+	/// run jobs on the calling thread until the counter reached zero
+	void Wait( JobCounter const& counter );
+	/// like Wait on the main thread, but it only runs main thread jobs and leaves the rest to the workers,
+	/// so a main thread job is never delayed behind a long job the main thread picked up, without workers it runs every job
+	void WaitRunningMainThreadJobs( JobCounter const& counter );
+	/// split [0, count) into jobs of grainSize items and run them on the workers and the calling thread, returns once all finished
+	/// the ranges only depend on count and grainSize, so results written per index do not depend on the thread count
+	void ParallelFor( char const* name, uint32_t count, uint32_t grainSize, JobFunction function, void* data );
+	/// function( uint32_t begin, uint32_t end )
+	template<typename Function>
+	void ParallelFor( char const* name, uint32_t count, uint32_t grainSize, Function const& function );
+	/// run the main thread jobs queued so far, call it from the main thread once a frame
+	void RunMainThreadJobs();
+
+	/// worker threads, the main thread not counted
+	uint32_t GetWorkerCount() const;
+	/// 0 on the main thread and threads the job system does not know, 1 to GetWorkerCount() on the workers
+	static uint32_t GetThreadIndex();
+
+protected:
+	void WorkerMain( uint32_t threadIndex );
+	void PushJob( Job const& job );
+	bool TryGetJob( uint32_t threadIndex, Job& out_job );
+	void Execute( Job const& job );
+	/// queue the parked jobs whose dependency finished
+	void ReleaseParkedJobs();
+
+	std::thread::id m_mainThreadId;
+	std::vector<std::thread> m_workers;
+	/// one per thread, the main thread's first
+	JobQueue* m_queues = nullptr;
+	uint32_t m_queueCount = 0;
+	JobQueue m_mainThreadQueue;
+	/// jobs in m_queues, the workers sleep while it is zero
+	std::atomic<uint32_t> m_queuedJobCount = 0;
+	std::mutex m_sleepMutex;
+	std::condition_variable m_wakeCondition;
+	bool m_isQuitting = false;
+
+	std::mutex m_parkedMutex;
+	std::vector<Job> m_parkedJobs;
+	std::atomic<uint32_t> m_parkedJobCount = 0;
+};
+
+template<typename Function>
+void JobSystem::ParallelFor( char const* name, uint32_t count, uint32_t grainSize, Function const& function )
+{
+	ParallelFor( name, count, grainSize, []( void* data, uint32_t begin, uint32_t end ) {
+		(*(Function const*)data)( begin, end );
+		}, (void*)&function );
+}
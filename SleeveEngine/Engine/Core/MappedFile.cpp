@@ -0,0 +1,103 @@
+#include "Core/MappedFile.h"
+
+#include <cstdio>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open( std::string const& path )
+{
+	Close();
+#ifdef _WIN32
+	HANDLE fileHandle = CreateFileA( path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx( fileHandle, &size )) {
+		CloseHandle( fileHandle );
+		return false;
+	}
+	m_fileHandle = fileHandle;
+	m_size = (size_t)size.QuadPart;
+	m_isOpen = true;
+	// an empty file cannot be mapped, it is open with no data
+	if (m_size == 0) {
+		return true;
+	}
+	m_mappingHandle = CreateFileMappingA( fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+	if (m_mappingHandle) {
+		m_data = (unsigned char const*)MapViewOfFile( m_mappingHandle, FILE_MAP_READ, 0, 0, 0 );
+	}
+	if (!m_data) {
+		Close();
+		return false;
+	}
+	return true;
+#else
+	FILE* file = fopen( path.c_str(), "rb" );
+	if (!file) {
+		return false;
+	}
+	fseek( file, 0, SEEK_END );
+	long size = ftell( file );
+	fseek( file, 0, SEEK_SET );
+	m_buffer.resize( size > 0 ? (size_t)size : 0 );
+	size_t readSize = fread( m_buffer.data(), 1, m_buffer.size(), file );
+	fclose( file );
+	if (readSize != m_buffer.size()) {
+		m_buffer.clear();
+		return false;
+	}
+	m_data = m_buffer.data();
+	m_size = m_buffer.size();
+	m_isOpen = true;
+	return true;
+#endif
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if (m_data) {
+		UnmapViewOfFile( m_data );
+	}
+	if (m_mappingHandle) {
+		CloseHandle( m_mappingHandle );
+		m_mappingHandle = nullptr;
+	}
+	if (m_fileHandle) {
+		CloseHandle( m_fileHandle );
+		m_fileHandle = nullptr;
+	}
+#else
+	m_buffer.clear();
+	m_buffer.shrink_to_fit();
+#endif
+	m_data = nullptr;
+	m_size = 0;
+	m_isOpen = false;
+}
+
+bool MappedFile::IsOpen() const
+{
+	return m_isOpen;
+}
+
+unsigned char const* MappedFile::GetData() const
+{
+	return m_data;
+}
+
+size_t MappedFile::GetSize() const
+{
+	return m_size;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/// Read only view of a whole file, memory mapped on Windows and read into memory elsewhere
+/// The data stays valid until Close or the destructor
+class MappedFile {
+public:
+	MappedFile() = default;
+	~MappedFile();
+	MappedFile( MappedFile const& mappedFile ) = delete;
+	MappedFile& operator=( MappedFile const& mappedFile ) = delete;
+
+	/// false if the file cannot be opened, an open file is closed first
+	bool Open( std::string const& path );
+	void Close();
+
+	bool IsOpen() const;
+	unsigned char const* GetData() const;
+	size_t GetSize() const;
+
+protected:
+	bool m_isOpen = false;
+	unsigned char const* m_data = nullptr;
+	size_t m_size = 0;
+#ifdef _WIN32
+	void* m_fileHandle = nullptr;
+	void* m_mappingHandle = nullptr;
+#else
+	std::vector<unsigned char> m_buffer;
+#endif
+};
@@ -0,0 +1,211 @@
+#include "Core/Profiler.h"
+
+#ifndef NO_PROFILER
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+constexpr uint64_t PROFILER_RING_CAPACITY = 1 << 16; // events per thread, must be a power of two
+constexpr uint32_t PROFILER_MAX_ZONE_DEPTH = 64;
+
+static_assert((PROFILER_RING_CAPACITY & (PROFILER_RING_CAPACITY - 1)) == 0, "Profiler ring capacity must be a power of two");
+
+struct ProfilerThreadBuffer {
+	std::string m_name;
+	uint32_t m_index = 0;
+	/// only the owning thread writes, readers see every event before this index
+	std::atomic<uint64_t> m_writeIndex = 0;
+	std::unique_ptr<ProfilerEvent[]> m_events = std::make_unique<ProfilerEvent[]>( PROFILER_RING_CAPACITY );
+
+	// open zones, only touched by the owning thread
+	std::array<char const*, PROFILER_MAX_ZONE_DEPTH> m_openZoneNames = {};
+	std::array<int64_t, PROFILER_MAX_ZONE_DEPTH> m_openZoneStarts = {};
+	uint32_t m_depth = 0;
+	int64_t m_frameStart = -1;
+
+	void Push( char const* name, int64_t startNanoseconds, int64_t endNanoseconds, uint32_t depth )
+	{
+		uint64_t index = m_writeIndex.load( std::memory_order_relaxed );
+		ProfilerEvent& event = m_events[index & (PROFILER_RING_CAPACITY - 1)];
+		event.m_name = name;
+		event.m_startNanoseconds = startNanoseconds;
+		event.m_endNanoseconds = endNanoseconds;
+		event.m_depth = depth;
+		m_writeIndex.store( index + 1, std::memory_order_release );
+	}
+};
+
+static auto s_profilerStartTime = std::chrono::steady_clock::now();
+static std::atomic<uint64_t> s_frameNumber = 0;
+// buffers live until the program ends so events of finished threads can still be exported
+static std::mutex s_bufferMutex;
+static std::vector<std::unique_ptr<ProfilerThreadBuffer>> s_buffers;
+static thread_local ProfilerThreadBuffer* t_threadBuffer = nullptr;
+
+static ProfilerThreadBuffer* CreateBuffer( std::string const& name )
+{
+	std::lock_guard<std::mutex> lock( s_bufferMutex );
+	ProfilerThreadBuffer* buffer = s_buffers.emplace_back( std::make_unique<ProfilerThreadBuffer>() ).get();
+	buffer->m_index = (uint32_t)s_buffers.size() - 1;
+	buffer->m_name = name;
+	return buffer;
+}
+
+static ProfilerThreadBuffer* GetThreadBuffer()
+{
+	if (!t_threadBuffer) {
+		t_threadBuffer = CreateBuffer( "Thread" );
+	}
+	return t_threadBuffer;
+}
+
+int64_t Profiler::GetTimestamp()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_profilerStartTime).count();
+}
+
+void Profiler::MarkFrame()
+{
+	ProfilerThreadBuffer* buffer = GetThreadBuffer();
+	int64_t now = GetTimestamp();
+	if (buffer->m_frameStart >= 0) {
+		buffer->Push( "Frame", buffer->m_frameStart, now, 0 );
+	}
+	buffer->m_frameStart = now;
+	s_frameNumber.fetch_add( 1, std::memory_order_relaxed );
+}
+
+uint64_t Profiler::GetFrameNumber()
+{
+	return s_frameNumber.load( std::memory_order_relaxed );
+}
+
+uint32_t Profiler::GetLastFrameZones( ProfilerEvent* out_events, uint32_t maxEvents )
+{
+	ProfilerThreadBuffer* buffer = GetThreadBuffer();
+	uint64_t writeIndex = buffer->m_writeIndex.load( std::memory_order_relaxed );
+	uint64_t oldestIndex = writeIndex > PROFILER_RING_CAPACITY ? writeIndex - PROFILER_RING_CAPACITY : 0;
+	// zones are pushed when they end, so the frame's zones are right before its frame zone
+	uint64_t index = writeIndex;
+	while (index > oldestIndex && buffer->m_events[(index - 1) & (PROFILER_RING_CAPACITY - 1)].m_depth != 0) {
+		--index;
+	}
+	if (index == oldestIndex || maxEvents == 0) {
+		return 0;
+	}
+	--index;
+	ProfilerEvent const& frame = buffer->m_events[index & (PROFILER_RING_CAPACITY - 1)];
+	out_events[0] = frame;
+	uint32_t count = 1;
+	while (index > oldestIndex && count < maxEvents) {
+		--index;
+		ProfilerEvent const& event = buffer->m_events[index & (PROFILER_RING_CAPACITY - 1)];
+		if (event.m_depth == 0 || event.m_endNanoseconds < frame.m_startNanoseconds) {
+			break;
+		}
+		out_events[count++] = event;
+	}
+	return count;
+}
+
+void Profiler::SetThreadName( char const* name )
+{
+	ProfilerThreadBuffer* buffer = GetThreadBuffer();
+	std::lock_guard<std::mutex> lock( s_bufferMutex );
+	buffer->m_name = name;
+}
+
+void Profiler::BeginZone( char const* name )
+{
+	ProfilerThreadBuffer* buffer = GetThreadBuffer();
+	if (buffer->m_depth < PROFILER_MAX_ZONE_DEPTH) {
+		buffer->m_openZoneNames[buffer->m_depth] = name;
+		buffer->m_openZoneStarts[buffer->m_depth] = GetTimestamp();
+	}
+	++buffer->m_depth;
+}
+
+void Profiler::EndZone()
+{
+	ProfilerThreadBuffer* buffer = GetThreadBuffer();
+	if (buffer->m_depth == 0) {
+		return;
+	}
+	--buffer->m_depth;
+	// zones deeper than the limit are not recorded
+	if (buffer->m_depth < PROFILER_MAX_ZONE_DEPTH) {
+		buffer->Push( buffer->m_openZoneNames[buffer->m_depth], buffer->m_openZoneStarts[buffer->m_depth], GetTimestamp(), buffer->m_depth + 1 );
+	}
+}
+
+void Profiler::AddTrackZone( char const* trackName, char const* name, int64_t startNanoseconds, int64_t endNanoseconds )
+{
+	ProfilerThreadBuffer* track = nullptr;
+	{
+		std::lock_guard<std::mutex> lock( s_bufferMutex );
+		for (auto& buffer : s_buffers) {
+			if (buffer->m_name == trackName) {
+				track = buffer.get();
+				break;
+			}
+		}
+	}
+	if (!track) {
+		track = CreateBuffer( trackName );
+	}
+	// tracks have no owning thread, so writers are serialized here
+	std::lock_guard<std::mutex> lock( s_bufferMutex );
+	track->Push( name, startNanoseconds, endNanoseconds, 1 );
+}
+
+static void WriteJsonString( FILE* file, char const* string )
+{
+	fputc( '"', file );
+	for (char const* c = string; *c; ++c) {
+		if (*c == '"' || *c == '\\') {
+			fputc( '\\', file );
+		}
+		fputc( *c, file );
+	}
+	fputc( '"', file );
+}
+
+bool Profiler::WriteChromeTrace( std::string const& path )
+{
+	FILE* file = nullptr;
+	fopen_s( &file, path.c_str(), "w" );
+	if (!file) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock( s_bufferMutex );
+	fprintf( file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" );
+	bool isFirst = true;
+	for (auto const& buffer : s_buffers) {
+		fprintf( file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":", isFirst ? "" : ",\n", buffer->m_index );
+		WriteJsonString( file, buffer->m_name.c_str() );
+		fprintf( file, "}}" );
+		isFirst = false;
+
+		// events older than one ring were overwritten
+		uint64_t endIndex = buffer->m_writeIndex.load( std::memory_order_acquire );
+		uint64_t beginIndex = endIndex > PROFILER_RING_CAPACITY ? endIndex - PROFILER_RING_CAPACITY : 0;
+		for (uint64_t i = beginIndex; i < endIndex; ++i) {
+			ProfilerEvent const& event = buffer->m_events[i & (PROFILER_RING_CAPACITY - 1)];
+			fprintf( file, ",\n{\"name\":" );
+			WriteJsonString( file, event.m_name );
+			fprintf( file, ",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"depth\":%u}}", buffer->m_index,
+				event.m_startNanoseconds / 1000.0, (event.m_endNanoseconds - event.m_startNanoseconds) / 1000.0, event.m_depth );
+		}
+	}
+	fprintf( file, "\n]}\n" );
+	fclose( file );
+	return true;
+}
+
+#endif // NO_PROFILER
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+/// One finished zone, times are nanoseconds since the profiler started
+struct ProfilerEvent {
+	char const* m_name = nullptr;
+	int64_t m_startNanoseconds = 0;
+	int64_t m_endNanoseconds = 0;
+	uint32_t m_depth = 0;
+};
+
+/// Low overhead CPU profiler: every thread writes finished zones into its own ring buffer without locking,
+/// old events are overwritten when a ring is full. Zone names must be static strings
+/// Define NO_PROFILER to compile the profiler out, the Release configurations do
+#ifdef NO_PROFILER
+/// every entry point is an empty inline function and Profiler.cpp compiles to nothing, so no thread gets a ring
+class Profiler {
+public:
+	static int64_t GetTimestamp() { return 0; }
+	static void MarkFrame() {}
+	static uint64_t GetFrameNumber() { return 0; }
+	static uint32_t GetLastFrameZones( ProfilerEvent* out_events, uint32_t maxEvents ) { (void)out_events; (void)maxEvents; return 0; }
+	static void SetThreadName( char const* name ) { (void)name; }
+	static void BeginZone( char const* name ) { (void)name; }
+	static void EndZone() {}
+	static void AddTrackZone( char const* trackName, char const* name, int64_t startNanoseconds, int64_t endNanoseconds ) { (void)trackName; (void)name; (void)startNanoseconds; (void)endNanoseconds; }
+	/// nothing was recorded, there is no trace to write
+	static bool WriteChromeTrace( std::string const& path ) { (void)path; return false; }
+};
+#else
+class Profiler {
+public:
+	static int64_t GetTimestamp();
+
+	/// called by App::BeginFrame, closes the previous frame zone on the calling thread
+	static void MarkFrame();
+	static uint64_t GetFrameNumber();
+	/// copy the zones of the last finished frame of the calling thread, the frame zone itself first, returns the number copied
+	static uint32_t GetLastFrameZones( ProfilerEvent* out_events, uint32_t maxEvents );
+
+	static void SetThreadName( char const* name );
+
+	static void BeginZone( char const* name );
+	static void EndZone();
+
+	/// add an already measured zone to a named track that is not a CPU thread, e.g. GPU timings
+	static void AddTrackZone( char const* trackName, char const* name, int64_t startNanoseconds, int64_t endNanoseconds );
+
+	/// write every recorded event as Chrome trace event JSON, open it in chrome://tracing or ui.perfetto.dev
+	static bool WriteChromeTrace( std::string const& path );
+};
+#endif
+
+/// RAII zone, use PROFILE_SCOPE instead of declaring it directly
+class ProfileZone {
+public:
+	explicit ProfileZone( char const* name ) { Profiler::BeginZone( name ); }
+	~ProfileZone() { Profiler::EndZone(); }
+	ProfileZone( ProfileZone const& zone ) = delete;
+};
+
+#ifdef NO_PROFILER
+#define PROFILE_SCOPE(name)
+#define PROFILE_FUNCTION()
+#define PROFILE_FRAME_MARK()
+#else
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileZone PROFILE_CONCAT( profileZone, __LINE__ )( name )
+#define PROFILE_FUNCTION() PROFILE_SCOPE( __FUNCTION__ )
+#define PROFILE_FRAME_MARK() Profiler::MarkFrame()
+#endif
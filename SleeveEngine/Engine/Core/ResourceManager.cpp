@@ -2,6 +2,8 @@
 #include "Graphics/Renderer.h"
 #include "Graphics/Font.h"
 
+#include <stb/stb_image.h>
+
 ResourceManager::ResourceManager()
 {
 
@@ -19,13 +21,33 @@ ResourceManager::~ResourceManager()
 	for (auto& fontPair : m_fonts) {
 		delete fontPair.second;
 	}
+	for (auto& texturePair : m_preparedTextures) {
+		stbi_image_free( texturePair.second.m_pixels );
+	}
+	for (auto& shaderPair : m_preparedShaders) {
+		delete shaderPair.second;
+	}
+	for (auto& fontPair : m_preparedFonts) {
+		delete fontPair.second;
+	}
 }
 
 Texture* ResourceManager::GetOrLoadTexture( std::string const& path )
 {
+	std::lock_guard<std::mutex> lock( m_textureMutex );
 	auto iter = m_textures.find( path );
 	if (iter == m_textures.end()) {
-		Texture* newTexture = g_theRenderer->CreateTextureFromFile( path );
+		Texture* newTexture = nullptr;
+		auto preparedIter = m_preparedTextures.find( path );
+		if (preparedIter != m_preparedTextures.end()) {
+			TextureImageData const& image = preparedIter->second;
+			newTexture = g_theRenderer->CreateTextureFromBuffer( image.m_pixels, (uint64_t)image.m_width * image.m_height * 4, (uint32_t)image.m_width, (uint32_t)image.m_height );
+			stbi_image_free( image.m_pixels );
+			m_preparedTextures.erase( preparedIter );
+		}
+		else {
+			newTexture = g_theRenderer->CreateTextureFromFile( path );
+		}
 		m_textures[path] = newTexture;
 		return newTexture;
 	}
@@ -36,6 +58,7 @@ Texture* ResourceManager::GetOrLoadTexture( std::string const& path )
 
 Texture* ResourceManager::GetWhiteTexture()
 {
+	std::lock_guard<std::mutex> lock( m_textureMutex );
 	if (m_whiteTexture) {
 		return m_whiteTexture;
 	}
@@ -47,9 +70,19 @@ Texture* ResourceManager::GetWhiteTexture()
 
 Shader* ResourceManager::GetOrLoadShader( std::string const& shaderName )
 {
+	std::lock_guard<std::mutex> lock( m_shaderMutex );
 	auto iter = m_shaders.find( shaderName );
 	if (iter == m_shaders.end()) {
-		Shader* newShader = g_theRenderer->CreateShader( shaderName );
+		Shader* newShader = nullptr;
+		auto preparedIter = m_preparedShaders.find( shaderName );
+		if (preparedIter != m_preparedShaders.end()) {
+			newShader = g_theRenderer->CreateShader( *preparedIter->second );
+			delete preparedIter->second;
+			m_preparedShaders.erase( preparedIter );
+		}
+		else {
+			newShader = g_theRenderer->CreateShader( shaderName );
+		}
 		m_shaders[shaderName] = newShader;
 		return newShader;
 	}
@@ -58,11 +91,21 @@ Shader* ResourceManager::GetOrLoadShader( std::string const& shaderName )
 	}
 }
 
-Font* ResourceManager::GetOrLoadFont( std::string const& path )
+Font* ResourceManager::GetOrLoadFont( std::string const& path, FontAtlasMode atlasMode )
 {
+	std::lock_guard<std::mutex> lock( m_fontMutex );
 	auto iter = m_fonts.find( path );
 	if (iter == m_fonts.end()) {
-		Font* newFont = new Font( path );
+		Font* newFont = nullptr;
+		auto preparedIter = m_preparedFonts.find( path );
+		if (preparedIter != m_preparedFonts.end()) {
+			newFont = preparedIter->second;
+			newFont->CreateAtlasTexture();
+			m_preparedFonts.erase( preparedIter );
+		}
+		else {
+			newFont = new Font( path, true, atlasMode );
+		}
 		m_fonts[path] = newFont;
 		return newFont;
 	}
@@ -71,3 +114,59 @@ Font* ResourceManager::GetOrLoadFont( std::string const& path )
 	}
 }
 
+void ResourceManager::UpdateFonts()
+{
+	std::lock_guard<std::mutex> lock( m_fontMutex );
+	for (auto& fontPair : m_fonts) {
+		fontPair.second->UpdateGlyphCache();
+	}
+}
+
+void ResourceManager::PrepareTexture( std::string const& path )
+{
+	{
+		std::lock_guard<std::mutex> lock( m_textureMutex );
+		if (m_textures.contains( path ) || m_preparedTextures.contains( path )) {
+			return;
+		}
+	}
+
+	TextureImageData image;
+	int texChannels;
+	stbi_set_flip_vertically_on_load_thread( 1 );
+	image.m_pixels = stbi_load( path.c_str(), &image.m_width, &image.m_height, &texChannels, STBI_rgb_alpha );
+	ASSERT_OR_ERROR( image.m_pixels, "failed to load texture image!" );
+
+	std::lock_guard<std::mutex> lock( m_textureMutex );
+	m_preparedTextures[path] = image;
+}
+
+void ResourceManager::PrepareShader( std::string const& shaderName )
+{
+	{
+		std::lock_guard<std::mutex> lock( m_shaderMutex );
+		if (m_shaders.contains( shaderName ) || m_preparedShaders.contains( shaderName )) {
+			return;
+		}
+	}
+
+	ShaderSource* source = new ShaderSource( Shader::ReadShaderSource( shaderName ) );
+
+	std::lock_guard<std::mutex> lock( m_shaderMutex );
+	m_preparedShaders[shaderName] = source;
+}
+
+void ResourceManager::PrepareFont( std::string const& path, FontAtlasMode atlasMode )
+{
+	{
+		std::lock_guard<std::mutex> lock( m_fontMutex );
+		if (m_fonts.contains( path ) || m_preparedFonts.contains( path )) {
+			return;
+		}
+	}
+
+	Font* font = new Font( path, false, atlasMode );
+
+	std::lock_guard<std::mutex> lock( m_fontMutex );
+	m_preparedFonts[path] = font;
+}
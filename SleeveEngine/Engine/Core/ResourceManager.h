@@ -1,11 +1,20 @@
 #pragma once
 
 #include <map>
+#include <mutex>
 #include <string>
+#include "Graphics/Font.h"
 
 class Texture;
 class Shader;
-class Font;
+struct ShaderSource;
+
+/// decoded RGBA pixels of an image file waiting to be uploaded
+struct TextureImageData {
+	int m_width = 0;
+	int m_height = 0;
+	unsigned char* m_pixels = nullptr;
+};
 
 class ResourceManager {
 public:
@@ -14,11 +23,29 @@ public:
 	Texture* GetOrLoadTexture( std::string const& path );
 	Texture* GetWhiteTexture();
 	Shader* GetOrLoadShader( std::string const& shaderName );
-	Font* GetOrLoadFont( std::string const& path );
+	/// the atlas mode only matters for the first load of a path
+	Font* GetOrLoadFont( std::string const& path, FontAtlasMode atlasMode = FontAtlasMode::BITMAP );
+
+	/// Prepare functions only do the CPU side work (file reading, decoding, packing) and can be called from any thread,
+	/// the matching GetOrLoad function finishes the resource with the GPU work
+	void PrepareTexture( std::string const& path );
+	void PrepareShader( std::string const& shaderName );
+	void PrepareFont( std::string const& path, FontAtlasMode atlasMode = FontAtlasMode::BITMAP );
+
+	/// main thread, before the renderer's BeginFrame: copy the glyphs made since the last frame into the font atlases
+	void UpdateFonts();
 
 protected:
 	Texture* m_whiteTexture = nullptr;
 	std::map<std::string, Texture*> m_textures;
 	std::map<std::string, Shader*> m_shaders;
 	std::map<std::string, Font*> m_fonts;
-};
\ No newline at end of file
+
+	std::map<std::string, TextureImageData> m_preparedTextures;
+	std::map<std::string, ShaderSource*> m_preparedShaders;
+	std::map<std::string, Font*> m_preparedFonts;
+
+	std::mutex m_textureMutex;
+	std::mutex m_shaderMutex;
+	std::mutex m_fontMutex;
+};
@@ -1,5 +1,9 @@
 #include "Core/StringUtils.h"
 
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
 int SplitStringOnDelimiter( Strings& resultStringVector, std::string const& originalString, char delimiterToSplitOn /*= ','*/, bool removeExtraSpace /*= false */ )
 {
 	resultStringVector.clear();
@@ -31,3 +35,36 @@ int SplitStringOnDelimiter( Strings& resultStringVector, std::string const& orig
 
 	return (int)resultStringVector.size();
 }
+
+std::string_view FormatInteger( int value, char* buffer, size_t bufferSize )
+{
+	std::to_chars_result result = std::to_chars( buffer, buffer + bufferSize, value );
+	if (result.ec != std::errc()) {
+		return std::string_view();
+	}
+	return std::string_view( buffer, result.ptr - buffer );
+}
+
+FixedStringBuilder::FixedStringBuilder( char* buffer, size_t bufferSize )
+	:m_buffer( buffer ), m_bufferSize( bufferSize )
+{
+}
+
+FixedStringBuilder& FixedStringBuilder::Append( std::string_view text )
+{
+	size_t count = std::min( text.size(), m_bufferSize - m_length );
+	memcpy( m_buffer + m_length, text.data(), count );
+	m_length += count;
+	return *this;
+}
+
+FixedStringBuilder& FixedStringBuilder::Append( int value )
+{
+	m_length += FormatInteger( value, m_buffer + m_length, m_bufferSize - m_length ).size();
+	return *this;
+}
+
+std::string_view FixedStringBuilder::GetView() const
+{
+	return std::string_view( m_buffer, m_length );
+}
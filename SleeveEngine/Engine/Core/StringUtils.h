@@ -1,9 +1,28 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 
 
 typedef std::vector<std::string> Strings;
 typedef std::vector<std::wstring> WStrings;
 
-int SplitStringOnDelimiter( Strings& resultStringVector, std::string const& originalString, char delimiterToSplitOn = ',', bool removeExtraSpace = false );
\ No newline at end of file
+int SplitStringOnDelimiter( Strings& resultStringVector, std::string const& originalString, char delimiterToSplitOn = ',', bool removeExtraSpace = false );
+/// format an integer into the buffer without allocating, the view points into the buffer
+std::string_view FormatInteger( int value, char* buffer, size_t bufferSize );
+
+/// Text appended into a caller provided buffer without allocating, whatever does not fit is cut off
+class FixedStringBuilder {
+public:
+	FixedStringBuilder( char* buffer, size_t bufferSize );
+
+	FixedStringBuilder& Append( std::string_view text );
+	/// formatted in place with std::to_chars
+	FixedStringBuilder& Append( int value );
+	std::string_view GetView() const;
+
+protected:
+	char* m_buffer = nullptr;
+	size_t m_bufferSize = 0;
+	size_t m_length = 0;
+};
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "Core/TaskGraph.h"
+#include "Core/JobSystem.h"
+#include "Core/Error.h"
+#include "Core/Time.h"
+
+#include <algorithm>
+#include <cstdio>
+
+TaskHandle TaskGraph::AddTask( char const* name, std::function<void()> const& work, std::vector<TaskHandle> const& dependencies, TaskThread thread )
+{
+	TaskHandle handle = (TaskHandle)m_tasks.size();
+	Task& task = m_tasks.emplace_back();
+	task.m_name = name;
+	task.m_work = work;
+	task.m_thread = thread;
+	for (TaskHandle dependency : dependencies) {
+		// dependencies must be added before, so the graph can never contain a cycle
+		ASSERT_OR_ERROR( dependency >= 0 && dependency < handle, "Task dependency must be added before the task depending on it" );
+		m_tasks[dependency].m_dependents.push_back( handle );
+		++task.m_numOfUnfinishedDependencies;
+	}
+	return handle;
+}
+
+void TaskGraph::Execute( JobSystem& jobSystem )
+{
+	int numOfTasks = (int)m_tasks.size();
+	JobCounter counter;
+	m_jobSystem = &jobSystem;
+	m_counter = &counter;
+	m_unfinishedDependencies.resize( numOfTasks );
+	for (TaskHandle i = 0; i < numOfTasks; ++i) {
+		m_unfinishedDependencies[i] = m_tasks[i].m_numOfUnfinishedDependencies;
+	}
+	m_timeline.clear();
+	m_timeline.resize( numOfTasks );
+	m_startSeconds = GetCurrentTimeSeconds();
+
+	// the rest is queued by the tasks they depend on, a finishing task queues its dependents before it stops counting, so the counter only reaches zero at the end
+	for (TaskHandle i = 0; i < numOfTasks; ++i) {
+		if (m_tasks[i].m_numOfUnfinishedDependencies == 0) {
+			QueueTask( i );
+		}
+	}
+	// the main thread only runs the main thread tasks, so window, device and font upload never wait behind a worker task
+	jobSystem.WaitRunningMainThreadJobs( counter );
+
+	m_endSeconds = GetCurrentTimeSeconds();
+	m_jobSystem = nullptr;
+	m_counter = nullptr;
+}
+
+void TaskGraph::QueueTask( TaskHandle handle )
+{
+	Job job;
+	job.m_name = m_tasks[handle].m_name;
+	job.m_function = &TaskGraph::RunTaskJob;
+	job.m_data = this;
+	job.m_begin = (uint32_t)handle;
+	job.m_end = (uint32_t)handle + 1;
+	job.m_counter = m_counter;
+	job.m_thread = m_tasks[handle].m_thread == TaskThread::MAIN ? JobThread::MAIN : JobThread::ANY;
+	m_jobSystem->Run( job );
+}
+
+void TaskGraph::RunTaskJob( void* data, uint32_t begin, uint32_t end )
+{
+	TaskGraph* graph = (TaskGraph*)data;
+	TaskHandle handle = (TaskHandle)begin;
+	Task const& task = graph->m_tasks[handle];
+	double startSeconds = GetCurrentTimeSeconds();
+	task.m_work();
+	double endSeconds = GetCurrentTimeSeconds();
+
+	std::lock_guard<std::mutex> lock( graph->m_mutex );
+	graph->m_timeline[handle] = TaskTiming{ task.m_name, startSeconds - graph->m_startSeconds, endSeconds - graph->m_startSeconds, (int)JobSystem::GetThreadIndex() };
+	for (TaskHandle dependent : task.m_dependents) {
+		if (--graph->m_unfinishedDependencies[dependent] == 0) {
+			graph->QueueTask( dependent );
+		}
+	}
+}
+
+std::vector<TaskTiming> const& TaskGraph::GetTimeline() const
+{
+	return m_timeline;
+}
+
+double TaskGraph::GetTotalSeconds() const
+{
+	return m_endSeconds - m_startSeconds;
+}
+
+void TaskGraph::PrintTimeline( char const* title ) const
+{
+	constexpr int barWidth = 40;
+	double totalSeconds = std::max( GetTotalSeconds(), 1e-9 );
+	double sumOfTaskSeconds = 0.0;
+
+	printf( "%s: %.2f ms\n", title, totalSeconds * 1000.0 );
+	for (TaskTiming const& timing : m_timeline) {
+		int barStart = (int)(timing.m_startSeconds / totalSeconds * barWidth);
+		int barEnd = std::max( barStart + 1, (int)(timing.m_endSeconds / totalSeconds * barWidth) );
+		char bar[barWidth + 1];
+		for (int i = 0; i < barWidth; ++i) {
+			bar[i] = (i >= barStart && i < barEnd) ? '#' : '.';
+		}
+		bar[barWidth] = '\0';
+		printf( "  %-24s thread %2d |%s| %8.2f ms -> %8.2f ms (%.2f ms)\n", timing.m_name.c_str(), timing.m_threadIndex, bar,
+			timing.m_startSeconds * 1000.0, timing.m_endSeconds * 1000.0, (timing.m_endSeconds - timing.m_startSeconds) * 1000.0 );
+		sumOfTaskSeconds += timing.m_endSeconds - timing.m_startSeconds;
+	}
+	printf( "  serial time %.2f ms, saved %.2f ms by overlapping\n", sumOfTaskSeconds * 1000.0, (sumOfTaskSeconds - totalSeconds) * 1000.0 );
+}
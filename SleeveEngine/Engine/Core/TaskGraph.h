@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class JobSystem;
+struct JobCounter;
+
+typedef int TaskHandle;
+
+enum class TaskThread {
+	ANY,
+	MAIN,
+};
+
+struct TaskTiming {
+	std::string m_name;
+	double m_startSeconds = 0.0;
+	double m_endSeconds = 0.0;
+	int m_threadIndex = 0;
+};
+
+/// A small dependency graph of one-shot tasks, used to overlap the independent steps of engine startup
+/// The tasks run as jobs of a JobSystem, a task is queued once its dependencies finished
+/// Tasks marked TaskThread::MAIN always run on the job system's main thread (window and device creation)
+class TaskGraph {
+public:
+	TaskGraph() = default;
+	TaskGraph( TaskGraph const& graph ) = delete;
+
+	/// name is a static string, it is the profiler zone of the task's job
+	TaskHandle AddTask( char const* name, std::function<void()> const& work, std::vector<TaskHandle> const& dependencies = {}, TaskThread thread = TaskThread::ANY );
+	/// Run every task once on the job system's threads and block until all of them finished, call it from the main thread
+	void Execute( JobSystem& jobSystem );
+
+	std::vector<TaskTiming> const& GetTimeline() const;
+	double GetTotalSeconds() const;
+	void PrintTimeline( char const* title ) const;
+
+protected:
+	struct Task {
+		char const* m_name = "";
+		std::function<void()> m_work;
+		std::vector<TaskHandle> m_dependents;
+		int m_numOfUnfinishedDependencies = 0;
+		TaskThread m_thread = TaskThread::ANY;
+	};
+
+	void QueueTask( TaskHandle handle );
+	static void RunTaskJob( void* data, uint32_t begin, uint32_t end );
+
+	std::vector<Task> m_tasks;
+	/// only valid while Execute runs
+	JobSystem* m_jobSystem = nullptr;
+	JobCounter* m_counter = nullptr;
+	/// guards the dependency counts and the timeline while the tasks run
+	std::mutex m_mutex;
+	std::vector<int> m_unfinishedDependencies;
+	std::vector<TaskTiming> m_timeline;
+	double m_startSeconds = 0.0;
+	double m_endSeconds = 0.0;
+};
@@ -1,68 +1,123 @@
 #include "Entity/Entity.h"
+#include "Entity/EntitySystems.h"
+#include "Entity/SceneGraph.h"
 #include "Graphics/Renderer.h"
+#include "Core/JobSystem.h"
+#include "Core/Profiler.h"
 #include <vector>
 #include <chrono>
 
+void UpdateEntities( std::span<EntityBase* const> entities, float deltaSeconds )
+{
+	g_theJobSystem->ParallelFor( "UpdateEntities", (uint32_t)entities.size(), ENTITY_UPDATE_GRAIN_SIZE, [entities, deltaSeconds]( uint32_t begin, uint32_t end ) {
+		for (uint32_t i = begin; i < end; ++i) {
+			entities[i]->Update( deltaSeconds );
+		}
+		} );
+	// the local matrices set during Update reach the world matrices LateUpdate uploads
+	g_theSceneGraph->UpdateWorldMatrices();
+
+	PROFILE_SCOPE( "LateUpdateEntities" );
+	for (EntityBase* entity : entities) {
+		entity->LateUpdate();
+	}
+}
+
 Entity3D::Entity3D( Vec3 const& position /*= Vec3()*/, Euler const& orientation /*= Euler() */ )
-	:m_position(position), m_orientation(orientation)
 {
-// 		AddVertsForAABB2D( m_vertices, AABB2( Vec2( 60.f, 80.f ), Vec2( 400.f, 230.f ) ), Rgba8( 255, 255, 255 ) );
-// 		m_useIndexBuffer = false;
-		m_vertices = { {Vec3{-0.5f, -0.5f, 0.0f}, Rgba8{255, 255, 255, 255}, Vec2{0.0f, 0.0f}},
-						{Vec3{0.5f, -0.5f, 0.0f}, Rgba8{255, 255, 255, 255}, Vec2{1.0f, 0.0f}},
-						{Vec3{0.5f, 0.5f, 0.0f}, Rgba8{255, 255, 255, 255}, Vec2{1.0f, 1.0f}},
-						{Vec3{-0.5f, 0.5f, 0.0f}, Rgba8{255, 255, 255, 255}, Vec2{0.0f, 1.0f}}, };
-		m_indices = { 0, 1, 2, 2, 3, 0, };
+	m_entityId = g_theEntityStore->CreateEntity( position, orientation );
 }
 
 Entity3D::~Entity3D()
 {
-	g_theRenderer->ReturnMemoryToSharedBuffer( m_vertexBufferBinding, m_indexBufferBinding, m_uniformBufferBinding );
+	g_theEntityStore->DestroyEntity( m_entityId );
 }
 
 void Entity3D::BeginPlay()
 {
-	// initialize rendering objects
-	m_vertexBufferBinding = g_theRenderer->AddVertsDataToSharedVertexBuffer( (void*)m_vertices.data(), sizeof( m_vertices[0] ) * m_vertices.size(), (uint32_t)m_vertices.size() );
-	if (m_useIndexBuffer) {
-		m_indexBufferBinding = g_theRenderer->AddIndicesDataToSharedIndexBuffer( (void*)m_indices.data(), sizeof( m_indices[0] ) * m_indices.size(), (uint32_t)m_indices.size() );
-	}
+	// initialize rendering objects, entities of the same size share one mesh
+	//Texture* texture = g_theResourceManager->GetOrLoadTexture( "Data/Textures/texture.png" );
+	Texture* texture = g_theResourceManager->GetWhiteTexture();
+	g_theEntityStore->AddRenderComponent( m_entityId, g_theEntityStore->GetQuadMesh( m_quadBounds ), g_theResourceManager->GetOrLoadShader( "shader" ), texture );
+}
+
+void Entity3D::Update( float deltaSeconds )
+{
+	//SetOrientation( Euler( GetOrientation().yaw + deltaSeconds * 90.0f, 0.f, 0.f ) );
+	UpdateModelMatrix();
+}
 
-	//m_textureBinding.m_texture = g_theResourceManager->GetOrLoadTexture( "Data/Textures/texture.png" );
-	m_textureBinding.m_texture = g_theResourceManager->GetWhiteTexture();
+void Entity3D::LateUpdate()
+{
+	UploadModelMatrix();
+}
 
-	// initialize uniform buffers
-	m_uniformBufferBinding = g_theRenderer->AddDataToSharedUniformBuffer( UNIFORM_BUFFER_USE_MODEL_CONSTANTS_BINDING_2 );
+void Entity3D::Render() const
+{
+	RenderEntity( *g_theEntityStore, g_theEntityStore->GetRow( m_entityId ) );
+}
 
-	m_shader = g_theResourceManager->GetOrLoadShader( "shader" );
+Vec3 const& Entity3D::GetPosition() const
+{
+	return g_theEntityStore->m_positions[g_theEntityStore->GetRow( m_entityId )];
 }
 
-void Entity3D::Update( float deltaSeconds )
+void Entity3D::SetPosition( Vec3 const& position )
 {
-	//m_orientation.yaw += deltaSeconds * 90.0f;
-	CalculateModelMatrix( m_modelMatrix );
+	g_theEntityStore->SetPosition( g_theEntityStore->GetRow( m_entityId ), position );
 }
 
-void Entity3D::Render() const
+Euler const& Entity3D::GetOrientation() const
 {
-	// if the current pipeline is not my shader's pipeline, bind my shader's pipeline
-	g_theRenderer->BindShader( m_shader );
-	// acquire and set the descriptor set for this specific entity
-	g_theRenderer->BeginDrawCommands( m_uniformBufferBinding, m_textureBinding );
-	// copy the ubo data to the graphics card
-	g_theRenderer->UpdateSharedModelUniformBuffer( m_uniformBufferBinding, (void*)&m_modelMatrix, sizeof( m_modelMatrix ) );
-	if (m_useIndexBuffer) {
-		// draw the entity
-		g_theRenderer->DrawIndexed( m_vertexBufferBinding, m_indexBufferBinding );
-	}
-	else {
-		// draw the entity
-		g_theRenderer->Draw( m_vertexBufferBinding );
-	}
+	return g_theEntityStore->m_orientations[g_theEntityStore->GetRow( m_entityId )];
+}
+
+void Entity3D::SetOrientation( Euler const& orientation )
+{
+	g_theEntityStore->SetOrientation( g_theEntityStore->GetRow( m_entityId ), orientation );
+}
+
+EntityId Entity3D::GetEntityId() const
+{
+	return m_entityId;
 }
 
 void Entity3D::CalculateModelMatrix( Mat44& modelMat )
 {
-	modelMat = Mat44( Vec3( 1.f, 0.f, 0.f ), Vec3( 0.f, 1.f, 0.f ), Vec3( 0.f, 0.f, 1.f ), m_position );
-	modelMat.Append( m_orientation.GetMatrix() );
+	CalculateEntityModelMatrix( GetPosition(), GetOrientation(), modelMat );
+}
+
+void Entity3D::UpdateModelMatrix()
+{
+	uint32_t row = g_theEntityStore->GetRow( m_entityId );
+	if (g_theEntityStore->IsModelMatrixOutOfDate( row )) {
+		CalculateModelMatrix( g_theEntityStore->m_modelMatrices[row] );
+		g_theEntityStore->MarkModelMatrixUpdated( row );
+	}
+}
+
+void Entity3D::UploadModelMatrix()
+{
+	// copy the ubo data to the graphics card
+	UploadEntityModelMatrix( *g_theEntityStore, g_theEntityStore->GetRow( m_entityId ) );
+}
+
+void Entity3D::MarkTransformChanged()
+{
+	g_theEntityStore->MarkTransformChanged( g_theEntityStore->GetRow( m_entityId ) );
+}
+
+Mat44& Entity3D::GetModelMatrix()
+{
+	return g_theEntityStore->m_modelMatrices[g_theEntityStore->GetRow( m_entityId )];
+}
+
+EntityRenderComponent& Entity3D::GetRenderComponent()
+{
+	return g_theEntityStore->m_renders[g_theEntityStore->GetRow( m_entityId )];
+}
+
+EntityRenderComponent const& Entity3D::GetRenderComponent() const
+{
+	return g_theEntityStore->m_renders[g_theEntityStore->GetRow( m_entityId )];
 }
@@ -1,19 +1,30 @@
 #pragma once
 #include "Core/EngineFwdMinor.h"
+#include "Entity/EntityStore.h"
+#include <span>
 #include <vector>
 
+/// entities per job of UpdateEntities, enough to pay for queueing the job
+constexpr uint32_t ENTITY_UPDATE_GRAIN_SIZE = 16;
+
 class EntityBase {
 public:
 	/// Begin play will be called right after an entity is created
 	virtual void BeginPlay() = 0;
-	/// Update will be called each frame
+	/// Update will be called each frame, on any thread when updated through UpdateEntities
+	/// only touch the entity's own state and its row of g_theEntityStore, the renderer is not thread safe
 	virtual void Update( float deltaSeconds ) = 0;
+	/// LateUpdate will be called each frame after every entity's Update, on the main thread in entity order, for the renderer uploads
+	virtual void LateUpdate() {}
 	/// Render will be called each frame
 	virtual void Render() const = 0;
-
-	bool m_useIndexBuffer = true;
 };
 
+/// Update the entities in parallel on the job system, bring g_theSceneGraph's world matrices up to date, then LateUpdate them one after another
+/// every entity only changes itself during Update, so the result does not depend on the thread count or order
+/// do not create or destroy entities of g_theEntityStore while it runs
+void UpdateEntities( std::span<EntityBase* const> entities, float deltaSeconds );
+
 class Entity2D : public EntityBase {
 public:
 	Entity2D( Vec2 const& position = Vec2(), float orientation = 0.f );
@@ -39,6 +50,8 @@ protected:
 	std::vector<uint16_t> m_indices;
 };
 
+/// Adapter for entities with behavior of their own, its transform and render data are a row of g_theEntityStore
+/// The row is reached through the id, it moves when other entities are destroyed
 class Entity3D : public EntityBase {
 public:
 	Entity3D( Vec3 const& position = Vec3(), Euler const& orientation = Euler() );
@@ -47,23 +60,30 @@ public:
 	virtual void BeginPlay() override;
 	/// Update will be called each frame
 	virtual void Update( float deltaSeconds ) override;
+	/// LateUpdate will be called each frame after every entity's Update
+	virtual void LateUpdate() override;
 	/// Render will be called each frame
 	virtual void Render() const override;
+
+	Vec3 const& GetPosition() const;
+	void SetPosition( Vec3 const& position );
+	Euler const& GetOrientation() const;
+	void SetOrientation( Euler const& orientation );
+	EntityId GetEntityId() const;
+
 protected:
 	virtual void CalculateModelMatrix( Mat44& modelMat );
+	/// CalculateModelMatrix only when the transform changed, safe to call from Update
+	void UpdateModelMatrix();
+	/// upload the model matrix to the frames in flight still holding an older one, call from LateUpdate
+	void UploadModelMatrix();
+	/// for overrides of CalculateModelMatrix reading more than the position and orientation, call when that state changes
+	void MarkTransformChanged();
+	Mat44& GetModelMatrix();
+	EntityRenderComponent& GetRenderComponent();
+	EntityRenderComponent const& GetRenderComponent() const;
 
-public:
-	// positions
-	Vec3 m_position;
-	Euler m_orientation;
-protected:
-	// render variables
-	VertexBufferBinding m_vertexBufferBinding;
-	IndexBufferBinding m_indexBufferBinding;
-	UniformBufferBinding m_uniformBufferBinding;
-	TextureBinding m_textureBinding;
-	Shader* m_shader;
-	Mat44 m_modelMatrix;
-	std::vector<VertexPCU3D> m_vertices;
-	std::vector<uint16_t> m_indices;
+	EntityId m_entityId;
+	/// bounds of the quad BeginPlay gives the entity
+	AABB2 m_quadBounds = AABB2( Vec2( -0.5f, -0.5f ), Vec2( 0.5f, 0.5f ) );
 };
\ No newline at end of file
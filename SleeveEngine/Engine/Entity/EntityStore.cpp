@@ -0,0 +1,175 @@
+#include "Entity/EntityStore.h"
+#include "Graphics/RendererInterface.h"
+#include <algorithm>
+#include <iterator>
+
+/// move the last row into the removed one, the same for every column keeps the arrays parallel
+template<typename T>
+static void RemoveRow( std::vector<T>& column, uint32_t row )
+{
+	if (row != column.size() - 1) {
+		column[row] = column.back();
+	}
+	column.pop_back();
+}
+
+EntityStore::~EntityStore()
+{
+	for (EntityRenderComponent const& render : m_renders) {
+		if (render.m_uniformBufferBinding.m_flags != 0) {
+			g_theRenderer->ReturnMemoryToSharedBuffer( render.m_uniformBufferBinding );
+		}
+	}
+	for (auto mesh : m_meshes) {
+		g_theRenderer->ReturnMemoryToSharedBuffer( mesh->m_vertexBufferBinding );
+		g_theRenderer->ReturnMemoryToSharedBuffer( mesh->m_indexBufferBinding );
+		delete mesh;
+	}
+}
+
+EntityId EntityStore::CreateEntity( Vec3 const& position /*= Vec3()*/, Euler const& orientation /*= Euler()*/ )
+{
+	EntityId id;
+	if (m_freeIndices.empty()) {
+		id.m_index = (uint32_t)m_rowOfIndex.size();
+		m_rowOfIndex.push_back( 0 );
+		m_generationOfIndex.push_back( 0 );
+	}
+	else {
+		id.m_index = m_freeIndices.back();
+		m_freeIndices.pop_back();
+	}
+	id.m_generation = m_generationOfIndex[id.m_index];
+	m_rowOfIndex[id.m_index] = (uint32_t)m_ids.size();
+
+	m_ids.push_back( id );
+	m_positions.push_back( position );
+	m_orientations.push_back( orientation );
+	m_modelMatrices.emplace_back();
+	m_renders.emplace_back();
+	m_motions.emplace_back();
+	m_transformVersions.push_back( 1 );
+	m_modelMatrixVersions.push_back( 0 );
+	m_uploadedVersions.emplace_back();
+	return id;
+}
+
+void EntityStore::DestroyEntity( EntityId id )
+{
+	ASSERT_OR_ERROR( IsAlive( id ), "Destroying an entity that is not alive" );
+	uint32_t row = m_rowOfIndex[id.m_index];
+	if (m_renders[row].m_uniformBufferBinding.m_flags != 0) {
+		g_theRenderer->ReturnMemoryToSharedBuffer( m_renders[row].m_uniformBufferBinding );
+	}
+
+	m_rowOfIndex[m_ids.back().m_index] = row;
+	RemoveRow( m_ids, row );
+	RemoveRow( m_positions, row );
+	RemoveRow( m_orientations, row );
+	RemoveRow( m_modelMatrices, row );
+	RemoveRow( m_renders, row );
+	RemoveRow( m_motions, row );
+	RemoveRow( m_transformVersions, row );
+	RemoveRow( m_modelMatrixVersions, row );
+	RemoveRow( m_uploadedVersions, row );
+
+	++m_generationOfIndex[id.m_index];
+	m_freeIndices.push_back( id.m_index );
+}
+
+bool EntityStore::IsAlive( EntityId id ) const
+{
+	return id.m_index < m_generationOfIndex.size() && m_generationOfIndex[id.m_index] == id.m_generation;
+}
+
+uint32_t EntityStore::GetRow( EntityId id ) const
+{
+	return m_rowOfIndex[id.m_index];
+}
+
+uint32_t EntityStore::GetEntityCount() const
+{
+	return (uint32_t)m_ids.size();
+}
+
+void EntityStore::AddRenderComponent( EntityId id, EntityMesh const* mesh, Shader* shader, Texture* texture )
+{
+	EntityRenderComponent& render = m_renders[GetRow( id )];
+	render.m_mesh = mesh;
+	render.m_shader = shader;
+	render.m_textureBinding.m_texture = texture;
+	if (render.m_uniformBufferBinding.m_flags == 0) {
+		render.m_uniformBufferBinding = g_theRenderer->AddDataToSharedUniformBuffer( UNIFORM_BUFFER_USE_MODEL_CONSTANTS_BINDING_2 );
+		// the new buffer holds nothing yet in any frame
+		m_uploadedVersions[GetRow( id )] = {};
+	}
+}
+
+EntityMesh const* EntityStore::GetQuadMesh( AABB2 const& bounds )
+{
+	for (auto mesh : m_meshes) {
+		if (mesh->m_quadBounds.m_mins == bounds.m_mins && mesh->m_quadBounds.m_maxs == bounds.m_maxs) {
+			return mesh;
+		}
+	}
+
+	std::vector<VertexPCU3D> vertices;
+	AddVertsForQuad2D( vertices, bounds, Rgba8( 255, 255, 255 ) );
+	uint16_t indices[] = { 0, 1, 2, 2, 3, 0, };
+	EntityMesh* mesh = new EntityMesh();
+	mesh->m_vertexBufferBinding = g_theRenderer->AddVertsDataToSharedVertexBuffer( (void*)vertices.data(), sizeof( vertices[0] ) * vertices.size(), (uint32_t)vertices.size() );
+	mesh->m_indexBufferBinding = g_theRenderer->AddIndicesDataToSharedIndexBuffer( (void*)indices, sizeof( indices ), (uint32_t)std::size( indices ) );
+	mesh->m_quadBounds = bounds;
+	m_meshes.push_back( mesh );
+	return mesh;
+}
+
+void EntityStore::SetPosition( uint32_t row, Vec3 const& position )
+{
+	if (!(m_positions[row] == position)) {
+		m_positions[row] = position;
+		MarkTransformChanged( row );
+	}
+}
+
+void EntityStore::SetOrientation( uint32_t row, Euler const& orientation )
+{
+	Euler& current = m_orientations[row];
+	if (current.yaw != orientation.yaw || current.pitch != orientation.pitch || current.roll != orientation.roll) {
+		current = orientation;
+		MarkTransformChanged( row );
+	}
+}
+
+void EntityStore::MarkTransformChanged( uint32_t row )
+{
+	++m_transformVersions[row];
+}
+
+bool EntityStore::IsModelMatrixOutOfDate( uint32_t row ) const
+{
+	return m_modelMatrixVersions[row] != m_transformVersions[row];
+}
+
+void EntityStore::MarkModelMatrixUpdated( uint32_t row )
+{
+	m_modelMatrixVersions[row] = m_transformVersions[row];
+}
+
+bool EntityStore::IsUploadOutOfDate( uint32_t row, uint32_t frameIndex ) const
+{
+	return m_uploadedVersions[row][frameIndex] != m_modelMatrixVersions[row];
+}
+
+void EntityStore::MarkUploaded( uint32_t row, uint32_t frameIndex )
+{
+	m_uploadedVersions[row][frameIndex] = m_modelMatrixVersions[row];
+}
+
+void EntityStore::CheckSharedUniformGeneration( uint32_t generation )
+{
+	if (generation != m_sharedUniformGeneration) {
+		m_sharedUniformGeneration = generation;
+		std::fill( m_uploadedVersions.begin(), m_uploadedVersions.end(), std::array<uint32_t, MAX_FRAMES_IN_FLIGHT>{} );
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include "Core/EngineFwdMinor.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+constexpr uint32_t INVALID_ENTITY_INDEX = 0xffffffff;
+
+/// Handle of an entity in an EntityStore, the generation tells it apart from a later entity reusing its index
+struct EntityId {
+	uint32_t m_index = INVALID_ENTITY_INDEX;
+	uint32_t m_generation = 0;
+
+	bool IsValid() const { return m_index != INVALID_ENTITY_INDEX; }
+};
+
+/// Vertices and indices in the renderer's shared buffers, uploaded once and drawn by every entity using them
+struct EntityMesh {
+	VertexBufferBinding m_vertexBufferBinding;
+	IndexBufferBinding m_indexBufferBinding;
+	/// bounds of the quad for meshes made by GetQuadMesh
+	AABB2 m_quadBounds;
+};
+
+/// What the render system reads to draw one entity, entities without a mesh are not drawn
+struct EntityRenderComponent {
+	EntityMesh const* m_mesh = nullptr;
+	Shader* m_shader = nullptr;
+	TextureBinding m_textureBinding = {};
+	UniformBufferBinding m_uniformBufferBinding;
+	bool m_isVisible = true;
+};
+
+/// Constant drift and turn per second, moved by UpdateEntityMotion
+struct EntityMotionComponent {
+	Vec3 m_velocity;
+	Euler m_angularVelocity;
+};
+
+/// Entities as parallel component arrays, so systems walk each array front to back instead of calling virtuals through scattered objects
+/// Live entities are packed into the first GetEntityCount() rows, destroying one moves the last entity into its row
+class EntityStore {
+public:
+	EntityStore() = default;
+	EntityStore( EntityStore const& store ) = delete;
+	~EntityStore();
+
+	EntityId CreateEntity( Vec3 const& position = Vec3(), Euler const& orientation = Euler() );
+	/// returns the entity's model uniform buffer memory to the renderer
+	void DestroyEntity( EntityId id );
+	bool IsAlive( EntityId id ) const;
+	/// row of the entity in the component arrays, only valid until the next entity is destroyed
+	uint32_t GetRow( EntityId id ) const;
+	uint32_t GetEntityCount() const;
+
+	/// give the entity a mesh to draw and a model uniform buffer of its own
+	void AddRenderComponent( EntityId id, EntityMesh const* mesh, Shader* shader, Texture* texture );
+	/// shared by every entity drawing a quad of these bounds, owned by the store
+	EntityMesh const* GetQuadMesh( AABB2 const& bounds );
+
+	/// only a different value counts as a change of the transform
+	void SetPosition( uint32_t row, Vec3 const& position );
+	void SetOrientation( uint32_t row, Euler const& orientation );
+	/// for writes straight into the arrays, and for model matrices depending on more than the position and orientation
+	void MarkTransformChanged( uint32_t row );
+	bool IsModelMatrixOutOfDate( uint32_t row ) const;
+	/// call after rebuilding m_modelMatrices[row]
+	void MarkModelMatrixUpdated( uint32_t row );
+	/// true when the uniform buffer copy of frameIndex is behind the model matrix
+	bool IsUploadOutOfDate( uint32_t row, uint32_t frameIndex ) const;
+	void MarkUploaded( uint32_t row, uint32_t frameIndex );
+	/// forget every upload once the renderer's shared uniform generation changed
+	void CheckSharedUniformGeneration( uint32_t generation );
+
+	// component arrays, indexed by row, change the transform through SetPosition and SetOrientation or call MarkTransformChanged
+	std::vector<EntityId> m_ids;
+	std::vector<Vec3> m_positions;
+	std::vector<Euler> m_orientations;
+	std::vector<Mat44> m_modelMatrices;
+	std::vector<EntityRenderComponent> m_renders;
+	std::vector<EntityMotionComponent> m_motions;
+	/// bumped by every change of the transform
+	std::vector<uint32_t> m_transformVersions;
+	/// transform version the model matrix was built from, 0 before it was built once
+	std::vector<uint32_t> m_modelMatrixVersions;
+	/// model matrix version in each frame in flight's copy of the uniform buffer, 0 for none
+	std::vector<std::array<uint32_t, MAX_FRAMES_IN_FLIGHT>> m_uploadedVersions;
+
+protected:
+	std::vector<uint32_t> m_rowOfIndex;
+	std::vector<uint32_t> m_generationOfIndex;
+	std::vector<uint32_t> m_freeIndices;
+	std::vector<EntityMesh*> m_meshes;
+	uint32_t m_sharedUniformGeneration = 0;
+};
@@ -0,0 +1,90 @@
+#include "Entity/EntitySystems.h"
+#include "Graphics/RendererInterface.h"
+#include "Core/Profiler.h"
+#include "Core/JobSystem.h"
+
+void CalculateEntityModelMatrix( Vec3 const& position, Euler const& orientation, Mat44& out_modelMatrix )
+{
+	out_modelMatrix = Mat44( Vec3( 1.f, 0.f, 0.f ), Vec3( 0.f, 1.f, 0.f ), Vec3( 0.f, 0.f, 1.f ), position );
+	out_modelMatrix.Append( orientation.GetMatrix() );
+}
+
+/// the generation of the shared uniforms was checked by the caller
+static void UploadModelMatrixOfRow( EntityStore& store, uint32_t row, uint32_t frameIndex )
+{
+	EntityRenderComponent const& render = store.m_renders[row];
+	if (render.m_isVisible && render.m_uniformBufferBinding.m_flags != 0 && store.IsUploadOutOfDate( row, frameIndex )) {
+		g_theRenderer->UpdateSharedModelUniformBuffer( render.m_uniformBufferBinding, (void*)&store.m_modelMatrices[row], sizeof( Mat44 ) );
+		store.MarkUploaded( row, frameIndex );
+	}
+}
+
+void UpdateEntityMotion( EntityStore& store, float deltaSeconds )
+{
+	PROFILE_SCOPE( "UpdateEntityMotion" );
+	g_theJobSystem->ParallelFor( "UpdateEntityMotion", store.GetEntityCount(), ENTITY_ROW_GRAIN_SIZE, [&store, deltaSeconds]( uint32_t begin, uint32_t end ) {
+		for (uint32_t row = begin; row < end; ++row) {
+			EntityMotionComponent const& motion = store.m_motions[row];
+			Euler const& angularVelocity = motion.m_angularVelocity;
+			if (motion.m_velocity == Vec3() && angularVelocity.yaw == 0.f && angularVelocity.pitch == 0.f && angularVelocity.roll == 0.f) {
+				continue;
+			}
+			Euler& orientation = store.m_orientations[row];
+			store.m_positions[row] += motion.m_velocity * deltaSeconds;
+			orientation.yaw += angularVelocity.yaw * deltaSeconds;
+			orientation.pitch += angularVelocity.pitch * deltaSeconds;
+			orientation.roll += angularVelocity.roll * deltaSeconds;
+			store.MarkTransformChanged( row );
+		}
+		} );
+}
+
+void UpdateEntityModelMatrices( EntityStore& store )
+{
+	PROFILE_SCOPE( "UpdateEntityModelMatrices" );
+	g_theJobSystem->ParallelFor( "UpdateEntityModelMatrices", store.GetEntityCount(), ENTITY_ROW_GRAIN_SIZE, [&store]( uint32_t begin, uint32_t end ) {
+		for (uint32_t row = begin; row < end; ++row) {
+			if (store.IsModelMatrixOutOfDate( row )) {
+				CalculateEntityModelMatrix( store.m_positions[row], store.m_orientations[row], store.m_modelMatrices[row] );
+				store.MarkModelMatrixUpdated( row );
+			}
+		}
+		} );
+}
+
+void UploadEntityModelMatrices( EntityStore& store )
+{
+	PROFILE_SCOPE( "UploadEntityModelMatrices" );
+	store.CheckSharedUniformGeneration( g_theRenderer->GetSharedUniformGeneration() );
+	uint32_t frameIndex = g_theRenderer->GetCurFrameNumber();
+	uint32_t count = store.GetEntityCount();
+	for (uint32_t row = 0; row < count; ++row) {
+		UploadModelMatrixOfRow( store, row, frameIndex );
+	}
+}
+
+void UploadEntityModelMatrix( EntityStore& store, uint32_t row )
+{
+	store.CheckSharedUniformGeneration( g_theRenderer->GetSharedUniformGeneration() );
+	UploadModelMatrixOfRow( store, row, g_theRenderer->GetCurFrameNumber() );
+}
+
+void RenderEntities( EntityStore const& store )
+{
+	PROFILE_SCOPE( "RenderEntities" );
+	uint32_t count = store.GetEntityCount();
+	for (uint32_t row = 0; row < count; ++row) {
+		RenderEntity( store, row );
+	}
+}
+
+void RenderEntity( EntityStore const& store, uint32_t row )
+{
+	EntityRenderComponent const& render = store.m_renders[row];
+	if (!render.m_isVisible || render.m_mesh == nullptr) {
+		return;
+	}
+	g_theRenderer->BindShader( render.m_shader );
+	g_theRenderer->BeginDrawCommands( render.m_uniformBufferBinding, render.m_textureBinding );
+	g_theRenderer->DrawIndexed( render.m_mesh->m_vertexBufferBinding, render.m_mesh->m_indexBufferBinding );
+}
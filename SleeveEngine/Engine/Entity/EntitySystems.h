@@ -0,0 +1,24 @@
+#pragma once
+#include "Entity/EntityStore.h"
+
+/// Systems run over every row of an EntityStore in array order
+/// The single row versions are what the Entity3D adapter calls for its own entity
+/// Motion and model matrices only write the row they work on, so they run in parallel on the job system; uploads and draws stay on the main thread
+
+/// rows per job of the parallel systems
+constexpr uint32_t ENTITY_ROW_GRAIN_SIZE = 1024;
+
+/// translation, then rotation
+void CalculateEntityModelMatrix( Vec3 const& position, Euler const& orientation, Mat44& out_modelMatrix );
+
+/// move and turn every entity by its motion component, entities without motion keep their transform untouched
+void UpdateEntityMotion( EntityStore& store, float deltaSeconds );
+/// rebuild the model matrices whose transform changed since they were built
+void UpdateEntityModelMatrices( EntityStore& store );
+/// copy the model matrices of the visible entities with a render component into the current frame's uniform buffers
+/// a frame in flight's copy is only written when it is behind the model matrix, so entities at rest upload nothing
+void UploadEntityModelMatrices( EntityStore& store );
+void UploadEntityModelMatrix( EntityStore& store, uint32_t row );
+/// draw every visible entity with a mesh, the renderer skips rebinding the shader while it does not change
+void RenderEntities( EntityStore const& store );
+void RenderEntity( EntityStore const& store, uint32_t row );
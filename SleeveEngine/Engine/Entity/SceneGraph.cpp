@@ -0,0 +1,139 @@
+#include "Entity/SceneGraph.h"
+#include "Core/Profiler.h"
+#include <cstring>
+
+/// out = parent * local like Mat44::Append, a column at a time so every column is four multiply-adds of 4 wide columns the compiler vectorizes
+static void MultiplyWorldMatrix( Mat44 const& parent, Mat44 const& local, Mat44& out_world )
+{
+	float const* a = parent.m_values;
+	float const* b = local.m_values;
+	float* out = out_world.m_values;
+	for (int column = 0; column < 4; ++column) {
+		float const* bColumn = b + column * 4;
+		for (int i = 0; i < 4; ++i) {
+			out[column * 4 + i] = a[i] * bColumn[0] + a[4 + i] * bColumn[1] + a[8 + i] * bColumn[2] + a[12 + i] * bColumn[3];
+		}
+	}
+}
+
+SceneNodeId SceneGraph::CreateNode( SceneNodeId parent /*= SceneNodeId()*/, Mat44 const& localMatrix /*= Mat44()*/ )
+{
+	uint32_t parentRow = INVALID_SCENE_NODE_INDEX;
+	if (parent.IsValid()) {
+		ASSERT_OR_ERROR( IsAlive( parent ), "Parent of a new scene node is not alive" );
+		parentRow = m_rowOfIndex[parent.m_index];
+	}
+
+	SceneNodeId id;
+	if (m_freeIndices.empty()) {
+		id.m_index = (uint32_t)m_rowOfIndex.size();
+		m_rowOfIndex.push_back( 0 );
+		m_generationOfIndex.push_back( 0 );
+	}
+	else {
+		id.m_index = m_freeIndices.back();
+		m_freeIndices.pop_back();
+	}
+	id.m_generation = m_generationOfIndex[id.m_index];
+	// appended after its parent, the rows stay sorted
+	m_rowOfIndex[id.m_index] = (uint32_t)m_ids.size();
+
+	m_ids.push_back( id );
+	m_parentRows.push_back( parentRow );
+	m_localMatrices.push_back( localMatrix );
+	m_worldMatrices.push_back( localMatrix );
+	m_isLocalChanged.push_back( 1 );
+	m_isWorldChanged.push_back( 0 );
+	return id;
+}
+
+void SceneGraph::DestroyNode( SceneNodeId id )
+{
+	ASSERT_OR_ERROR( IsAlive( id ), "Destroying a scene node that is not alive" );
+	uint32_t firstRow = m_rowOfIndex[id.m_index];
+	uint32_t count = GetNodeCount();
+	// the subtree only has rows after its root, a row goes when its parent went
+	m_newRowOfRow.resize( count );
+	uint32_t writeRow = firstRow;
+	for (uint32_t row = firstRow; row < count; ++row) {
+		uint32_t parentRow = m_parentRows[row];
+		if (row == firstRow || (parentRow != INVALID_SCENE_NODE_INDEX && parentRow >= firstRow && m_newRowOfRow[parentRow] == INVALID_SCENE_NODE_INDEX)) {
+			m_newRowOfRow[row] = INVALID_SCENE_NODE_INDEX;
+			++m_generationOfIndex[m_ids[row].m_index];
+			m_freeIndices.push_back( m_ids[row].m_index );
+			continue;
+		}
+
+		// move the kept rows up in order, the parents before firstRow did not move
+		m_newRowOfRow[row] = writeRow;
+		if (parentRow != INVALID_SCENE_NODE_INDEX && parentRow >= firstRow) {
+			parentRow = m_newRowOfRow[parentRow];
+		}
+		m_ids[writeRow] = m_ids[row];
+		m_parentRows[writeRow] = parentRow;
+		m_localMatrices[writeRow] = m_localMatrices[row];
+		m_worldMatrices[writeRow] = m_worldMatrices[row];
+		m_isLocalChanged[writeRow] = m_isLocalChanged[row];
+		m_isWorldChanged[writeRow] = m_isWorldChanged[row];
+		m_rowOfIndex[m_ids[writeRow].m_index] = writeRow;
+		++writeRow;
+	}
+
+	m_ids.resize( writeRow );
+	m_parentRows.resize( writeRow );
+	m_localMatrices.resize( writeRow );
+	m_worldMatrices.resize( writeRow );
+	m_isLocalChanged.resize( writeRow );
+	m_isWorldChanged.resize( writeRow );
+}
+
+bool SceneGraph::IsAlive( SceneNodeId id ) const
+{
+	return id.m_index < m_generationOfIndex.size() && m_generationOfIndex[id.m_index] == id.m_generation;
+}
+
+uint32_t SceneGraph::GetNodeCount() const
+{
+	return (uint32_t)m_ids.size();
+}
+
+void SceneGraph::SetLocalMatrix( SceneNodeId id, Mat44 const& localMatrix )
+{
+	uint32_t row = m_rowOfIndex[id.m_index];
+	if (memcmp( m_localMatrices[row].m_values, localMatrix.m_values, sizeof( localMatrix.m_values ) ) != 0) {
+		m_localMatrices[row] = localMatrix;
+		m_isLocalChanged[row] = 1;
+	}
+}
+
+Mat44 const& SceneGraph::GetLocalMatrix( SceneNodeId id ) const
+{
+	return m_localMatrices[m_rowOfIndex[id.m_index]];
+}
+
+Mat44 const& SceneGraph::GetWorldMatrix( SceneNodeId id ) const
+{
+	return m_worldMatrices[m_rowOfIndex[id.m_index]];
+}
+
+void SceneGraph::UpdateWorldMatrices()
+{
+	PROFILE_SCOPE( "SceneGraph::UpdateWorldMatrices" );
+	uint32_t count = GetNodeCount();
+	for (uint32_t row = 0; row < count; ++row) {
+		uint32_t parentRow = m_parentRows[row];
+		bool isParentChanged = parentRow != INVALID_SCENE_NODE_INDEX && m_isWorldChanged[parentRow];
+		bool isChanged = m_isLocalChanged[row] || isParentChanged;
+		m_isWorldChanged[row] = isChanged;
+		if (!isChanged) {
+			continue;
+		}
+		m_isLocalChanged[row] = 0;
+		if (parentRow == INVALID_SCENE_NODE_INDEX) {
+			m_worldMatrices[row] = m_localMatrices[row];
+		}
+		else {
+			MultiplyWorldMatrix( m_worldMatrices[parentRow], m_localMatrices[row], m_worldMatrices[row] );
+		}
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "Core/EngineFwdMinor.h"
+#include <cstdint>
+#include <vector>
+
+constexpr uint32_t INVALID_SCENE_NODE_INDEX = 0xffffffff;
+
+/// Handle of a node in a SceneGraph, the generation tells it apart from a later node reusing its index
+struct SceneNodeId {
+	uint32_t m_index = INVALID_SCENE_NODE_INDEX;
+	uint32_t m_generation = 0;
+
+	bool IsValid() const { return m_index != INVALID_SCENE_NODE_INDEX; }
+};
+
+/// Parent and child transforms as parallel arrays sorted parents before children
+/// UpdateWorldMatrices walks the rows once front to back, a parent's world matrix is final before its children read it,
+/// and only the changed nodes and the subtrees below them are multiplied again
+/// A new node goes after every existing one, so creating keeps the order, destroying a node destroys its subtree and keeps the order of the rest
+class SceneGraph {
+public:
+	SceneGraph() = default;
+	SceneGraph( SceneGraph const& sceneGraph ) = delete;
+
+	/// an invalid parent makes a root, the world matrix is there after the next UpdateWorldMatrices
+	SceneNodeId CreateNode( SceneNodeId parent = SceneNodeId(), Mat44 const& localMatrix = Mat44() );
+	/// destroys the children too
+	void DestroyNode( SceneNodeId id );
+	bool IsAlive( SceneNodeId id ) const;
+	uint32_t GetNodeCount() const;
+
+	/// only a different matrix marks the node changed, different nodes can be set from different threads
+	void SetLocalMatrix( SceneNodeId id, Mat44 const& localMatrix );
+	Mat44 const& GetLocalMatrix( SceneNodeId id ) const;
+	/// parent world * local as of the last UpdateWorldMatrices
+	Mat44 const& GetWorldMatrix( SceneNodeId id ) const;
+
+	/// one pass over the rows, rebuilding the world matrices of the changed nodes and everything below them
+	void UpdateWorldMatrices();
+
+protected:
+	std::vector<SceneNodeId> m_ids;
+	/// always smaller than the node's own row, INVALID_SCENE_NODE_INDEX for roots
+	std::vector<uint32_t> m_parentRows;
+	std::vector<Mat44> m_localMatrices;
+	std::vector<Mat44> m_worldMatrices;
+	/// bytes rather than bits, so setting the local matrices of different nodes never writes the same memory
+	std::vector<uint8_t> m_isLocalChanged;
+	/// set by UpdateWorldMatrices for the nodes it rebuilt, the children read their parent's in the same pass
+	std::vector<uint8_t> m_isWorldChanged;
+
+	std::vector<uint32_t> m_rowOfIndex;
+	std::vector<uint32_t> m_generationOfIndex;
+	std::vector<uint32_t> m_freeIndices;
+	/// new row of every old row while DestroyNode compacts the arrays
+	std::vector<uint32_t> m_newRowOfRow;
+};
@@ -0,0 +1,626 @@
+#include "Graphics/CaptureRenderer.h"
+#include "Graphics/GraphicsFwd.h"
+
+#include <cstdio>
+
+CaptureRenderer::CaptureRenderer( RendererInterface* renderer, std::string const& path, uint64_t firstFrame, uint64_t frameCount )
+	:m_renderer( renderer ), m_path( path ), m_firstFrame( firstFrame ), m_frameCount( frameCount )
+{
+}
+
+CaptureRenderer::~CaptureRenderer()
+{
+	delete m_renderer;
+}
+
+void CaptureRenderer::Initialize( RendererConfig const& config )
+{
+	m_renderer->Initialize( config );
+}
+
+void CaptureRenderer::Cleanup()
+{
+	// the app quit before the last captured frame, keep what was captured
+	if (!m_isFinished && m_frameNumber > m_firstFrame) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		WriteCapture();
+	}
+	m_isFinished = true;
+	m_renderer->Cleanup();
+}
+
+void CaptureRenderer::WaitForCleanup()
+{
+	m_renderer->WaitForCleanup();
+}
+
+void CaptureRenderer::BeginFrame()
+{
+	m_isInFrame = !m_isFinished && m_frameNumber >= m_firstFrame && m_frameNumber < m_firstFrame + m_frameCount;
+	if (m_isInFrame && m_frameNumber == m_firstFrame) {
+		++m_sharedUniformGeneration;
+	}
+	if (IsRecordingFrame()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::BEGIN_FRAME );
+		m_writer.EndCommand();
+	}
+	m_renderer->BeginFrame();
+}
+
+void CaptureRenderer::EndFrame()
+{
+	if (IsRecordingFrame()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::END_FRAME );
+		m_writer.EndCommand();
+	}
+	m_renderer->EndFrame();
+	m_isInFrame = false;
+	++m_frameNumber;
+	if (!m_isFinished && m_frameNumber >= m_firstFrame + m_frameCount) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		WriteCapture();
+		m_isFinished = true;
+	}
+}
+
+void CaptureRenderer::BeginCamera( Camera const* camera )
+{
+	if (IsRecordingFrame()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		uint32_t cameraId = GetObjectId( camera );
+		if (cameraId == 0) {
+			cameraId = AddObject( camera );
+		}
+		m_writer.BeginCommand( RendererCaptureCommand::BEGIN_CAMERA );
+		m_writer.Write( cameraId );
+		Mat44 projectionMatrix = camera->GetProjectionMatrix();
+		Mat44 viewMatrix = camera->GetViewMatrix();
+		m_writer.WriteRaw( projectionMatrix.m_values, sizeof( projectionMatrix.m_values ) );
+		m_writer.WriteRaw( viewMatrix.m_values, sizeof( viewMatrix.m_values ) );
+		m_writer.Write( (uint32_t)camera->m_cameraUniformBuffers.size() );
+		for (UniformBuffer const* buffer : camera->m_cameraUniformBuffers) {
+			m_writer.Write( GetObjectId( buffer ) );
+		}
+		m_writer.EndCommand();
+	}
+	m_renderer->BeginCamera( camera );
+}
+
+void CaptureRenderer::EndCamera( Camera const* camera )
+{
+	if (IsRecordingFrame()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::END_CAMERA );
+		m_writer.Write( GetObjectId( camera ) );
+		m_writer.EndCommand();
+	}
+	m_renderer->EndCamera( camera );
+}
+
+float CaptureRenderer::GetSwapChainExtentRatio() const
+{
+	return m_renderer->GetSwapChainExtentRatio();
+}
+
+void CaptureRenderer::DrawSingleBufferIndexed( VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, uint64_t vertexOffset, uint64_t indexOffset )
+{
+	if (IsRecordingFrame()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::DRAW_SINGLE_BUFFER_INDEXED );
+		m_writer.Write( GetObjectId( vertexBuffer ) );
+		m_writer.Write( GetObjectId( indexBuffer ) );
+		m_writer.Write( vertexOffset );
+		m_writer.Write( indexOffset );
+		m_writer.EndCommand();
+	}
+	m_renderer->DrawSingleBufferIndexed( vertexBuffer, indexBuffer, vertexOffset, indexOffset );
+}
+
+void CaptureRenderer::Draw( VertexBufferBinding const& vertexBinding )
+{
+	if (IsRecordingFrame()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		WriteDynamicVertices( vertexBinding );
+		m_writer.BeginCommand( RendererCaptureCommand::DRAW );
+		WriteVertexBinding( vertexBinding );
+		m_writer.EndCommand();
+	}
+	m_renderer->Draw( vertexBinding );
+}
+
+void CaptureRenderer::DrawQuads( VertexBufferBinding const& vertexBinding )
+{
+	if (IsRecordingFrame()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		WriteDynamicVertices( vertexBinding );
+		m_writer.BeginCommand( RendererCaptureCommand::DRAW_QUADS );
+		WriteVertexBinding( vertexBinding );
+		m_writer.EndCommand();
+	}
+	m_renderer->DrawQuads( vertexBinding );
+}
+
+void CaptureRenderer::DrawIndexed( VertexBufferBinding const& vertexBinding, IndexBufferBinding const& indexBinding )
+{
+	if (IsRecordingFrame()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		WriteDynamicVertices( vertexBinding );
+		m_writer.BeginCommand( RendererCaptureCommand::DRAW_INDEXED );
+		WriteVertexBinding( vertexBinding );
+		WriteIndexBinding( indexBinding );
+		m_writer.EndCommand();
+	}
+	m_renderer->DrawIndexed( vertexBinding, indexBinding );
+}
+
+void CaptureRenderer::BindShader( Shader* shader )
+{
+	if (IsRecordingFrame()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::BIND_SHADER );
+		m_writer.Write( GetObjectId( shader ) );
+		m_writer.EndCommand();
+	}
+	m_currentShader = shader;
+	m_renderer->BindShader( shader );
+}
+
+void CaptureRenderer::BeginDrawCommands( UniformBufferBinding const& uniformBufferBinding, TextureBinding const& textureBinding )
+{
+	if (IsRecordingFrame()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::BEGIN_DRAW_COMMANDS );
+		WriteUniformBinding( uniformBufferBinding );
+		m_writer.Write( GetObjectId( textureBinding.m_texture ) );
+		m_writer.EndCommand();
+	}
+	m_renderer->BeginDrawCommands( uniformBufferBinding, textureBinding );
+}
+
+void CaptureRenderer::UpdateUniformBuffer( UniformBuffer* uniformBuffer, void* newData, size_t dataSize )
+{
+	if (IsRecordingResources()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::UPDATE_UNIFORM_BUFFER );
+		m_writer.Write( GetObjectId( uniformBuffer ) );
+		m_writer.WriteBytes( newData, dataSize );
+		m_writer.EndCommand();
+	}
+	m_renderer->UpdateUniformBuffer( uniformBuffer, newData, dataSize );
+}
+
+void CaptureRenderer::UpdateSharedModelUniformBuffer( UniformBufferBinding const& binding, void* newData, size_t dataSize )
+{
+	if (IsRecordingFrame()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::UPDATE_SHARED_MODEL_UNIFORM );
+		WriteUniformBinding( binding );
+		m_writer.WriteBytes( newData, dataSize );
+		m_writer.EndCommand();
+	}
+	m_renderer->UpdateSharedModelUniformBuffer( binding, newData, dataSize );
+}
+
+uint32_t CaptureRenderer::GetCurFrameNumber() const
+{
+	return m_renderer->GetCurFrameNumber();
+}
+
+uint32_t CaptureRenderer::GetSharedUniformGeneration() const
+{
+	return m_renderer->GetSharedUniformGeneration() + m_sharedUniformGeneration;
+}
+
+Texture* CaptureRenderer::CreateTextureFromFile( std::string const& fileName )
+{
+	Texture* texture = m_renderer->CreateTextureFromFile( fileName );
+	if (IsRecordingResources()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::CREATE_TEXTURE_FROM_FILE );
+		m_writer.Write( AddObject( texture ) );
+		m_writer.WriteString( fileName );
+		m_writer.EndCommand();
+	}
+	return texture;
+}
+
+Texture* CaptureRenderer::CreateTextureFromBuffer( unsigned char const* buffer, uint64_t size, uint32_t width, uint32_t height )
+{
+	Texture* texture = m_renderer->CreateTextureFromBuffer( buffer, size, width, height );
+	if (IsRecordingResources()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::CREATE_TEXTURE_FROM_BUFFER );
+		m_writer.Write( AddObject( texture ) );
+		m_writer.Write( width );
+		m_writer.Write( height );
+		m_writer.WriteBytes( buffer, size );
+		m_writer.EndCommand();
+	}
+	return texture;
+}
+
+Texture* CaptureRenderer::CreateWhiteTexture()
+{
+	Texture* texture = m_renderer->CreateWhiteTexture();
+	if (IsRecordingResources()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::CREATE_WHITE_TEXTURE );
+		m_writer.Write( AddObject( texture ) );
+		m_writer.EndCommand();
+	}
+	return texture;
+}
+
+void CaptureRenderer::UpdateTextureRegion( Texture* texture, uint32_t x, uint32_t y, uint32_t width, uint32_t height, unsigned char const* pixels )
+{
+	if (IsRecordingResources()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::UPDATE_TEXTURE_REGION );
+		m_writer.Write( GetObjectId( texture ) );
+		m_writer.Write( x );
+		m_writer.Write( y );
+		m_writer.Write( width );
+		m_writer.Write( height );
+		m_writer.WriteBytes( pixels, (uint64_t)width * height * 4 );
+		m_writer.EndCommand();
+	}
+	m_renderer->UpdateTextureRegion( texture, x, y, width, height, pixels );
+}
+
+IndexBuffer* CaptureRenderer::CreateIndexBuffer( void* indexData, uint64_t size, uint32_t indexCount )
+{
+	IndexBuffer* buffer = m_renderer->CreateIndexBuffer( indexData, size, indexCount );
+	if (IsRecordingResources()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::CREATE_INDEX_BUFFER );
+		m_writer.Write( AddObject( buffer ) );
+		m_writer.Write( indexCount );
+		m_writer.WriteBytes( indexData, size );
+		m_writer.EndCommand();
+	}
+	return buffer;
+}
+
+VertexBuffer* CaptureRenderer::CreateVertexBuffer( void* vertexData, uint64_t size, uint32_t vertexCount )
+{
+	VertexBuffer* buffer = m_renderer->CreateVertexBuffer( vertexData, size, vertexCount );
+	if (IsRecordingResources()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::CREATE_VERTEX_BUFFER );
+		m_writer.Write( AddObject( buffer ) );
+		m_writer.Write( vertexCount );
+		m_writer.WriteBytes( vertexData, size );
+		m_writer.EndCommand();
+	}
+	return buffer;
+}
+
+UniformBuffer* CaptureRenderer::CreateUniformBuffer( uint64_t size )
+{
+	UniformBuffer* buffer = m_renderer->CreateUniformBuffer( size );
+	if (IsRecordingResources()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::CREATE_UNIFORM_BUFFER );
+		m_writer.Write( AddObject( buffer ) );
+		m_writer.Write( size );
+		m_writer.EndCommand();
+	}
+	return buffer;
+}
+
+Shader* CaptureRenderer::CreateShader( std::string const& fileName )
+{
+	Shader* shader = m_renderer->CreateShader( fileName );
+	if (IsRecordingResources()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::CREATE_SHADER_FROM_FILE );
+		m_writer.Write( AddObject( shader ) );
+		m_writer.WriteString( fileName );
+		m_writer.EndCommand();
+	}
+	return shader;
+}
+
+Shader* CaptureRenderer::CreateShader( ShaderSource const& source )
+{
+	Shader* shader = m_renderer->CreateShader( source );
+	if (IsRecordingResources()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::CREATE_SHADER_FROM_SOURCE );
+		m_writer.Write( AddObject( shader ) );
+		m_writer.WriteString( source.m_name );
+		m_writer.WriteBytes( source.m_vertexCode.data(), source.m_vertexCode.size() );
+		m_writer.WriteBytes( source.m_fragmentCode.data(), source.m_fragmentCode.size() );
+		m_writer.EndCommand();
+	}
+	return shader;
+}
+
+VertexBufferBinding CaptureRenderer::AddVertsDataToSharedVertexBuffer( void* vertexData, uint64_t size, uint32_t vertexCount )
+{
+	VertexBufferBinding binding = m_renderer->AddVertsDataToSharedVertexBuffer( vertexData, size, vertexCount );
+	if (IsRecordingResources()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		// the shared buffer is not created through a public call, it gets its id the first time it is returned
+		if (GetObjectId( binding.m_vertexBuffer ) == 0) {
+			AddObject( binding.m_vertexBuffer );
+		}
+		m_writer.BeginCommand( RendererCaptureCommand::ADD_SHARED_VERTICES );
+		m_writer.Write( vertexCount );
+		m_writer.WriteBytes( vertexData, size );
+		WriteVertexBinding( binding );
+		m_writer.EndCommand();
+	}
+	return binding;
+}
+
+IndexBufferBinding CaptureRenderer::AddIndicesDataToSharedIndexBuffer( void* indexData, uint64_t size, uint32_t indexCount )
+{
+	IndexBufferBinding binding = m_renderer->AddIndicesDataToSharedIndexBuffer( indexData, size, indexCount );
+	if (IsRecordingResources()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		if (GetObjectId( binding.m_indexBuffer ) == 0) {
+			AddObject( binding.m_indexBuffer );
+		}
+		m_writer.BeginCommand( RendererCaptureCommand::ADD_SHARED_INDICES );
+		m_writer.Write( indexCount );
+		m_writer.WriteBytes( indexData, size );
+		WriteIndexBinding( binding );
+		m_writer.EndCommand();
+	}
+	return binding;
+}
+
+UniformBufferBinding CaptureRenderer::AddDataToSharedUniformBuffer( UniformBufferDataBindingFlags flags )
+{
+	UniformBufferBinding binding = m_renderer->AddDataToSharedUniformBuffer( flags );
+	if (IsRecordingResources()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::ADD_SHARED_UNIFORM );
+		m_writer.Write( flags );
+		WriteUniformBinding( binding );
+		m_writer.EndCommand();
+	}
+	return binding;
+}
+
+void CaptureRenderer::ReturnMemoryToSharedBuffer( VertexBufferBinding const& vBinding, IndexBufferBinding const& iBinding, UniformBufferBinding const& uBinding )
+{
+	// recorded as the three single returns, the renderer does the same
+	ReturnMemoryToSharedBuffer( vBinding );
+	ReturnMemoryToSharedBuffer( iBinding );
+	ReturnMemoryToSharedBuffer( uBinding );
+}
+
+void CaptureRenderer::ReturnMemoryToSharedBuffer( VertexBufferBinding const& vBinding )
+{
+	if (IsRecordingResources()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::RETURN_SHARED_VERTICES );
+		WriteVertexBinding( vBinding );
+		m_writer.EndCommand();
+	}
+	m_renderer->ReturnMemoryToSharedBuffer( vBinding );
+}
+
+void CaptureRenderer::ReturnMemoryToSharedBuffer( UniformBufferBinding const& uBinding )
+{
+	if (IsRecordingResources()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::RETURN_SHARED_UNIFORM );
+		WriteUniformBinding( uBinding );
+		m_writer.EndCommand();
+	}
+	m_renderer->ReturnMemoryToSharedBuffer( uBinding );
+}
+
+void CaptureRenderer::ReturnMemoryToSharedBuffer( IndexBufferBinding const& iBinding )
+{
+	if (IsRecordingResources()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::RETURN_SHARED_INDICES );
+		WriteIndexBinding( iBinding );
+		m_writer.EndCommand();
+	}
+	m_renderer->ReturnMemoryToSharedBuffer( iBinding );
+}
+
+VertexBuffer* CaptureRenderer::CreateDynamicVertexBuffer( uint64_t size )
+{
+	VertexBuffer* buffer = m_renderer->CreateDynamicVertexBuffer( size );
+	if (IsRecordingResources()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::CREATE_DYNAMIC_VERTEX_BUFFER );
+		m_writer.Write( AddObject( buffer ) );
+		m_writer.Write( size );
+		m_writer.EndCommand();
+		m_dynamicVertexBuffers.insert( buffer );
+	}
+	return buffer;
+}
+
+TransientVertexAllocation CaptureRenderer::AllocateTransientVertices( uint32_t vertexCount, VertexFormat format )
+{
+	TransientVertexAllocation allocation = m_renderer->AllocateTransientVertices( vertexCount, format );
+	if (IsRecordingFrame()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		VertexBuffer const* buffer = allocation.m_binding.m_vertexBuffer;
+		uint32_t id = GetObjectId( buffer );
+		if (id == 0) {
+			id = AddObject( buffer );
+		}
+		m_transientVertexBuffers.insert( buffer );
+		m_writer.BeginCommand( RendererCaptureCommand::ALLOCATE_TRANSIENT_VERTICES );
+		m_writer.Write( id );
+		m_writer.Write( allocation.m_binding.m_vertexBufferOffset );
+		m_writer.Write( vertexCount );
+		m_writer.Write( format );
+		m_writer.EndCommand();
+	}
+	return allocation;
+}
+
+void CaptureRenderer::DeferredDestroyBuffer( UniformBuffer* buffer, bool isTransfer )
+{
+	if (IsRecordingResources()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::DESTROY_UNIFORM_BUFFER );
+		m_writer.Write( GetObjectId( buffer ) );
+		m_writer.Write( isTransfer );
+		m_writer.EndCommand();
+	}
+	m_renderer->DeferredDestroyBuffer( buffer, isTransfer );
+}
+
+void CaptureRenderer::DeferredDestroyBuffer( VertexBuffer* buffer, bool isTransfer )
+{
+	if (IsRecordingResources()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::DESTROY_VERTEX_BUFFER );
+		m_writer.Write( GetObjectId( buffer ) );
+		m_writer.Write( isTransfer );
+		m_writer.EndCommand();
+		m_dynamicVertexBuffers.erase( buffer );
+	}
+	m_renderer->DeferredDestroyBuffer( buffer, isTransfer );
+}
+
+void CaptureRenderer::DeferredDestroyBuffer( IndexBuffer* buffer, bool isTransfer )
+{
+	if (IsRecordingResources()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::DESTROY_INDEX_BUFFER );
+		m_writer.Write( GetObjectId( buffer ) );
+		m_writer.Write( isTransfer );
+		m_writer.EndCommand();
+	}
+	m_renderer->DeferredDestroyBuffer( buffer, isTransfer );
+}
+
+void CaptureRenderer::BeginGpuSection( char const* name )
+{
+	if (IsRecordingFrame()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::BEGIN_GPU_SECTION );
+		m_writer.WriteString( name );
+		m_writer.EndCommand();
+	}
+	m_renderer->BeginGpuSection( name );
+}
+
+void CaptureRenderer::EndGpuSection()
+{
+	if (IsRecordingFrame()) {
+		std::lock_guard<std::mutex> lock( m_recordMutex );
+		m_writer.BeginCommand( RendererCaptureCommand::END_GPU_SECTION );
+		m_writer.EndCommand();
+	}
+	m_renderer->EndGpuSection();
+}
+
+GpuFrameTimings const& CaptureRenderer::GetLastGpuFrameTimings() const
+{
+	return m_renderer->GetLastGpuFrameTimings();
+}
+
+RendererFrameStatistics const& CaptureRenderer::GetLastFrameStatistics() const
+{
+	return m_renderer->GetLastFrameStatistics();
+}
+
+RendererStatisticsHistory const& CaptureRenderer::GetFrameStatisticsHistory() const
+{
+	return m_renderer->GetFrameStatisticsHistory();
+}
+
+bool CaptureRenderer::IsHeadless() const
+{
+	return m_renderer->IsHeadless();
+}
+
+bool CaptureRenderer::ReadLastFrame( std::vector<unsigned char>& out_pixels, uint32_t& out_width, uint32_t& out_height ) const
+{
+	return m_renderer->ReadLastFrame( out_pixels, out_width, out_height );
+}
+
+RendererInterface* CaptureRenderer::GetCapturedRenderer() const
+{
+	return m_renderer;
+}
+
+bool CaptureRenderer::IsRecordingResources() const
+{
+	return !m_isFinished;
+}
+
+bool CaptureRenderer::IsRecordingFrame() const
+{
+	return m_isInFrame;
+}
+
+uint32_t CaptureRenderer::AddObject( void const* object )
+{
+	uint32_t id = m_nextObjectId++;
+	m_objectIds[object] = id;
+	return id;
+}
+
+uint32_t CaptureRenderer::GetObjectId( void const* object ) const
+{
+	auto iter = m_objectIds.find( object );
+	return iter == m_objectIds.end() ? 0 : iter->second;
+}
+
+void CaptureRenderer::WriteVertexBinding( VertexBufferBinding const& binding )
+{
+	m_writer.Write( GetObjectId( binding.m_vertexBuffer ) );
+	m_writer.Write( binding.m_vertexBufferOffset );
+	m_writer.Write( binding.m_vertexBufferVertexCount );
+}
+
+void CaptureRenderer::WriteIndexBinding( IndexBufferBinding const& binding )
+{
+	m_writer.Write( GetObjectId( binding.m_indexBuffer ) );
+	m_writer.Write( binding.m_indexBufferOffset );
+	m_writer.Write( binding.m_indexBufferIndexCount );
+}
+
+void CaptureRenderer::WriteUniformBinding( UniformBufferBinding const& binding )
+{
+	m_writer.Write( binding.m_flags );
+	m_writer.Write( binding.m_modelUniformBufferOffset );
+}
+
+void CaptureRenderer::WriteDynamicVertices( VertexBufferBinding const& binding )
+{
+	bool isWrittenByGame = m_dynamicVertexBuffers.contains( binding.m_vertexBuffer ) || m_transientVertexBuffers.contains( binding.m_vertexBuffer );
+	if (!isWrittenByGame || binding.m_vertexBufferVertexCount == 0) {
+		return;
+	}
+	// the vertices are read with the format of the bound shader's pipeline
+	uint32_t vertexSize = GetVertexSize( m_currentShader ? m_currentShader->GetVertexFormat() : VertexFormat::PCU3D );
+	uint64_t size = (uint64_t)binding.m_vertexBufferVertexCount * vertexSize;
+	m_writer.BeginCommand( RendererCaptureCommand::WRITE_DYNAMIC_VERTICES );
+	m_writer.Write( GetObjectId( binding.m_vertexBuffer ) );
+	m_writer.Write( binding.m_vertexBufferOffset );
+	m_writer.WriteBytes( (unsigned char const*)binding.m_vertexBuffer->m_mappedData + binding.m_vertexBufferOffset, size );
+	m_writer.EndCommand();
+}
+
+void CaptureRenderer::WriteCapture()
+{
+	FILE* file = nullptr;
+	fopen_s( &file, m_path.c_str(), "wb" );
+	if (!file) {
+		printf( "Cannot write renderer capture %s\n", m_path.c_str() );
+		return;
+	}
+	fwrite( RENDERER_CAPTURE_MAGIC, 1, sizeof( RENDERER_CAPTURE_MAGIC ), file );
+	fwrite( &RENDERER_CAPTURE_VERSION, sizeof( RENDERER_CAPTURE_VERSION ), 1, file );
+	fwrite( m_writer.m_data.data(), 1, m_writer.m_data.size(), file );
+	fclose( file );
+	printf( "Renderer capture of frames %llu to %llu written to %s (%llu bytes)\n", m_firstFrame, m_frameNumber - 1, m_path.c_str(), (uint64_t)m_writer.m_data.size() );
+	m_writer.m_data = std::vector<unsigned char>();
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include "Graphics/RendererInterface.h"
+#include "Graphics/RendererCaptureFormat.h"
+
+/// Forwards every call to another renderer and records the calls with their data by value, see RendererCaptureReplayer
+/// Resource calls are recorded from startup, frame calls only for the frames in [firstFrame, firstFrame + frameCount)
+/// The capture is written after the last captured frame or on Cleanup, then recording stops
+/// Dynamic vertex buffers are written by the game directly, the ranges the captured draws read are recorded before the draws
+/// Transient vertex rings are never created through the interface, they get an id the first time a captured frame allocates from them
+class CaptureRenderer : public RendererInterface {
+public:
+	/// takes ownership of the renderer
+	CaptureRenderer( RendererInterface* renderer, std::string const& path, uint64_t firstFrame, uint64_t frameCount );
+	~CaptureRenderer();
+
+	virtual void Initialize( RendererConfig const& config = RendererConfig() ) override;
+	virtual void Cleanup() override;
+	virtual void WaitForCleanup() override;
+	virtual void BeginFrame() override;
+	virtual void EndFrame() override;
+
+	virtual void BeginCamera( Camera const* camera ) override;
+	virtual void EndCamera( Camera const* camera ) override;
+
+	virtual float GetSwapChainExtentRatio() const override;
+
+	virtual void DrawSingleBufferIndexed( VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, uint64_t vertexOffset = 0, uint64_t indexOffset = 0 ) override;
+	virtual void Draw( VertexBufferBinding const& vertexBinding ) override;
+	virtual void DrawIndexed( VertexBufferBinding const& vertexBinding, IndexBufferBinding const& indexBinding ) override;
+	virtual void DrawQuads( VertexBufferBinding const& vertexBinding ) override;
+
+	virtual void BindShader( Shader* shader ) override;
+	virtual void BeginDrawCommands( UniformBufferBinding const& uniformBufferBinding, TextureBinding const& textureBinding ) override;
+
+	virtual void UpdateUniformBuffer( UniformBuffer* uniformBuffer, void* newData, size_t dataSize ) override;
+	virtual void UpdateSharedModelUniformBuffer( UniformBufferBinding const& binding, void* newData, size_t dataSize ) override;
+	virtual uint32_t GetCurFrameNumber() const override;
+	virtual uint32_t GetSharedUniformGeneration() const override;
+
+	virtual Texture* CreateTextureFromFile( std::string const& fileName ) override;
+	virtual Texture* CreateTextureFromBuffer( unsigned char const* buffer, uint64_t size, uint32_t width, uint32_t height ) override;
+	virtual Texture* CreateWhiteTexture() override;
+	virtual void UpdateTextureRegion( Texture* texture, uint32_t x, uint32_t y, uint32_t width, uint32_t height, unsigned char const* pixels ) override;
+	virtual IndexBuffer* CreateIndexBuffer( void* indexData, uint64_t size, uint32_t indexCount ) override;
+	virtual VertexBuffer* CreateVertexBuffer( void* vertexData, uint64_t size, uint32_t vertexCount ) override;
+	virtual UniformBuffer* CreateUniformBuffer( uint64_t size ) override;
+	virtual Shader* CreateShader( std::string const& fileName ) override;
+	virtual Shader* CreateShader( ShaderSource const& source ) override;
+
+	virtual VertexBufferBinding AddVertsDataToSharedVertexBuffer( void* vertexData, uint64_t size, uint32_t vertexCount ) override;
+	virtual IndexBufferBinding AddIndicesDataToSharedIndexBuffer( void* indexData, uint64_t size, uint32_t indexCount ) override;
+	virtual UniformBufferBinding AddDataToSharedUniformBuffer( UniformBufferDataBindingFlags flags ) override;
+	virtual void ReturnMemoryToSharedBuffer( VertexBufferBinding const& vBinding, IndexBufferBinding const& iBinding, UniformBufferBinding const& uBinding ) override;
+	virtual void ReturnMemoryToSharedBuffer( VertexBufferBinding const& vBinding ) override;
+	virtual void ReturnMemoryToSharedBuffer( UniformBufferBinding const& uBinding ) override;
+	virtual void ReturnMemoryToSharedBuffer( IndexBufferBinding const& iBinding ) override;
+
+	virtual VertexBuffer* CreateDynamicVertexBuffer( uint64_t size ) override;
+	virtual TransientVertexAllocation AllocateTransientVertices( uint32_t vertexCount, VertexFormat format ) override;
+
+	virtual void DeferredDestroyBuffer( UniformBuffer* buffer, bool isTransfer ) override;
+	virtual void DeferredDestroyBuffer( VertexBuffer* buffer, bool isTransfer ) override;
+	virtual void DeferredDestroyBuffer( IndexBuffer* buffer, bool isTransfer ) override;
+
+	virtual void BeginGpuSection( char const* name ) override;
+	virtual void EndGpuSection() override;
+	virtual GpuFrameTimings const& GetLastGpuFrameTimings() const override;
+	virtual RendererFrameStatistics const& GetLastFrameStatistics() const override;
+	virtual RendererStatisticsHistory const& GetFrameStatisticsHistory() const override;
+
+	virtual bool IsHeadless() const override;
+	virtual bool ReadLastFrame( std::vector<unsigned char>& out_pixels, uint32_t& out_width, uint32_t& out_height ) const override;
+
+	RendererInterface* GetCapturedRenderer() const;
+
+protected:
+	bool IsRecordingResources() const;
+	bool IsRecordingFrame() const;
+	/// give a newly created object the next id, an address can be reused after the old object was destroyed
+	uint32_t AddObject( void const* object );
+	uint32_t GetObjectId( void const* object ) const;
+	void WriteVertexBinding( VertexBufferBinding const& binding );
+	void WriteIndexBinding( IndexBufferBinding const& binding );
+	void WriteUniformBinding( UniformBufferBinding const& binding );
+	void WriteDynamicVertices( VertexBufferBinding const& binding );
+	void WriteCapture();
+
+	RendererInterface* m_renderer = nullptr;
+	std::string m_path;
+	uint64_t m_firstFrame = 0;
+	uint64_t m_frameCount = 0;
+	uint64_t m_frameNumber = 0;
+	bool m_isInFrame = false;
+	bool m_isFinished = false;
+	/// bumped when the first frame is recorded, the model uniforms written before are not in the capture
+	uint32_t m_sharedUniformGeneration = 0;
+	uint32_t m_nextObjectId = 1;
+	std::unordered_map<void const*, uint32_t> m_objectIds;
+	std::unordered_set<VertexBuffer const*> m_dynamicVertexBuffers;
+	std::unordered_set<VertexBuffer const*> m_transientVertexBuffers;
+	/// the vertex format of the dynamic vertices written with a draw
+	Shader* m_currentShader = nullptr;
+	RendererCaptureWriter m_writer;
+	/// startup tasks create resources on worker threads while the main thread records, held around every use of m_writer and the ids
+	std::mutex m_recordMutex;
+};
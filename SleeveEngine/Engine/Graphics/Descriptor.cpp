@@ -5,8 +5,8 @@
 
 constexpr uint32_t MAX_DESCRIPTOR_IN_POOL = 1024;
 
-DescriptorPools::DescriptorPools( VkDevice device, uint8_t numOfUniformBuffers, uint8_t numOfSamplers )
-	:m_device( device ), m_numOfUniformBuffers(numOfUniformBuffers), m_numOfSamplers(numOfSamplers)
+DescriptorPools::DescriptorPools( VkDevice device, Renderer* renderer, uint8_t numOfUniformBuffers, uint8_t numOfSamplers )
+	:m_device( device ), m_renderer( renderer ), m_numOfUniformBuffers(numOfUniformBuffers), m_numOfSamplers(numOfSamplers)
 {
 	m_pools.resize( MAX_FRAMES_IN_FLIGHT );
 
@@ -36,7 +36,7 @@ DescriptorPools::~DescriptorPools()
 void DescriptorPools::BeginFrame()
 {
 	// free all sets, they need to be reallocated this frame
-	for (auto pool : m_pools[g_theRenderer->m_currentFrame]) {
+	for (auto pool : m_pools[m_renderer->m_currentFrame]) {
 		vkResetDescriptorPool( m_device, pool, 0 );
 	}
 	m_curIndex = 0;
@@ -52,7 +52,7 @@ void DescriptorPools::CreateNewDescriptorPool()
 	poolInfo.maxSets = MAX_DESCRIPTOR_IN_POOL;
 	ASSERT_OR_ERROR( vkCreateDescriptorPool( m_device, &poolInfo, nullptr, &newPool ) == VK_SUCCESS, "failed to create descriptor pool!" );
 
-	m_pools[g_theRenderer->m_currentFrame].push_back( newPool );
+	m_pools[m_renderer->m_currentFrame].push_back( newPool );
 }
 
 VkDescriptorPool DescriptorPools::GetDescriptorPool( uint32_t curFrame, uint32_t index ) const
@@ -63,13 +63,13 @@ VkDescriptorPool DescriptorPools::GetDescriptorPool( uint32_t curFrame, uint32_t
 VkDescriptorSet DescriptorPools::AcquireDescriptorSet( VkDescriptorSetLayout const& layout )
 {
 	// If has no descriptor pool, a new one is needed to be created
-	if (m_pools[g_theRenderer->m_currentFrame].empty()) {
+	if (m_pools[m_renderer->m_currentFrame].empty()) {
 		CreateNewDescriptorPool();
 	}
 
 CreateDescriptorSet: // If creation is failed, return to this line
 	// Get current descriptor pool
-	VkDescriptorPool pool = GetDescriptorPool( g_theRenderer->m_currentFrame, m_curIndex );
+	VkDescriptorPool pool = GetDescriptorPool( m_renderer->m_currentFrame, m_curIndex );
 
 	VkDescriptorSetAllocateInfo allocInfo{};
 	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
@@ -83,6 +83,7 @@ CreateDescriptorSet: // If creation is failed, return to this line
 
 	// If there is enough space, return the new one
 	if (result == VK_SUCCESS) {
+		++m_renderer->m_frameStatistics.m_descriptorSetsAllocated;
 		return descriptorSet;
 	}
 	// If the pool is full, create a new pool and retry
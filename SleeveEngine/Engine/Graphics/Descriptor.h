@@ -2,10 +2,12 @@
 #include <vector>
 #include <vulkan/vulkan.h>
 
+class Renderer;
+
 class DescriptorPools {
 	friend class Renderer;
 	friend class Shader;
-	DescriptorPools( VkDevice device, uint8_t numOfUniformBuffers, uint8_t numOfSamplers );
+	DescriptorPools( VkDevice device, Renderer* renderer, uint8_t numOfUniformBuffers, uint8_t numOfSamplers );
 	~DescriptorPools();
 
 	void BeginFrame();
@@ -14,6 +16,7 @@ class DescriptorPools {
 	VkDescriptorSet AcquireDescriptorSet( VkDescriptorSetLayout const& layout );
 
 	VkDevice m_device;
+	Renderer* m_renderer = nullptr;
 	uint32_t m_curIndex = 0;
 	std::vector<std::vector<VkDescriptorPool>> m_pools;
 	std::vector<VkDescriptorPoolSize> m_poolSizes;
@@ -1,124 +1,486 @@
 ﻿#include "Graphics/Font.h"
+#include "Graphics/GlyphCache.h"
+#include "Graphics/FontAtlasCacheFormat.h"
 #include "Core/Error.h"
 #include "Graphics/PrimitiveUtils.h"
 #include "Graphics/Renderer.h"
-#include "Core/StringUtils.h"
+#include "Core/Profiler.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
 
 #define STB_TRUETYPE_IMPLEMENTATION
 #include "Thirdparty/stb/stb_truetype.h"
 
-Font::Font( std::string const& fontPath )
+constexpr size_t FONT_KERNING_MIN_SLOTS = 64;
+
+static uint32_t GetKerningKey( int first, int second )
+{
+	return ((uint32_t)first << 16) | (uint32_t)second;
+}
+
+static size_t GetKerningSlot( uint32_t key, size_t slotMask )
+{
+	return (size_t)((key * 2654435769u) >> 7) & slotMask;
+}
+
+void FontKerningTable::Add( int first, int second, float kerning )
 {
-	FILE* fontFile;
-	fopen_s( &fontFile, fontPath.c_str(), "rb" );
-	if (fontFile) {
-		fseek( fontFile, 0, SEEK_END );
-		long size = ftell( fontFile );
-		fseek( fontFile, 0, SEEK_SET );
-		m_ttfBuffer = (unsigned char*)malloc( size );
-		if (!m_ttfBuffer) {
-			THROW_ERROR( "Cannot create ttf buffer" );
+	// keep at most half of the slots used so probes stay short
+	if ((m_pairCount + 1) * 2 > m_keys.size()) {
+		Grow();
+	}
+	uint32_t key = GetKerningKey( first, second );
+	size_t slotMask = m_keys.size() - 1;
+	size_t slot = GetKerningSlot( key, slotMask );
+	while (m_keys[slot] != 0 && m_keys[slot] != key) {
+		slot = (slot + 1) & slotMask;
+	}
+	if (m_keys[slot] == 0) {
+		m_keys[slot] = key;
+		++m_pairCount;
+	}
+	m_kernings[slot] = kerning;
+}
+
+float FontKerningTable::Get( int first, int second ) const
+{
+	if (m_pairCount == 0) {
+		return 0.f;
+	}
+	uint32_t key = GetKerningKey( first, second );
+	size_t slotMask = m_keys.size() - 1;
+	for (size_t slot = GetKerningSlot( key, slotMask ); m_keys[slot] != 0; slot = (slot + 1) & slotMask) {
+		if (m_keys[slot] == key) {
+			return m_kernings[slot];
 		}
-		fread( m_ttfBuffer, size, 1, fontFile );
-		fclose( fontFile );
 	}
-	else {
-		THROW_ERROR( "Cannot find ttf file" );
+	return 0.f;
+}
+
+size_t FontKerningTable::GetPairCount() const
+{
+	return m_pairCount;
+}
+
+void FontKerningTable::Grow()
+{
+	std::vector<uint32_t> keys = std::move( m_keys );
+	std::vector<float> kernings = std::move( m_kernings );
+	m_keys.assign( std::max( FONT_KERNING_MIN_SLOTS, keys.size() * 2 ), 0 );
+	m_kernings.assign( m_keys.size(), 0.f );
+	m_pairCount = 0;
+	for (size_t i = 0; i < keys.size(); ++i) {
+		if (keys[i] != 0) {
+			Add( (int)(keys[i] >> 16), (int)(keys[i] & 0xffff), kernings[i] );
+		}
+	}
+}
+
+/// a sequence cut off by the end of the text decodes to 0, which is skipped like the other control codepoints
+static int utf8Decode( const char* s, size_t size, int* codepoint ) {
+	unsigned char* c = (unsigned char*)s;
+	if (c[0] < 0x80) {
+		*codepoint = c[0];
+		return 1;
+	}
+	else if ((c[0] & 0xE0) == 0xC0 && size >= 2) {
+		*codepoint = ((c[0] & 0x1F) << 6) | (c[1] & 0x3F);
+		return 2;
 	}
+	else if ((c[0] & 0xF0) == 0xE0 && size >= 3) {
+		*codepoint = ((c[0] & 0x0F) << 12) | ((c[1] & 0x3F) << 6) | (c[2] & 0x3F);
+		return 3;
+	}
+	else if ((c[0] & 0xF8) == 0xF0 && size >= 4) {
+		*codepoint = ((c[0] & 0x07) << 18) | ((c[1] & 0x3F) << 12) | ((c[2] & 0x3F) << 6) | (c[3] & 0x3F);
+		return 4;
+	}
+	*codepoint = 0;
+	return 1;
+}
+
+/// the first line of the text, the text is left with the lines after it, nothing is copied
+static std::string_view PopLine( std::string_view& text )
+{
+	size_t end = text.find( '\n' );
+	std::string_view line = text.substr( 0, end );
+	text = end == std::string_view::npos ? std::string_view() : text.substr( end + 1 );
+	return line;
+}
 
+/// FNV-1a, only tells font files apart for the atlas cache
+static uint64_t HashFontFile( unsigned char const* data, size_t size )
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < size; ++i) {
+		hash = (hash ^ data[i]) * 1099511628211ull;
+	}
+	return hash;
+}
+
+Font::Font( std::string const& fontPath, bool createTexture, FontAtlasMode atlasMode )
+	:m_path( fontPath ), m_atlasMode( atlasMode )
+{
+	if (!m_fontFile.Open( fontPath )) {
+		THROW_ERROR( "Cannot find ttf file" );
+	}
+	unsigned char const* fontData = m_fontFile.GetData();
 	m_fontInfo = new stbtt_fontinfo();
-	if (!stbtt_InitFont( (stbtt_fontinfo*)m_fontInfo, m_ttfBuffer, stbtt_GetFontOffsetForIndex( m_ttfBuffer, 0 ) )) {
+	if (m_fontFile.GetSize() < 12 || !stbtt_InitFont( (stbtt_fontinfo*)m_fontInfo, fontData, stbtt_GetFontOffsetForIndex( fontData, 0 ) )) {
 		THROW_ERROR( "Cannot initialize ttf font" );
 	}
+	m_unitScale = stbtt_ScaleForPixelHeight( (stbtt_fontinfo*)m_fontInfo, 1.f );
+	if (m_atlasMode == FontAtlasMode::SDF) {
+		m_fontSize = FONT_SDF_SIZE;
+		m_glyphPadding = (float)FONT_SDF_PADDING;
+	}
+	else {
+		m_fontSize = FONT_BITMAP_SIZE;
+		m_glyphPadding = 0.f;
+	}
 
-	//int ascent, descent, line_gap;
-	//stbtt_GetFontVMetrics( &font, &ascent, &descent, &line_gap );
+	uint64_t fontFileHash = HashFontFile( fontData, m_fontFile.GetSize() );
+	std::string cachePath = fontPath + (m_atlasMode == FontAtlasMode::SDF ? ".sdf" : ".bitmap") + FONT_ATLAS_CACHE_EXTENSION;
+	if (!LoadAtlasCache( cachePath, fontFileHash )) {
+		PackAtlas();
+		SaveAtlasCache( cachePath, fontFileHash );
+	}
+	m_glyphCache = std::make_unique<GlyphCache>( m_fontInfo, m_atlasMode, m_fontSize, m_atlasWidth, m_atlasHeight, m_staticAtlasWidth, m_staticAtlasHeight );
 
-	stbtt_ScaleForPixelHeight( (stbtt_fontinfo*)m_fontInfo, m_fontSize );
+	if (createTexture) {
+		CreateAtlasTexture();
+	}
+}
 
-	// Allocate a large texture (e.g., 512x512)
-	constexpr int atlasWidth = 512, atlasHeight = 512;
-	unsigned char atlas[atlasWidth * atlasHeight];
+void Font::PackAtlas()
+{
+	PROFILE_SCOPE( "Font::PackAtlas" );
+	stbtt_pack_range packRange = {};
+	std::vector<stbtt_packedchar> packedChars( FONT_GLYPH_COUNT );
+	packRange.first_unicode_codepoint_in_range = FONT_FIRST_CODEPOINT;
+	packRange.num_chars = FONT_GLYPH_COUNT;
+	packRange.chardata_for_range = packedChars.data();
+	packRange.font_size = m_fontSize;
+	m_fontPackRange = &packRange;
+	// single channel until the static glyphs are in, the glyph cache cells start out empty
+	std::vector<unsigned char> atlas( (size_t)FONT_ATLAS_SIZE * FONT_ATLAS_SIZE, 0 );
+	if (m_atlasMode == FontAtlasMode::SDF) {
+		PackSdfAtlas( atlas );
+	}
+	else {
+		PackBitmapAtlas( atlas );
+	}
+	// white with the coverage or the distance in the alpha channel
+	m_atlasWidth = FONT_ATLAS_SIZE;
+	m_atlasHeight = FONT_ATLAS_SIZE;
+	m_rgbaAtlas.assign( atlas.size() * 4, 255 );
+	for (size_t i = 0; i < atlas.size(); ++i) {
+		m_rgbaAtlas[i * 4 + 3] = atlas[i];
+	}
+
+	int advance, lsb;
+	float scale = stbtt_ScaleForPixelHeight( (stbtt_fontinfo*)m_fontInfo, m_fontSize );
+	stbtt_GetCodepointHMetrics( (stbtt_fontinfo*)m_fontInfo, ' ', &advance, &lsb );
+	m_spaceAdvance = (float)advance * scale;
+
+	BuildGlyphTables();
+	// the packed chars are only needed to build the tables
+	m_fontPackRange = nullptr;
+}
+
+bool Font::LoadAtlasCache( std::string const& cachePath, uint64_t fontFileHash )
+{
+	PROFILE_SCOPE( "Font::LoadAtlasCache" );
+	if (!m_atlasCacheFile.Open( cachePath )) {
+		return false;
+	}
+	unsigned char const* data = m_atlasCacheFile.GetData();
+	size_t size = m_atlasCacheFile.GetSize();
+	FontAtlasCacheHeader header;
+	if (size < sizeof( header )) {
+		m_atlasCacheFile.Close();
+		return false;
+	}
+	memcpy( &header, data, sizeof( header ) );
+	uint64_t kerningOffset = sizeof( header ) + sizeof( FontGlyphTable );
+	uint64_t kerningEnd = kerningOffset + (uint64_t)header.m_kerningPairCount * sizeof( FontAtlasCacheKerningPair );
+	bool isValid = memcmp( header.m_magic, FONT_ATLAS_CACHE_MAGIC, sizeof( FONT_ATLAS_CACHE_MAGIC ) ) == 0
+		&& header.m_version == FONT_ATLAS_CACHE_VERSION
+		&& header.m_atlasMode == (uint32_t)m_atlasMode
+		&& header.m_fontFileHash == fontFileHash
+		&& header.m_fontFileSize == m_fontFile.GetSize()
+		&& header.m_fontSize == m_fontSize
+		&& header.m_glyphPadding == m_glyphPadding
+		&& header.m_firstCodepoint == FONT_FIRST_CODEPOINT
+		&& header.m_glyphCount == FONT_GLYPH_COUNT
+		&& header.m_atlasWidth == FONT_ATLAS_SIZE
+		&& header.m_atlasHeight == FONT_ATLAS_SIZE
+		&& header.m_glyphTableSize == sizeof( FontGlyphTable )
+		&& header.m_pixelOffset >= kerningEnd
+		&& header.m_pixelSize == (uint64_t)FONT_ATLAS_SIZE * FONT_ATLAS_SIZE * 4
+		&& header.m_pixelOffset + header.m_pixelSize == size;
+	if (!isValid) {
+		m_atlasCacheFile.Close();
+		return false;
+	}
+
+	memcpy( &m_glyphs, data + sizeof( header ), sizeof( FontGlyphTable ) );
+	for (uint32_t i = 0; i < header.m_kerningPairCount; ++i) {
+		FontAtlasCacheKerningPair pair;
+		memcpy( &pair, data + kerningOffset + i * sizeof( FontAtlasCacheKerningPair ), sizeof( pair ) );
+		m_kerning.Add( pair.m_first, pair.m_second, pair.m_kerning );
+	}
+	m_atlasWidth = header.m_atlasWidth;
+	m_atlasHeight = header.m_atlasHeight;
+	m_staticAtlasWidth = header.m_staticAtlasWidth;
+	m_staticAtlasHeight = header.m_staticAtlasHeight;
+	m_atlasCachePixelOffset = header.m_pixelOffset;
+	return true;
+}
+
+void Font::SaveAtlasCache( std::string const& cachePath, uint64_t fontFileHash ) const
+{
+	PROFILE_SCOPE( "Font::SaveAtlasCache" );
+	std::vector<FontAtlasCacheKerningPair> kerningPairs;
+	for (int first = FONT_FIRST_CODEPOINT; first < FONT_FIRST_CODEPOINT + FONT_GLYPH_COUNT; ++first) {
+		for (int second = FONT_FIRST_CODEPOINT; second < FONT_FIRST_CODEPOINT + FONT_GLYPH_COUNT; ++second) {
+			float kerning = m_kerning.Get( first, second );
+			if (kerning != 0.f) {
+				kerningPairs.push_back( FontAtlasCacheKerningPair{ first, second, kerning } );
+			}
+		}
+	}
+
+	FontAtlasCacheHeader header;
+	memcpy( header.m_magic, FONT_ATLAS_CACHE_MAGIC, sizeof( FONT_ATLAS_CACHE_MAGIC ) );
+	header.m_version = FONT_ATLAS_CACHE_VERSION;
+	header.m_atlasMode = (uint32_t)m_atlasMode;
+	header.m_fontFileHash = fontFileHash;
+	header.m_fontFileSize = m_fontFile.GetSize();
+	header.m_fontSize = m_fontSize;
+	header.m_glyphPadding = m_glyphPadding;
+	header.m_firstCodepoint = FONT_FIRST_CODEPOINT;
+	header.m_glyphCount = FONT_GLYPH_COUNT;
+	header.m_atlasWidth = m_atlasWidth;
+	header.m_atlasHeight = m_atlasHeight;
+	header.m_staticAtlasWidth = m_staticAtlasWidth;
+	header.m_staticAtlasHeight = m_staticAtlasHeight;
+	header.m_kerningPairCount = (uint32_t)kerningPairs.size();
+	header.m_glyphTableSize = sizeof( FontGlyphTable );
+	uint64_t kerningEnd = sizeof( header ) + sizeof( FontGlyphTable ) + kerningPairs.size() * sizeof( FontAtlasCacheKerningPair );
+	header.m_pixelOffset = (kerningEnd + FONT_ATLAS_CACHE_PIXEL_ALIGNMENT - 1) & ~(FONT_ATLAS_CACHE_PIXEL_ALIGNMENT - 1);
+	header.m_pixelSize = m_rgbaAtlas.size();
+
+	FILE* file = nullptr;
+	fopen_s( &file, cachePath.c_str(), "wb" );
+	if (!file) {
+		// a read only data directory only costs the packing on every launch
+		return;
+	}
+	unsigned char const padding[FONT_ATLAS_CACHE_PIXEL_ALIGNMENT] = {};
+	fwrite( &header, sizeof( header ), 1, file );
+	fwrite( &m_glyphs, sizeof( FontGlyphTable ), 1, file );
+	fwrite( kerningPairs.data(), sizeof( FontAtlasCacheKerningPair ), kerningPairs.size(), file );
+	fwrite( padding, 1, (size_t)(header.m_pixelOffset - kerningEnd), file );
+	fwrite( m_rgbaAtlas.data(), 1, m_rgbaAtlas.size(), file );
+	fclose( file );
+}
+
+void Font::PackBitmapAtlas( std::vector<unsigned char>& atlas )
+{
+	// the ASCII glyphs go into the top left 512x512 of the atlas
+	constexpr int staticWidth = 512, staticHeight = 512;
 	stbtt_pack_context pc;
-	stbtt_PackBegin( &pc, atlas, 512, 512, 0, 3, NULL );
+	stbtt_PackBegin( &pc, atlas.data(), staticWidth, staticHeight, FONT_ATLAS_SIZE, 3, NULL );
 
 	// Pack glyphs into the atlas
-	m_fontPackRange = new stbtt_pack_range();
-	((stbtt_pack_range*)m_fontPackRange)->font_size = m_fontSize;
-	((stbtt_pack_range*)m_fontPackRange)->first_unicode_codepoint_in_range = 32; // ASCII starts at 32
-	((stbtt_pack_range*)m_fontPackRange)->num_chars = 95; // ASCII 32-126
-	((stbtt_pack_range*)m_fontPackRange)->chardata_for_range = (stbtt_packedchar*)malloc( sizeof( stbtt_packedchar ) * 95 );
-
-	stbtt_PackFontRanges( &pc, m_ttfBuffer, 0, &*(stbtt_pack_range*)m_fontPackRange, 1 );
+	stbtt_PackFontRanges( &pc, m_fontFile.GetData(), 0, &*(stbtt_pack_range*)m_fontPackRange, 1 );
 
 	stbtt_PackEnd( &pc );
 
-	// Expand 1-channel atlas_data to RGBA (4 bytes per pixel)
-	unsigned char* rgbaAtlas = (unsigned char*)malloc( atlasWidth * atlasHeight * 4 );
-	if (!rgbaAtlas) {
-		THROW_ERROR( "Cannot initialize RGBA atlas" );
+	m_staticAtlasWidth = staticWidth;
+	m_staticAtlasHeight = staticHeight;
+}
+
+void Font::PackSdfAtlas( std::vector<unsigned char>& atlas )
+{
+	PROFILE_SCOPE( "Font::PackSdfAtlas" );
+	stbtt_fontinfo const* fontInfo = (stbtt_fontinfo const*)m_fontInfo;
+	stbtt_packedchar* packedChars = ((stbtt_pack_range*)m_fontPackRange)->chardata_for_range;
+	float scale = stbtt_ScaleForPixelHeight( fontInfo, m_fontSize );
+	// the distance goes from 0 at the padding border to FONT_SDF_ON_EDGE_VALUE on the edge
+	float pixelDistanceScale = (float)FONT_SDF_ON_EDGE_VALUE / (float)FONT_SDF_PADDING;
+
+	unsigned char* glyphPixels[FONT_GLYPH_COUNT] = {};
+	// shelf packing row by row, glyphs are one pixel apart so linear filtering does not bleed between them
+	int x = 0, y = 0, rowHeight = 0;
+	for (int i = 0; i < FONT_GLYPH_COUNT; ++i) {
+		int width = 0, height = 0, xOffset = 0, yOffset = 0;
+		glyphPixels[i] = stbtt_GetCodepointSDF( fontInfo, scale, FONT_FIRST_CODEPOINT + i, FONT_SDF_PADDING, FONT_SDF_ON_EDGE_VALUE, pixelDistanceScale, &width, &height, &xOffset, &yOffset );
+		if (!glyphPixels[i]) {
+			// empty glyph like the space
+			width = height = xOffset = yOffset = 0;
+		}
+		ASSERT_OR_ERROR( width < FONT_SDF_ATLAS_WIDTH, "SDF glyph is wider than the atlas" );
+		if (x + width > FONT_SDF_ATLAS_WIDTH) {
+			x = 0;
+			y += rowHeight + 1;
+			rowHeight = 0;
+		}
+		int advance, lsb;
+		stbtt_GetCodepointHMetrics( fontInfo, FONT_FIRST_CODEPOINT + i, &advance, &lsb );
+		stbtt_packedchar& packedChar = packedChars[i];
+		packedChar.x0 = (unsigned short)x;
+		packedChar.y0 = (unsigned short)y;
+		packedChar.x1 = (unsigned short)(x + width);
+		packedChar.y1 = (unsigned short)(y + height);
+		packedChar.xoff = (float)xOffset;
+		packedChar.yoff = (float)yOffset;
+		packedChar.xoff2 = (float)(xOffset + width);
+		packedChar.yoff2 = (float)(yOffset + height);
+		packedChar.xadvance = (float)advance * scale;
+		x += width + 1;
+		rowHeight = std::max( rowHeight, height );
+	}
+
+	m_staticAtlasWidth = FONT_SDF_ATLAS_WIDTH;
+	m_staticAtlasHeight = (int)std::bit_ceil( (unsigned int)(y + rowHeight) );
+	ASSERT_OR_ERROR( m_staticAtlasHeight <= FONT_ATLAS_SIZE, "SDF glyphs do not fit into the atlas" );
+	for (int i = 0; i < FONT_GLYPH_COUNT; ++i) {
+		if (!glyphPixels[i]) {
+			continue;
+		}
+		stbtt_packedchar const& packedChar = packedChars[i];
+		int width = packedChar.x1 - packedChar.x0;
+		for (int row = 0; row < packedChar.y1 - packedChar.y0; ++row) {
+			memcpy( &atlas[(size_t)(packedChar.y0 + row) * FONT_ATLAS_SIZE + packedChar.x0], &glyphPixels[i][row * width], width );
+		}
+		stbtt_FreeSDF( glyphPixels[i], nullptr );
+	}
+}
+
+void Font::CreateAtlasTexture()
+{
+	if (m_texture) {
+		return;
+	}
+	if (m_atlasCacheFile.IsOpen()) {
+		// straight from the mapped cache, nothing to expand or copy on the CPU
+		unsigned char const* pixels = m_atlasCacheFile.GetData() + m_atlasCachePixelOffset;
+		m_texture = g_theRenderer->CreateTextureFromBuffer( pixels, (uint64_t)m_atlasWidth * m_atlasHeight * 4, m_atlasWidth, m_atlasHeight );
+	}
+	else {
+		m_texture = g_theRenderer->CreateTextureFromBuffer( m_rgbaAtlas.data(), m_rgbaAtlas.size(), m_atlasWidth, m_atlasHeight );
+	}
+	// the pixels live on the GPU now
+	m_atlasCacheFile.Close();
+	m_rgbaAtlas.clear();
+	m_rgbaAtlas.shrink_to_fit();
+}
+
+void Font::BuildGlyphTables()
+{
+	PROFILE_SCOPE( "Font::BuildGlyphTables" );
+	stbtt_fontinfo const* fontInfo = (stbtt_fontinfo const*)m_fontInfo;
+	stbtt_packedchar const* packedChars = ((stbtt_pack_range*)m_fontPackRange)->chardata_for_range;
+	for (int i = 0; i < FONT_GLYPH_COUNT; ++i) {
+		int advance, lsb;
+		stbtt_GetCodepointHMetrics( fontInfo, FONT_FIRST_CODEPOINT + i, &advance, &lsb );
+		m_glyphs.m_advances[i] = (float)advance * m_unitScale;
+		m_glyphs.m_leftBearings[i] = (float)lsb * m_unitScale;
+
+		// the quad of stbtt_GetPackedQuad at a zero pen position, flipped to y up
+		stbtt_packedchar const& packedChar = packedChars[i];
+		m_glyphs.m_quadAdvances[i] = packedChar.xadvance;
+		m_glyphs.m_quadMinXs[i] = packedChar.xoff;
+		m_glyphs.m_quadMaxXs[i] = packedChar.xoff2;
+		m_glyphs.m_quadMinYs[i] = m_fontSize - packedChar.yoff2;
+		m_glyphs.m_quadMaxYs[i] = m_fontSize - packedChar.yoff;
+		m_glyphs.m_uvMinXs[i] = (float)packedChar.x0 / (float)m_atlasWidth;
+		m_glyphs.m_uvMinYs[i] = (float)packedChar.y1 / (float)m_atlasHeight;
+		m_glyphs.m_uvMaxXs[i] = (float)packedChar.x1 / (float)m_atlasWidth;
+		m_glyphs.m_uvMaxYs[i] = (float)packedChar.y0 / (float)m_atlasHeight;
 	}
-	for (int i = 0; i < atlasWidth * atlasHeight; i++) {
-		rgbaAtlas[i * 4 + 0] = 255; // R
-		rgbaAtlas[i * 4 + 1] = 255; // G
-		rgbaAtlas[i * 4 + 2] = 255; // B
-		rgbaAtlas[i * 4 + 3] = atlas[i]; // A
+	// the packed space has no width, it is widened by its advance so spaces take room
+	int spaceIndex = GetGlyphIndex( ' ' );
+	m_glyphs.m_quadMaxXs[spaceIndex] += m_spaceAdvance;
+	m_glyphs.m_quadAdvances[spaceIndex] += m_spaceAdvance;
+
+	for (int first = 0; first < FONT_GLYPH_COUNT; ++first) {
+		for (int second = 0; second < FONT_GLYPH_COUNT; ++second) {
+			int kerning = stbtt_GetCodepointKernAdvance( fontInfo, FONT_FIRST_CODEPOINT + first, FONT_FIRST_CODEPOINT + second );
+			if (kerning != 0) {
+				m_kerning.Add( FONT_FIRST_CODEPOINT + first, FONT_FIRST_CODEPOINT + second, (float)kerning * m_unitScale );
+			}
+		}
 	}
+}
 
-	m_texture = g_theRenderer->CreateTextureFromBuffer( rgbaAtlas, atlasWidth * atlasHeight * 4, atlasWidth, atlasHeight );
+int Font::GetGlyphIndex( int codepoint )
+{
+	int index = codepoint - FONT_FIRST_CODEPOINT;
+	return (index >= 0 && index < FONT_GLYPH_COUNT) ? index : -1;
+}
 
+float Font::GetUnitAdvance( int codepoint ) const
+{
+	int index = GetGlyphIndex( codepoint );
+	if (index >= 0) {
+		return m_glyphs.m_advances[index];
+	}
 	int advance, lsb;
-	float scale = stbtt_ScaleForPixelHeight( (stbtt_fontinfo*)m_fontInfo, m_fontSize );
-	stbtt_GetCodepointHMetrics( (stbtt_fontinfo*)m_fontInfo, ' ', &advance, &lsb );
-	m_spaceAdvance = (float)advance * scale;
+	stbtt_GetCodepointHMetrics( (stbtt_fontinfo*)m_fontInfo, codepoint, &advance, &lsb );
+	return (float)advance * m_unitScale;
+}
 
-	free( rgbaAtlas );
+float Font::GetUnitKerning( int first, int second ) const
+{
+	if (GetGlyphIndex( first ) >= 0 && GetGlyphIndex( second ) >= 0) {
+		return m_kerning.Get( first, second );
+	}
+	return (float)stbtt_GetCodepointKernAdvance( (stbtt_fontinfo*)m_fontInfo, first, second ) * m_unitScale;
 }
 
 Font::~Font()
 {
+	// the cache worker reads the font info
+	m_glyphCache.reset();
 	delete m_texture;
-	free( ((stbtt_pack_range*)m_fontPackRange)->chardata_for_range );
-	delete m_fontPackRange;
-	delete m_fontInfo;
-	free( m_ttfBuffer );
+	delete (stbtt_fontinfo*)m_fontInfo;
+}
+
+void Font::AddVertsForTextInBox2D( std::vector<VertexPCU3D>& verts, std::string_view text, AABB2 const& box, Rgba8 const& color, float textSize, Vec2 const& alignment, TextBoxMode mode /*= TextBoxMode::SHRINK_TO_FIT*/, float zHeight /*= 0.f */ ) const
+{
+	size_t startPos = verts.size();
+	verts.resize( startPos + GetMaxVertexCount( text ) );
+	size_t vertexCount = AddVertsForTextInBox2D( std::span<VertexPCU3D>( verts ).subspan( startPos ), text, box, color, textSize, alignment, mode, zHeight );
+	verts.resize( startPos + vertexCount );
+}
+
+void Font::AddVertsForText2D( std::vector<VertexPCU3D>& verts, std::string_view text, Vec2 const& leftBottomPos, Rgba8 const& color, float textSize, float zHeight ) const
+{
+	size_t startPos = verts.size();
+	verts.resize( startPos + GetMaxVertexCount( text ) );
+	size_t vertexCount = AddVertsForText2D( std::span<VertexPCU3D>( verts ).subspan( startPos ), text, leftBottomPos, color, textSize, zHeight );
+	verts.resize( startPos + vertexCount );
 }
 
-void Font::AddVertsForTextInBox2D( std::vector<VertexPCU3D>& verts, std::string const& text, AABB2 const& box, Rgba8 const& color, float textSize, Vec2 const& alignment, TextBoxMode mode /*= TextBoxMode::SHRINK_TO_FIT*/, float zHeight /*= 0.f */ ) const
+size_t Font::AddVertsForTextInBox2D( std::span<VertexPCU3D> verts, std::string_view text, AABB2 const& box, Rgba8 const& color, float textSize, Vec2 const& alignment, TextBoxMode mode /*= TextBoxMode::SHRINK_TO_FIT*/, float zHeight /*= 0.f */ ) const
 {
-	// split string by \n
-	Strings strings;
-	int numOfLines;
+	PROFILE_SCOPE( "Font::AddVertsForTextInBox2D" );
+	// #Todo: Auto new line, lays out like OVERRUN for now
 	float boxWidth = box.m_maxs.x - box.m_mins.x;
-	// #Todo: Auto new line
-// 	if (mode == TextBoxMode::AUTO_NEW_LINE) {
-// 		std::string newStr = text;
-// 		float widthSum = 0.f;
-// 		for (int i = 0; i < (int)text.size(); i++) {
-// 			if (text[i] == '\n') {
-// 				widthSum = 0.f;
-// 				continue;
-// 			}
-// 			widthSum += GetGlyphAspectWithSpacing( text[i] ) * cellHeight * cellAspect;
-// 			if (widthSum > boxWidth) {
-// 				newStr = newStr.substr( 0, i ) + "\n" + newStr.substr( i );
-// 				widthSum = GetGlyphAspectWithSpacing( text[i] ) * cellHeight * cellAspect;
-// 			}
-// 		}
-// 		numOfLines = SplitStringOnDelimiter( strings, newStr, '\n' );
-// 	}
-// 	else {
-	numOfLines = SplitStringOnDelimiter( strings, text, '\n' );
-/*	}*/
-	// calculate text box height and width
 	float boxHeight = box.m_maxs.y - box.m_mins.y;
+	int numOfLines = (int)std::count( text.begin(), text.end(), '\n' ) + 1;
 	float allTextHeight = textSize * numOfLines;
 	float scalingFactor = 1.f;
 	if (mode == TextBoxMode::SHRINK_TO_FIT) {
 		float allTextMaxWidth = -1;
 		// find max width of all lines of string
-		for (std::string const& str : strings) {
-			float textWidth = GetTextWidth( textSize, str );
+		for (std::string_view lines = text; !lines.empty(); ) {
+			float textWidth = GetTextWidth( textSize, PopLine( lines ) );
 			if (textWidth > allTextMaxWidth) {
 				allTextMaxWidth = textWidth;
 			}
@@ -135,81 +497,97 @@ void Font::AddVertsForTextInBox2D( std::vector<VertexPCU3D>& verts, std::string
 		scalingFactor = std::min( heightScalingFactor, widthScalingFactor );
 	}
 
-	int drawGlyphsCount = 0;
-	for (int i = 0; i < (int)strings.size(); i++) {
-		std::string const& str = strings[i];
-		float stringWidth = GetTextWidth( textSize, str ) * scalingFactor;
+	// yOffset: offset from top because text is start from top (but AABB starts from bottom)
+	float remainSpaceY = boxHeight - allTextHeight * scalingFactor;
+	float yOffset = remainSpaceY * (1 - alignment.y);
+	size_t vertexCount = 0;
+	std::string_view lines = text;
+	for (int i = 0; i < numOfLines; i++) {
+		std::string_view line = PopLine( lines );
+		float stringWidth = GetTextWidth( textSize, line ) * scalingFactor;
 		// xOffset: offset from left
 		float remainSpaceX = boxWidth - stringWidth;
 		float xOffset = remainSpaceX * alignment.x;
-		// yOffset: offset from top because text is start from top (but AABB starts from bottom)
-		float remainSpaceY = boxHeight - allTextHeight * scalingFactor;
-		float yOffset = remainSpaceY * (1 - alignment.y);
-		// check if reach max glyph to draw
-/*		if (drawGlyphsCount + (int)str.size() <= maxGlyphsToDraw) {*/
-		AddVertsForText2D( verts, str, Vec2( box.m_mins.x + xOffset, box.m_maxs.y - yOffset - textSize * scalingFactor * (i + 1) ), color, textSize * scalingFactor, zHeight );
-		drawGlyphsCount += (int)str.size();
-/*		}*/
-// 		else {
-// 			AddVertsForText2D( verts, Vec2( box.m_mins.x + xOffset, box.m_maxs.y - yOffset - cellHeight * scalingFactor * (i + 1) ), cellHeight * scalingFactor, str.substr( 0, (size_t)maxGlyphsToDraw - drawGlyphsCount ), tint, cellAspect );
-// 			return;
-// 		}
-	}
-}
-
-void Font::AddVertsForText2D( std::vector<VertexPCU3D>& verts, std::string const& text, Vec2 const& leftBottomPos, Rgba8 const& color, float textSize, float zHeight ) const
+		vertexCount += AddVertsForText2D( verts.subspan( vertexCount ), line, Vec2( box.m_mins.x + xOffset, box.m_maxs.y - yOffset - textSize * scalingFactor * (i + 1) ), color, textSize * scalingFactor, zHeight );
+	}
+	return vertexCount;
+}
+
+size_t Font::AddVertsForText2D( std::span<VertexPCU3D> verts, std::string_view text, Vec2 const& leftBottomPos, Rgba8 const& color, float textSize, float zHeight ) const
 {
-	size_t startPos = verts.size();
-	float xPos = leftBottomPos.x, yPos = leftBottomPos.y;
+	size_t vertexCount = 0;
+	float xPos = leftBottomPos.x;
 	float ratio = textSize / m_fontSize;
 	float prevX1 = xPos;
-	float prevY0 = yPos;
-	float prevQY0 = yPos;
+	float prevY0 = 0.f;
+	float prevQY0 = 0.f;
 	float startX0 = 0.f;
 	float startY0 = 0.f;
-	// q contains (s0,t0) to (s1,t1) texture coordinates and (x0,y0) to (x1,y1) screen coordinates
-	for (int i = 0; i < text.size(); ++i) {
-		char c = text[i] - 32;
-		stbtt_aligned_quad q;
-		float prevXPos = xPos;
-		stbtt_GetPackedQuad( ((stbtt_pack_range*)m_fontPackRange)->chardata_for_range, 512, 512, c, &xPos, &yPos, &q, 0 );
-
-		// Draw quad with texture coordinates (q.s0, q.t0) to (q.s1, q.t1)
-		// and screen coordinates (q.x0, q.y0) to (q.x1, q.y1)
-		if (c == 0) {
-			q.x1 += m_spaceAdvance;
-			xPos += m_spaceAdvance;
+	bool isFirstGlyph = true;
+	// quads are in atlas pixels relative to the pen, the first glyph is placed at leftBottomPos and the others follow it scaled
+	for (size_t i = 0; i < text.size() && vertexCount + QUAD_VERTEX_COUNT <= verts.size(); ) {
+		GlyphQuad quad;
+		int glyph = GetGlyphIndex( (unsigned char)text[i] );
+		if (glyph >= 0) {
+			++i;
+			quad.m_minX = m_glyphs.m_quadMinXs[glyph];
+			quad.m_maxX = m_glyphs.m_quadMaxXs[glyph];
+			quad.m_minY = m_glyphs.m_quadMinYs[glyph];
+			quad.m_maxY = m_glyphs.m_quadMaxYs[glyph];
+			quad.m_advance = m_glyphs.m_quadAdvances[glyph];
+			quad.m_uvMins = Vec2( m_glyphs.m_uvMinXs[glyph], m_glyphs.m_uvMinYs[glyph] );
+			quad.m_uvMaxs = Vec2( m_glyphs.m_uvMaxXs[glyph], m_glyphs.m_uvMaxYs[glyph] );
 		}
-
-		float qy1 = q.y1;
-		q.y1 = m_fontSize - q.y0;
-		q.y0 = m_fontSize - qy1;
+		else {
+			int codepoint;
+			i += utf8Decode( text.data() + i, text.size() - i, &codepoint );
+			if (codepoint < FONT_FIRST_CODEPOINT) {
+				continue;
+			}
+			if (!m_glyphCache->GetGlyph( codepoint, quad )) {
+				// not resident yet, leave its room so the text does not jump when it arrives
+				xPos += GetUnitAdvance( codepoint ) * textSize;
+				continue;
+			}
+		}
+		float qx0 = xPos + quad.m_minX;
+		float qx1 = xPos + quad.m_maxX;
+		float qy0 = quad.m_minY;
+		float qy1 = quad.m_maxY;
 		float newX0, newY0;
-		if (i == 0) {
-			newX0 = q.x0;
-			startX0 = q.x0;
-			newY0 = q.y0;
-			startY0 = q.y0;
+		if (isFirstGlyph) {
+			newX0 = qx0;
+			newY0 = qy0;
+			// the glyph itself starts at leftBottomPos, not its padding
+			startX0 = qx0 + m_glyphPadding * ratio;
+			startY0 = qy0 + m_glyphPadding * ratio;
+			isFirstGlyph = false;
 		}
 		else {
-			newX0 = (q.x0 - prevX1) * ratio + prevX1;
-			newY0 = (q.y0 - prevQY0) * ratio + prevY0;
+			newX0 = (qx0 - prevX1) * ratio + prevX1;
+			newY0 = (qy0 - prevQY0) * ratio + prevY0;
 		}
-		float newX1 = newX0 + (q.x1 - q.x0) * ratio;
-		float newY1 = newY0 + (q.y1 - q.y0) * ratio;
-		AddVertsForAABB2D( verts, AABB2( Vec2( newX0, newY0 ), Vec2( newX1, newY1 ) ), color, Vec2( q.s0, q.t1 ), Vec2( q.s1, q.t0 ) );
+		float newX1 = newX0 + (qx1 - qx0) * ratio;
+		float newY1 = newY0 + (qy1 - qy0) * ratio;
+		AddVertsForQuad2D( &verts[vertexCount], AABB2( Vec2( newX0, newY0 ), Vec2( newX1, newY1 ) ), color, quad.m_uvMins, quad.m_uvMaxs );
+		vertexCount += QUAD_VERTEX_COUNT;
 
-		xPos = (xPos - prevXPos) * ratio + prevXPos;
+		xPos += quad.m_advance * ratio;
 		prevX1 = newX1;
 		prevY0 = newY0;
-		prevQY0 = q.y0;
+		prevQY0 = qy0;
 	}
-	size_t endPos = verts.size();
-	for (size_t i = startPos; i < endPos; ++i) {
+	for (size_t i = 0; i < vertexCount; ++i) {
 		verts[i].m_position.x += (leftBottomPos.x - startX0);
 		verts[i].m_position.y += (leftBottomPos.y - startY0);
 		verts[i].m_position.z += zHeight;
 	}
+	return vertexCount;
+}
+
+size_t Font::GetMaxVertexCount( std::string_view text )
+{
+	return (text.size() - std::count( text.begin(), text.end(), '\n' )) * QUAD_VERTEX_COUNT;
 }
 
 Texture* Font::GetTexture() const
@@ -217,54 +595,57 @@ Texture* Font::GetTexture() const
 	return m_texture;
 }
 
-static int utf8Decode( const char* s, int* codepoint ) {
-	unsigned char* c = (unsigned char*)s;
-	if (c[0] < 0x80) {
-		*codepoint = c[0];
-		return 1;
-	}
-	else if ((c[0] & 0xE0) == 0xC0) {
-		*codepoint = ((c[0] & 0x1F) << 6) | (c[1] & 0x3F);
-		return 2;
-	}
-	else if ((c[0] & 0xF0) == 0xE0) {
-		*codepoint = ((c[0] & 0x0F) << 12) | ((c[1] & 0x3F) << 6) | (c[2] & 0x3F);
-		return 3;
-	}
-	else if ((c[0] & 0xF8) == 0xF0) {
-		*codepoint = ((c[0] & 0x07) << 18) | ((c[1] & 0x3F) << 12) | ((c[2] & 0x3F) << 6) | (c[3] & 0x3F);
-		return 4;
-	}
-	*codepoint = 0;
-	return 1;
+void Font::UpdateGlyphCache()
+{
+	m_glyphCache->Update( m_texture );
 }
 
-float Font::GetTextWidth( float textSize, std::string const& string ) const
+uint64_t Font::GetGlyphGeneration() const
 {
-	//int ascent, descent, line_gap;
-	//stbtt_GetFontVMetrics( (stbtt_fontinfo*)m_fontInfo, &ascent, &descent, &line_gap );
+	return m_glyphCache->GetGeneration();
+}
 
-	float scale = stbtt_ScaleForPixelHeight( (stbtt_fontinfo*)m_fontInfo, textSize );// */ m_fontSize;
+FontAtlasMode Font::GetAtlasMode() const
+{
+	return m_atlasMode;
+}
+
+char const* Font::GetShaderName( VertexFormat format ) const
+{
+	if (format == VertexFormat::PCU2D) {
+		return m_atlasMode == FontAtlasMode::SDF ? FONT_SDF_2D_SHADER_NAME : FONT_BITMAP_2D_SHADER_NAME;
+	}
+	return m_atlasMode == FontAtlasMode::SDF ? FONT_SDF_SHADER_NAME : FONT_BITMAP_SHADER_NAME;
+}
 
-	//scale = stbtt_ScaleForMappingEmToPixels( (stbtt_fontinfo*)m_fontInfo, m_fontSize ) * textSize / m_fontSize;
+float Font::GetTextWidth( float textSize, std::string_view text ) const
+{
+	// widths are summed for a text size of 1 and scaled once, as stbtt_ScaleForPixelHeight is linear in the text size
 	float x = 0.f;
 	int prevCodepoint = 0;
 
-	for (const char* c = string.c_str(); *c; ) {
+	for (size_t i = 0; i < text.size(); ) {
 		int codepoint;
-		c += utf8Decode( c, &codepoint );
-
-		int advance, lsb;
-		stbtt_GetCodepointHMetrics( (stbtt_fontinfo*)m_fontInfo, codepoint, &advance, &lsb );
-
-		if (prevCodepoint) {
-			x += stbtt_GetCodepointKernAdvance( (stbtt_fontinfo*)m_fontInfo, prevCodepoint, codepoint ) * scale;
+		int glyph = GetGlyphIndex( (unsigned char)text[i] );
+		if (glyph >= 0) {
+			// ASCII, only table lookups
+			codepoint = (unsigned char)text[i];
+			++i;
+			if (prevCodepoint) {
+				x += GetGlyphIndex( prevCodepoint ) >= 0 ? m_kerning.Get( prevCodepoint, codepoint ) : GetUnitKerning( prevCodepoint, codepoint );
+			}
+			x += m_glyphs.m_advances[glyph];
+		}
+		else {
+			i += utf8Decode( text.data() + i, text.size() - i, &codepoint );
+			if (prevCodepoint) {
+				x += GetUnitKerning( prevCodepoint, codepoint );
+			}
+			x += GetUnitAdvance( codepoint );
 		}
-
-		x += advance * scale;
 		prevCodepoint = codepoint;
 	}
 
-	return x;
+	return x * textSize;
 }
 
@@ -1,9 +1,74 @@
 #pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 #include "Graphics/Vertex.h"
+#include "Core/MappedFile.h"
 
 class Texture;
+class GlyphCache;
+
+constexpr int FONT_FIRST_CODEPOINT = 32;
+constexpr int FONT_GLYPH_COUNT = 95; // ASCII 32-126
+
+/// Metrics of the packed glyphs read once at load, one flat array per field indexed by codepoint - FONT_FIRST_CODEPOINT
+/// Advances are in pixels for a text size of 1, quads are in atlas pixels at the packing font size, y up from the baseline
+struct FontGlyphTable {
+	alignas(16) std::array<float, FONT_GLYPH_COUNT> m_advances = {};
+	alignas(16) std::array<float, FONT_GLYPH_COUNT> m_leftBearings = {};
+	alignas(16) std::array<float, FONT_GLYPH_COUNT> m_quadAdvances = {};
+	alignas(16) std::array<float, FONT_GLYPH_COUNT> m_quadMinXs = {};
+	alignas(16) std::array<float, FONT_GLYPH_COUNT> m_quadMinYs = {};
+	alignas(16) std::array<float, FONT_GLYPH_COUNT> m_quadMaxXs = {};
+	alignas(16) std::array<float, FONT_GLYPH_COUNT> m_quadMaxYs = {};
+	alignas(16) std::array<float, FONT_GLYPH_COUNT> m_uvMinXs = {};
+	alignas(16) std::array<float, FONT_GLYPH_COUNT> m_uvMinYs = {};
+	alignas(16) std::array<float, FONT_GLYPH_COUNT> m_uvMaxXs = {};
+	alignas(16) std::array<float, FONT_GLYPH_COUNT> m_uvMaxYs = {};
+};
+
+/// Kerning of the codepoint pairs of the glyph table, open addressing with linear probing
+/// Only the pairs with kerning are stored, so a lookup of most pairs ends at the first empty slot
+class FontKerningTable {
+public:
+	void Add( int first, int second, float kerning );
+	float Get( int first, int second ) const;
+	size_t GetPairCount() const;
+
+protected:
+	void Grow();
+
+	/// 0 is an empty slot, no pair of the table has a zero key
+	std::vector<uint32_t> m_keys;
+	std::vector<float> m_kernings;
+	size_t m_pairCount = 0;
+};
+/// BITMAP: coverage rasterized at FONT_BITMAP_SIZE, sharp near that size only
+/// SDF: signed distance to the glyph edges at FONT_SDF_SIZE, one smaller atlas for every text size, drawn with FONT_SDF_SHADER_NAME
+enum class FontAtlasMode {
+	BITMAP,
+	SDF,
+};
+
+constexpr float FONT_BITMAP_SIZE = 64.f;
+constexpr float FONT_SDF_SIZE = 32.f;
+/// distance field pixels around every SDF glyph, the distance is clamped beyond them
+constexpr int FONT_SDF_PADDING = 4;
+/// distance value on the glyph edge, the fragment shader tests against the same value
+constexpr unsigned char FONT_SDF_ON_EDGE_VALUE = 128;
+constexpr int FONT_SDF_ATLAS_WIDTH = 512;
+/// the static ASCII glyphs take the top left corner of the atlas, the rest are cells of the glyph cache
+constexpr int FONT_ATLAS_SIZE = 1024;
+constexpr char const* FONT_BITMAP_SHADER_NAME = "shader";
+constexpr char const* FONT_SDF_SHADER_NAME = "text_sdf";
+/// the same shaders reading VertexPCU2D
+constexpr char const* FONT_BITMAP_2D_SHADER_NAME = "shader_2d";
+constexpr char const* FONT_SDF_2D_SHADER_NAME = "text_sdf_2d";
+
 enum class TextBoxMode {
 	SHRINK_TO_FIT,
 	OVERRUN,
@@ -12,20 +77,72 @@ enum class TextBoxMode {
 
 class Font {
 public:
-	Font( std::string const& fontPath );
+	/// if createTexture is false, only the CPU side work is done (thread safe), call CreateAtlasTexture later on the main thread
+	/// the packed atlas is cached next to the font file, see FontAtlasCacheFormat.h
+	explicit Font( std::string const& fontPath, bool createTexture = true, FontAtlasMode atlasMode = FontAtlasMode::BITMAP );
 	~Font();
 
-	void AddVertsForTextInBox2D( std::vector<VertexPCU3D>& verts, std::string const& text, AABB2 const& box, Rgba8 const& color, float textSize, Vec2 const& alignment, TextBoxMode mode = TextBoxMode::SHRINK_TO_FIT, float zHeight = 0.f ) const;
-	void AddVertsForText2D( std::vector<VertexPCU3D>& verts, std::string const& text, Vec2 const& leftBottomPos, Rgba8 const& color, float textSize, float zHeight = 0.f ) const;
+	void CreateAtlasTexture();
+
+	/// lines are split on '\n' in place, the vector only allocates when it has to grow
+	/// every glyph is a quad of QUAD_VERTEX_COUNT vertices, draw them with RendererInterface::DrawQuads
+	void AddVertsForTextInBox2D( std::vector<VertexPCU3D>& verts, std::string_view text, AABB2 const& box, Rgba8 const& color, float textSize, Vec2 const& alignment, TextBoxMode mode = TextBoxMode::SHRINK_TO_FIT, float zHeight = 0.f ) const;
+	void AddVertsForText2D( std::vector<VertexPCU3D>& verts, std::string_view text, Vec2 const& leftBottomPos, Rgba8 const& color, float textSize, float zHeight = 0.f ) const;
+	/// write into memory the caller owns, such as transient vertices, returns the number of vertices written
+	/// glyphs that do not fit are dropped, GetMaxVertexCount of the text always fits
+	size_t AddVertsForTextInBox2D( std::span<VertexPCU3D> verts, std::string_view text, AABB2 const& box, Rgba8 const& color, float textSize, Vec2 const& alignment, TextBoxMode mode = TextBoxMode::SHRINK_TO_FIT, float zHeight = 0.f ) const;
+	size_t AddVertsForText2D( std::span<VertexPCU3D> verts, std::string_view text, Vec2 const& leftBottomPos, Rgba8 const& color, float textSize, float zHeight = 0.f ) const;
+	/// upper bound of the vertices the text is laid out into, a quad per byte that is not a new line
+	static size_t GetMaxVertexCount( std::string_view text );
 	Texture* GetTexture() const;
+	/// copy the glyphs the cache finished since the last call into the atlas, see ResourceManager::UpdateFonts
+	void UpdateGlyphCache();
+	/// changes when glyphs outside of ASCII became resident or were evicted, text laid out before has to be laid out again
+	uint64_t GetGlyphGeneration() const;
+	FontAtlasMode GetAtlasMode() const;
+	/// the shader text of this font has to be drawn with, the SDF atlas needs its own fragment shader
+	/// pass VertexFormat::PCU2D for text converted to VertexPCU2D
+	char const* GetShaderName( VertexFormat format = VertexFormat::PCU3D ) const;
+	float GetTextWidth( float textSize, std::string_view text ) const;
 protected:
-	float GetTextWidth( float textSize, std::string const& string ) const;
-protected:
-	float m_fontSize = 64.f;
+	/// pack the static glyphs, expand the atlas to RGBA and build the glyph tables
+	void PackAtlas();
+	/// false if the cache is missing or was made from another font file or packing, the atlas stays mapped until the upload
+	bool LoadAtlasCache( std::string const& cachePath, uint64_t fontFileHash );
+	void SaveAtlasCache( std::string const& cachePath, uint64_t fontFileHash ) const;
+	/// pack the ASCII glyphs into the top left corner of the single channel atlas, sets the static atlas size
+	void PackBitmapAtlas( std::vector<unsigned char>& atlas );
+	void PackSdfAtlas( std::vector<unsigned char>& atlas );
+	void BuildGlyphTables();
+	/// -1 for codepoints outside of the glyph table
+	static int GetGlyphIndex( int codepoint );
+	/// for a text size of 1, codepoints outside of the glyph table ask stb_truetype
+	float GetUnitAdvance( int codepoint ) const;
+	float GetUnitKerning( int first, int second ) const;
+
+	FontAtlasMode m_atlasMode = FontAtlasMode::BITMAP;
+	/// pixel height the atlas glyphs are made at
+	float m_fontSize = FONT_BITMAP_SIZE;
+	/// atlas pixels around the glyph quads that are not part of the glyph
+	float m_glyphPadding = 0.f;
 	float m_spaceAdvance = 0.f;
+	/// stbtt_pack_range of PackAtlas, only set while it runs
 	void* m_fontPackRange = nullptr;
 	void* m_fontInfo = nullptr;
-	Texture* m_texture;
+	Texture* m_texture = nullptr;
 	std::string m_path;
-	unsigned char* m_ttfBuffer = NULL;
+	MappedFile m_fontFile;
+	/// the RGBA atlas lives in the mapped cache instead of m_rgbaAtlas while it is open
+	MappedFile m_atlasCacheFile;
+	uint64_t m_atlasCachePixelOffset = 0;
+	int m_atlasWidth = FONT_ATLAS_SIZE;
+	int m_atlasHeight = FONT_ATLAS_SIZE;
+	int m_staticAtlasWidth = 0;
+	int m_staticAtlasHeight = 0;
+	std::vector<unsigned char> m_rgbaAtlas;
+	/// stbtt_ScaleForPixelHeight for a text size of 1, the scale is linear in the text size
+	float m_unitScale = 0.f;
+	FontGlyphTable m_glyphs;
+	FontKerningTable m_kerning;
+	std::unique_ptr<GlyphCache> m_glyphCache;
 };
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <type_traits>
+#include "Graphics/Font.h"
+
+/// Font atlas cache file next to the font file: the header, the glyph table, the kerning pairs, then the RGBA atlas
+/// The atlas is stored as uploaded so a valid cache is mapped and handed to the renderer as it is
+constexpr char FONT_ATLAS_CACHE_MAGIC[8] = { 'S', 'L', 'V', 'F', 'O', 'N', 'T', 'A' };
+constexpr uint32_t FONT_ATLAS_CACHE_VERSION = 1;
+constexpr char const* FONT_ATLAS_CACHE_EXTENSION = ".fontatlas";
+/// the atlas starts at this alignment in the file
+constexpr uint64_t FONT_ATLAS_CACHE_PIXEL_ALIGNMENT = 64;
+
+/// Everything the packed atlas depends on is part of the key, a cache with any other value is packed and written again
+struct FontAtlasCacheHeader {
+	char m_magic[8] = {};
+	uint32_t m_version = 0;
+	uint32_t m_atlasMode = 0;
+	uint64_t m_fontFileHash = 0;
+	uint64_t m_fontFileSize = 0;
+	float m_fontSize = 0.f;
+	float m_glyphPadding = 0.f;
+	int32_t m_firstCodepoint = 0;
+	int32_t m_glyphCount = 0;
+	int32_t m_atlasWidth = 0;
+	int32_t m_atlasHeight = 0;
+	int32_t m_staticAtlasWidth = 0;
+	int32_t m_staticAtlasHeight = 0;
+	uint32_t m_kerningPairCount = 0;
+	uint32_t m_glyphTableSize = 0;
+	uint64_t m_pixelOffset = 0;
+	uint64_t m_pixelSize = 0;
+};
+
+struct FontAtlasCacheKerningPair {
+	int32_t m_first;
+	int32_t m_second;
+	float m_kerning;
+};
+
+static_assert(std::is_trivially_copyable_v<FontGlyphTable>, "the glyph table is written to the font atlas cache as it is");
@@ -0,0 +1,279 @@
+#include "Graphics/GlyphCache.h"
+#include "Graphics/RendererInterface.h"
+#include "Core/EngineCommon.h"
+#include "Core/Profiler.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "Thirdparty/stb/stb_truetype.h"
+
+GlyphCache::GlyphCache( void const* fontInfo, FontAtlasMode atlasMode, float fontSize, int atlasWidth, int atlasHeight, int reservedWidth, int reservedHeight )
+	:m_fontInfo( fontInfo ), m_atlasMode( atlasMode ), m_fontSize( fontSize ), m_atlasWidth( atlasWidth ), m_atlasHeight( atlasHeight )
+{
+	m_scale = stbtt_ScaleForPixelHeight( (stbtt_fontinfo const*)m_fontInfo, m_fontSize );
+	// one pixel of empty border on every side keeps linear filtering inside the cell
+	m_cellSize = (int)std::ceil( m_fontSize * GLYPH_CACHE_CELL_SCALE ) + 2;
+	if (m_atlasMode == FontAtlasMode::SDF) {
+		m_cellSize += 2 * FONT_SDF_PADDING;
+	}
+	for (int y = 0; y + m_cellSize <= m_atlasHeight; y += m_cellSize) {
+		for (int x = 0; x + m_cellSize <= m_atlasWidth; x += m_cellSize) {
+			if (x < reservedWidth && y < reservedHeight) {
+				continue;
+			}
+			m_cellXs.push_back( x );
+			m_cellYs.push_back( y );
+		}
+	}
+	int cellCount = (int)m_cellXs.size();
+	m_cellCodepoints.assign( cellCount, -1 );
+	m_lruPrev.assign( cellCount, -1 );
+	m_lruNext.assign( cellCount, -1 );
+	// handed out from the back, so the first cells are used first
+	for (int cell = cellCount - 1; cell >= 0; --cell) {
+		m_freeCells.push_back( cell );
+	}
+}
+
+GlyphCache::~GlyphCache()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_isStopping = true;
+	}
+	m_requestCondition.notify_all();
+	if (m_worker.joinable()) {
+		m_worker.join();
+	}
+}
+
+bool GlyphCache::GetGlyph( int codepoint, GlyphQuad& out_quad )
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	auto iter = m_glyphs.find( codepoint );
+	if (iter == m_glyphs.end()) {
+		m_glyphs.emplace( codepoint, CachedGlyph() );
+		m_requests.push_back( codepoint );
+		// fonts that never show anything outside of ASCII never start the worker
+		if (!m_worker.joinable()) {
+			m_worker = std::thread( &GlyphCache::WorkerMain, this );
+		}
+		m_requestCondition.notify_one();
+		return false;
+	}
+	CachedGlyph const& glyph = iter->second;
+	if (glyph.m_state != CachedGlyphState::RESIDENT) {
+		return false;
+	}
+	TouchCell( glyph.m_cell );
+	out_quad = glyph.m_quad;
+	return true;
+}
+
+void GlyphCache::Update( Texture* atlasTexture )
+{
+	if (!atlasTexture) {
+		// the atlas texture is created later on the main thread, the glyphs wait for it
+		return;
+	}
+	std::lock_guard<std::mutex> lock( m_mutex );
+	if (m_rasterized.empty()) {
+		return;
+	}
+	PROFILE_SCOPE( "GlyphCache::Update" );
+	bool hasChanged = false;
+	uint32_t uploadCount = 0;
+	size_t index = 0;
+	for (; index < m_rasterized.size() && uploadCount < GLYPH_CACHE_MAX_UPLOADS_PER_UPDATE; ++index) {
+		RasterizedGlyph const& rasterized = m_rasterized[index];
+		CachedGlyph& glyph = m_glyphs[rasterized.m_codepoint];
+		glyph.m_quad.m_advance = rasterized.m_advance;
+		int cell = rasterized.m_hasQuad ? AcquireCell() : -1;
+		if (cell < 0) {
+			// the layout already left room for it while it was rasterized, nothing to lay out again
+			glyph.m_state = CachedGlyphState::NO_QUAD;
+			continue;
+		}
+		int cellX = m_cellXs[cell];
+		int cellY = m_cellYs[cell];
+		g_theRenderer->UpdateTextureRegion( atlasTexture, cellX, cellY, m_cellSize, m_cellSize, rasterized.m_pixels.data() );
+		++uploadCount;
+
+		glyph.m_quad.m_minX = (float)rasterized.m_xOffset;
+		glyph.m_quad.m_maxX = (float)(rasterized.m_xOffset + rasterized.m_width);
+		glyph.m_quad.m_minY = m_fontSize - (float)(rasterized.m_yOffset + rasterized.m_height);
+		glyph.m_quad.m_maxY = m_fontSize - (float)rasterized.m_yOffset;
+		glyph.m_quad.m_uvMins = Vec2( (float)(cellX + 1) / (float)m_atlasWidth, (float)(cellY + 1 + rasterized.m_height) / (float)m_atlasHeight );
+		glyph.m_quad.m_uvMaxs = Vec2( (float)(cellX + 1 + rasterized.m_width) / (float)m_atlasWidth, (float)(cellY + 1) / (float)m_atlasHeight );
+		glyph.m_state = CachedGlyphState::RESIDENT;
+		glyph.m_cell = cell;
+		m_cellCodepoints[cell] = rasterized.m_codepoint;
+		LinkCellAtFront( cell );
+		++m_residentCount;
+		hasChanged = true;
+	}
+	m_rasterized.erase( m_rasterized.begin(), m_rasterized.begin() + index );
+	if (hasChanged) {
+		++m_generation;
+	}
+}
+
+uint64_t GlyphCache::GetGeneration() const
+{
+	return m_generation.load( std::memory_order_relaxed );
+}
+
+uint32_t GlyphCache::GetCellCount() const
+{
+	return (uint32_t)m_cellXs.size();
+}
+
+uint32_t GlyphCache::GetResidentCount() const
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	return m_residentCount;
+}
+
+void GlyphCache::WorkerMain()
+{
+	Profiler::SetThreadName( "Glyph cache" );
+	while (true) {
+		int codepoint = 0;
+		{
+			std::unique_lock<std::mutex> lock( m_mutex );
+			m_requestCondition.wait( lock, [this]() { return m_isStopping || !m_requests.empty(); } );
+			if (m_isStopping) {
+				return;
+			}
+			codepoint = m_requests.front();
+			m_requests.pop_front();
+		}
+		RasterizedGlyph rasterized = RasterizeGlyph( codepoint );
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_rasterized.push_back( std::move( rasterized ) );
+	}
+}
+
+RasterizedGlyph GlyphCache::RasterizeGlyph( int codepoint ) const
+{
+	PROFILE_SCOPE( "GlyphCache::RasterizeGlyph" );
+	stbtt_fontinfo const* fontInfo = (stbtt_fontinfo const*)m_fontInfo;
+	RasterizedGlyph rasterized;
+	rasterized.m_codepoint = codepoint;
+	int advance, lsb;
+	stbtt_GetCodepointHMetrics( fontInfo, codepoint, &advance, &lsb );
+	rasterized.m_advance = (float)advance * m_scale;
+	if (stbtt_FindGlyphIndex( fontInfo, codepoint ) == 0) {
+		return rasterized;
+	}
+
+	int width = 0, height = 0, xOffset = 0, yOffset = 0;
+	unsigned char* distances = nullptr;
+	if (m_atlasMode == FontAtlasMode::SDF) {
+		float pixelDistanceScale = (float)FONT_SDF_ON_EDGE_VALUE / (float)FONT_SDF_PADDING;
+		distances = stbtt_GetCodepointSDF( fontInfo, m_scale, codepoint, FONT_SDF_PADDING, FONT_SDF_ON_EDGE_VALUE, pixelDistanceScale, &width, &height, &xOffset, &yOffset );
+		if (!distances) {
+			return rasterized;
+		}
+	}
+	else {
+		int x0, y0, x1, y1;
+		stbtt_GetCodepointBitmapBox( fontInfo, codepoint, m_scale, m_scale, &x0, &y0, &x1, &y1 );
+		width = x1 - x0;
+		height = y1 - y0;
+		xOffset = x0;
+		yOffset = y0;
+	}
+	if (width <= 0 || height <= 0 || width > m_cellSize - 2 || height > m_cellSize - 2) {
+		stbtt_FreeSDF( distances, nullptr );
+		return rasterized;
+	}
+	std::vector<unsigned char> alphas( (size_t)width * height );
+	if (distances) {
+		memcpy( alphas.data(), distances, alphas.size() );
+		stbtt_FreeSDF( distances, nullptr );
+	}
+	else {
+		stbtt_MakeCodepointBitmap( fontInfo, alphas.data(), width, height, width, m_scale, m_scale, codepoint );
+	}
+
+	// the whole cell is uploaded so the glyph evicted before leaves nothing behind, white with the glyph in the alpha
+	rasterized.m_pixels.assign( (size_t)m_cellSize * m_cellSize * 4, 255 );
+	for (size_t i = 3; i < rasterized.m_pixels.size(); i += 4) {
+		rasterized.m_pixels[i] = 0;
+	}
+	for (int row = 0; row < height; ++row) {
+		unsigned char* dest = &rasterized.m_pixels[((size_t)(row + 1) * m_cellSize + 1) * 4 + 3];
+		for (int column = 0; column < width; ++column) {
+			dest[column * 4] = alphas[(size_t)row * width + column];
+		}
+	}
+	rasterized.m_hasQuad = true;
+	rasterized.m_xOffset = xOffset;
+	rasterized.m_yOffset = yOffset;
+	rasterized.m_width = width;
+	rasterized.m_height = height;
+	return rasterized;
+}
+
+int GlyphCache::AcquireCell()
+{
+	if (!m_freeCells.empty()) {
+		int cell = m_freeCells.back();
+		m_freeCells.pop_back();
+		return cell;
+	}
+	if (m_lruTail < 0) {
+		return -1;
+	}
+	// evict the least recently used glyph, it is rasterized again the next time text asks for it
+	int cell = m_lruTail;
+	UnlinkCell( cell );
+	m_glyphs.erase( m_cellCodepoints[cell] );
+	m_cellCodepoints[cell] = -1;
+	--m_residentCount;
+	return cell;
+}
+
+void GlyphCache::TouchCell( int cell )
+{
+	if (m_lruHead == cell) {
+		return;
+	}
+	UnlinkCell( cell );
+	LinkCellAtFront( cell );
+}
+
+void GlyphCache::UnlinkCell( int cell )
+{
+	int prev = m_lruPrev[cell];
+	int next = m_lruNext[cell];
+	if (prev >= 0) {
+		m_lruNext[prev] = next;
+	}
+	else {
+		m_lruHead = next;
+	}
+	if (next >= 0) {
+		m_lruPrev[next] = prev;
+	}
+	else {
+		m_lruTail = prev;
+	}
+	m_lruPrev[cell] = -1;
+	m_lruNext[cell] = -1;
+}
+
+void GlyphCache::LinkCellAtFront( int cell )
+{
+	m_lruPrev[cell] = -1;
+	m_lruNext[cell] = m_lruHead;
+	if (m_lruHead >= 0) {
+		m_lruPrev[m_lruHead] = cell;
+	}
+	m_lruHead = cell;
+	if (m_lruTail < 0) {
+		m_lruTail = cell;
+	}
+}
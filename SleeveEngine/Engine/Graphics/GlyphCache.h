@@ -0,0 +1,116 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "Graphics/Font.h"
+
+class Texture;
+
+/// cells are this much larger than the atlas font size, glyphs that do not fit have no quad
+constexpr float GLYPH_CACHE_CELL_SCALE = 1.25f;
+/// rasterized glyphs copied into the atlas per Update at most, the rest wait for the next frames
+constexpr uint32_t GLYPH_CACHE_MAX_UPLOADS_PER_UPDATE = 32;
+
+/// Quad of one glyph in atlas pixels at the font's atlas size relative to the pen, y up, same layout as FontGlyphTable
+struct GlyphQuad {
+	float m_minX = 0.f;
+	float m_minY = 0.f;
+	float m_maxX = 0.f;
+	float m_maxY = 0.f;
+	float m_advance = 0.f;
+	Vec2 m_uvMins;
+	Vec2 m_uvMaxs;
+};
+
+enum class CachedGlyphState : uint8_t {
+	RASTERIZING,
+	RESIDENT,
+	/// not in the font, empty or too large for a cell: the glyph only advances the pen
+	NO_QUAD,
+};
+
+struct CachedGlyph {
+	CachedGlyphState m_state = CachedGlyphState::RASTERIZING;
+	int m_cell = -1;
+	GlyphQuad m_quad;
+};
+
+/// Cell sized RGBA pixels of a glyph made on the worker thread, waiting for a cell and the upload
+struct RasterizedGlyph {
+	int m_codepoint = 0;
+	bool m_hasQuad = false;
+	int m_xOffset = 0;
+	int m_yOffset = 0;
+	int m_width = 0;
+	int m_height = 0;
+	float m_advance = 0.f;
+	std::vector<unsigned char> m_pixels;
+};
+
+/// Glyphs outside of the static ASCII table of a Font, made on demand in the free part of the font atlas
+/// The atlas outside of the static region is a grid of equal cells, so any evicted cell fits any new glyph
+/// Layout asks for glyphs with GetGlyph, missing ones are rasterized on a worker thread and copied into their cell
+/// by Update with texture region updates, the least recently asked for glyph gives up its cell when none is free
+/// Every change of the resident glyphs increments the generation, text laid out with an older generation is laid out again
+class GlyphCache {
+public:
+	/// fontInfo is the stbtt_fontinfo of the font, only read, atlas pixels below reservedWidth x reservedHeight are never used
+	GlyphCache( void const* fontInfo, FontAtlasMode atlasMode, float fontSize, int atlasWidth, int atlasHeight, int reservedWidth, int reservedHeight );
+	~GlyphCache();
+	GlyphCache( GlyphCache const& glyphCache ) = delete;
+
+	/// false while the glyph is rasterized or if it has no quad, the pen still advances by the glyph advance then
+	/// any thread, marks the glyph as recently used
+	bool GetGlyph( int codepoint, GlyphQuad& out_quad );
+	/// main thread, before the renderer's BeginFrame so the copies are in the same frame as the text using them
+	void Update( Texture* atlasTexture );
+
+	uint64_t GetGeneration() const;
+	uint32_t GetCellCount() const;
+	uint32_t GetResidentCount() const;
+
+protected:
+	void WorkerMain();
+	RasterizedGlyph RasterizeGlyph( int codepoint ) const;
+	/// a free cell or the cell of the least recently used glyph, -1 if the atlas has no cells
+	int AcquireCell();
+	void TouchCell( int cell );
+	void UnlinkCell( int cell );
+	void LinkCellAtFront( int cell );
+
+	void const* m_fontInfo = nullptr;
+	FontAtlasMode m_atlasMode = FontAtlasMode::BITMAP;
+	float m_scale = 0.f;
+	float m_fontSize = 0.f;
+	int m_atlasWidth = 0;
+	int m_atlasHeight = 0;
+	int m_cellSize = 0;
+
+	/// guards everything below except the generation
+	mutable std::mutex m_mutex;
+	std::unordered_map<int, CachedGlyph> m_glyphs;
+	/// cell index to the pixel position in the atlas and the codepoint living in it, -1 if free
+	std::vector<int> m_cellXs;
+	std::vector<int> m_cellYs;
+	std::vector<int> m_cellCodepoints;
+	std::vector<int> m_freeCells;
+	/// least recently used list of the occupied cells, the head is the most recently used
+	std::vector<int> m_lruPrev;
+	std::vector<int> m_lruNext;
+	int m_lruHead = -1;
+	int m_lruTail = -1;
+	uint32_t m_residentCount = 0;
+
+	std::deque<int> m_requests;
+	std::vector<RasterizedGlyph> m_rasterized;
+	std::condition_variable m_requestCondition;
+	bool m_isStopping = false;
+	std::thread m_worker;
+
+	std::atomic<uint64_t> m_generation = 0;
+};
@@ -0,0 +1,247 @@
+#include "Graphics/GpuProfiler.h"
+#include "Core/Error.h"
+#include "Core/Profiler.h"
+
+#include <algorithm>
+
+constexpr uint32_t GPU_PROFILER_MAX_TIMESTAMPS = 128; // per queue and frame, two for each section
+constexpr uint32_t GPU_PROFILER_SKIPPED_SECTION = UINT32_MAX;
+constexpr VkQueryPipelineStatisticFlags GPU_PROFILER_PIPELINE_STATISTICS =
+	VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT | VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+	VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+	VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+static uint64_t GetTimestampMask( uint32_t validBits )
+{
+	return validBits >= 64 ? UINT64_MAX : (1ull << validBits) - 1;
+}
+
+GpuProfiler::GpuProfiler( VkDevice device, VkPhysicalDevice physicalDevice, uint32_t graphicsFamily, uint32_t transferFamily, bool usePipelineStatistics )
+	:m_device( device ), m_usePipelineStatistics( usePipelineStatistics )
+{
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties( physicalDevice, &properties );
+	m_nanosecondsPerTick = properties.limits.timestampPeriod;
+
+	uint32_t queueFamilyCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties( physicalDevice, &queueFamilyCount, nullptr );
+	std::vector<VkQueueFamilyProperties> queueFamilies( queueFamilyCount );
+	vkGetPhysicalDeviceQueueFamilyProperties( physicalDevice, &queueFamilyCount, queueFamilies.data() );
+
+	uint32_t graphicsValidBits = queueFamilies[graphicsFamily].timestampValidBits;
+	uint32_t transferValidBits = queueFamilies[transferFamily].timestampValidBits;
+	m_graphicsTimestampMask = GetTimestampMask( graphicsValidBits );
+	m_transferTimestampMask = GetTimestampMask( transferValidBits );
+	// query pools can only be reset on graphics or compute queues, a dedicated transfer queue is not timed
+	m_isTransferTimed = transferValidBits > 0 && (queueFamilies[transferFamily].queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT));
+
+	for (FrameQueries& frame : m_frames) {
+		if (graphicsValidBits > 0) {
+			frame.m_graphics.m_pool = CreateTimestampPool();
+		}
+		if (m_isTransferTimed) {
+			frame.m_transfer.m_pool = CreateTimestampPool();
+		}
+		if (m_usePipelineStatistics) {
+			VkQueryPoolCreateInfo poolInfo{};
+			poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+			poolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+			poolInfo.queryCount = 1;
+			poolInfo.pipelineStatistics = GPU_PROFILER_PIPELINE_STATISTICS;
+			ASSERT_OR_ERROR( vkCreateQueryPool( m_device, &poolInfo, nullptr, &frame.m_pipelineStatisticsPool ) == VK_SUCCESS, "failed to create pipeline statistics query pool!" );
+		}
+	}
+}
+
+GpuProfiler::~GpuProfiler()
+{
+	for (FrameQueries& frame : m_frames) {
+		vkDestroyQueryPool( m_device, frame.m_graphics.m_pool, nullptr );
+		vkDestroyQueryPool( m_device, frame.m_transfer.m_pool, nullptr );
+		vkDestroyQueryPool( m_device, frame.m_pipelineStatisticsPool, nullptr );
+	}
+}
+
+VkQueryPool GpuProfiler::CreateTimestampPool()
+{
+	VkQueryPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	poolInfo.queryCount = GPU_PROFILER_MAX_TIMESTAMPS;
+
+	VkQueryPool pool = VK_NULL_HANDLE;
+	ASSERT_OR_ERROR( vkCreateQueryPool( m_device, &poolInfo, nullptr, &pool ) == VK_SUCCESS, "failed to create timestamp query pool!" );
+	return pool;
+}
+
+void GpuProfiler::CollectResults( uint32_t frameIndex )
+{
+	FrameQueries& frame = m_frames[frameIndex];
+	if (!frame.m_isPending) {
+		return;
+	}
+	frame.m_isPending = false;
+
+	struct RawSection {
+		char const* m_name;
+		uint64_t m_begin;
+		uint64_t m_end;
+		uint32_t m_depth;
+		bool m_isTransfer;
+	};
+	std::vector<RawSection> rawSections;
+	auto readQueue = [&]( QueueQueries const& queries, uint64_t mask, bool isTransfer ) {
+		if (queries.m_numOfQueries == 0) {
+			return true;
+		}
+		m_results.resize( queries.m_numOfQueries );
+		// no WAIT flag: the frame fences are signaled, if a result is still missing the frame is skipped instead of stalling
+		if (vkGetQueryPoolResults( m_device, queries.m_pool, 0, queries.m_numOfQueries, m_results.size() * sizeof( uint64_t ), m_results.data(), sizeof( uint64_t ), VK_QUERY_RESULT_64_BIT ) != VK_SUCCESS) {
+			return false;
+		}
+		for (Section const& section : queries.m_sections) {
+			if (section.m_endQuery != GPU_PROFILER_SKIPPED_SECTION) {
+				rawSections.push_back( RawSection{ section.m_name, m_results[section.m_beginQuery] & mask, m_results[section.m_endQuery] & mask, section.m_depth, isTransfer } );
+			}
+		}
+		return true;
+	};
+	if (!readQueue( frame.m_graphics, m_graphicsTimestampMask, false ) || !readQueue( frame.m_transfer, m_transferTimestampMask, true )) {
+		return;
+	}
+
+	GpuFrameTimings timings;
+	timings.m_frameNumber = frame.m_frameNumber;
+	if (frame.m_isPipelineStatisticsWritten) {
+		std::array<uint64_t, 5> statistics = {};
+		if (vkGetQueryPoolResults( m_device, frame.m_pipelineStatisticsPool, 0, 1, sizeof( statistics ), statistics.data(), sizeof( statistics ), VK_QUERY_RESULT_64_BIT ) == VK_SUCCESS) {
+			// results are in the order of the statistic bits
+			timings.m_hasPipelineStatistics = true;
+			timings.m_pipelineStatistics.m_inputAssemblyVertices = statistics[0];
+			timings.m_pipelineStatistics.m_inputAssemblyPrimitives = statistics[1];
+			timings.m_pipelineStatistics.m_vertexShaderInvocations = statistics[2];
+			timings.m_pipelineStatistics.m_clippingPrimitives = statistics[3];
+			timings.m_pipelineStatistics.m_fragmentShaderInvocations = statistics[4];
+		}
+	}
+
+	uint64_t baseTimestamp = UINT64_MAX;
+	for (RawSection const& section : rawSections) {
+		baseTimestamp = std::min( baseTimestamp, section.m_begin );
+	}
+	for (RawSection const& section : rawSections) {
+		double startNanoseconds = (double)(section.m_begin - baseTimestamp) * m_nanosecondsPerTick;
+		double durationNanoseconds = section.m_end > section.m_begin ? (double)(section.m_end - section.m_begin) * m_nanosecondsPerTick : 0.0;
+		timings.m_sections.push_back( GpuSectionTiming{ section.m_name, startNanoseconds * 1e-6, durationNanoseconds * 1e-6, section.m_depth } );
+#ifndef NO_PROFILER
+		// GPU and CPU clocks are not calibrated, the first timestamp of the frame is placed at its submission
+		int64_t cpuStart = frame.m_cpuSubmitNanoseconds + (int64_t)startNanoseconds;
+		Profiler::AddTrackZone( section.m_isTransfer ? "GPU transfer" : "GPU graphics", section.m_name, cpuStart, cpuStart + (int64_t)durationNanoseconds );
+#endif
+	}
+	m_lastFrameTimings = std::move( timings );
+}
+
+void GpuProfiler::BeginFrame( uint32_t frameIndex, VkCommandBuffer graphicsCommandBuffer, VkCommandBuffer transferCommandBuffer )
+{
+	m_currentFrame = frameIndex;
+	FrameQueries& frame = m_frames[frameIndex];
+	frame.m_frameNumber = m_frameNumber++;
+	frame.m_isPipelineStatisticsWritten = false;
+
+	auto resetQueue = [&]( QueueQueries& queries, VkCommandBuffer commandBuffer ) {
+		queries.m_commandBuffer = commandBuffer;
+		queries.m_numOfQueries = 0;
+		queries.m_sections.clear();
+		queries.m_openSections.clear();
+		if (queries.m_pool != VK_NULL_HANDLE) {
+			vkCmdResetQueryPool( commandBuffer, queries.m_pool, 0, GPU_PROFILER_MAX_TIMESTAMPS );
+		}
+	};
+	resetQueue( frame.m_graphics, graphicsCommandBuffer );
+	resetQueue( frame.m_transfer, transferCommandBuffer );
+	if (frame.m_pipelineStatisticsPool != VK_NULL_HANDLE) {
+		vkCmdResetQueryPool( graphicsCommandBuffer, frame.m_pipelineStatisticsPool, 0, 1 );
+	}
+}
+
+void GpuProfiler::EndFrame( uint32_t frameIndex )
+{
+	FrameQueries& frame = m_frames[frameIndex];
+	ASSERT_OR_ERROR( frame.m_graphics.m_openSections.empty() && frame.m_transfer.m_openSections.empty(), "GPU section is not ended in the frame it began!" );
+	frame.m_cpuSubmitNanoseconds = Profiler::GetTimestamp();
+	frame.m_isPending = true;
+}
+
+void GpuProfiler::BeginSection( QueueQueries& queries, char const* name )
+{
+	// out of queries: keep the section stack balanced but record nothing
+	if (queries.m_pool == VK_NULL_HANDLE || queries.m_numOfQueries + 2 > GPU_PROFILER_MAX_TIMESTAMPS) {
+		queries.m_openSections.push_back( GPU_PROFILER_SKIPPED_SECTION );
+		return;
+	}
+	Section& section = queries.m_sections.emplace_back();
+	section.m_name = name;
+	section.m_beginQuery = queries.m_numOfQueries++;
+	section.m_endQuery = GPU_PROFILER_SKIPPED_SECTION;
+	section.m_depth = (uint32_t)queries.m_openSections.size();
+	// reserve the end query now so nested sections can never use it up
+	++queries.m_numOfQueries;
+	vkCmdWriteTimestamp( queries.m_commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queries.m_pool, section.m_beginQuery );
+	queries.m_openSections.push_back( (uint32_t)queries.m_sections.size() - 1 );
+}
+
+void GpuProfiler::EndSection( QueueQueries& queries )
+{
+	ASSERT_OR_ERROR( !queries.m_openSections.empty(), "GPU section end without begin!" );
+	uint32_t sectionIndex = queries.m_openSections.back();
+	queries.m_openSections.pop_back();
+	if (sectionIndex == GPU_PROFILER_SKIPPED_SECTION) {
+		return;
+	}
+	Section& section = queries.m_sections[sectionIndex];
+	section.m_endQuery = section.m_beginQuery + 1;
+	vkCmdWriteTimestamp( queries.m_commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queries.m_pool, section.m_endQuery );
+}
+
+void GpuProfiler::BeginGraphicsSection( char const* name )
+{
+	BeginSection( m_frames[m_currentFrame].m_graphics, name );
+}
+
+void GpuProfiler::EndGraphicsSection()
+{
+	EndSection( m_frames[m_currentFrame].m_graphics );
+}
+
+void GpuProfiler::BeginTransferSection( char const* name )
+{
+	BeginSection( m_frames[m_currentFrame].m_transfer, name );
+}
+
+void GpuProfiler::EndTransferSection()
+{
+	EndSection( m_frames[m_currentFrame].m_transfer );
+}
+
+void GpuProfiler::BeginPipelineStatistics()
+{
+	FrameQueries& frame = m_frames[m_currentFrame];
+	if (frame.m_pipelineStatisticsPool != VK_NULL_HANDLE) {
+		vkCmdBeginQuery( frame.m_graphics.m_commandBuffer, frame.m_pipelineStatisticsPool, 0, 0 );
+	}
+}
+
+void GpuProfiler::EndPipelineStatistics()
+{
+	FrameQueries& frame = m_frames[m_currentFrame];
+	if (frame.m_pipelineStatisticsPool != VK_NULL_HANDLE) {
+		vkCmdEndQuery( frame.m_graphics.m_commandBuffer, frame.m_pipelineStatisticsPool, 0 );
+		frame.m_isPipelineStatisticsWritten = true;
+	}
+}
+
+GpuFrameTimings const& GpuProfiler::GetLastFrameTimings() const
+{
+	return m_lastFrameTimings;
+}
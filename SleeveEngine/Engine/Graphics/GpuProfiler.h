@@ -0,0 +1,73 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <array>
+#include <vector>
+#include "Graphics/GraphicsCommon.h"
+
+/// Timestamp and pipeline statistics queries with one set of query pools per frame in flight
+/// Results are read when the renderer reuses a frame slot, after its fences were waited, so reading never stalls
+class GpuProfiler {
+	friend class Renderer;
+
+	GpuProfiler( VkDevice device, VkPhysicalDevice physicalDevice, uint32_t graphicsFamily, uint32_t transferFamily, bool usePipelineStatistics );
+	GpuProfiler( GpuProfiler const& profiler ) = delete;
+	~GpuProfiler();
+
+	/// read the results of the frame slot, its fences must be signaled
+	void CollectResults( uint32_t frameIndex );
+	/// reset the queries of the frame slot, called right after the command buffers began
+	void BeginFrame( uint32_t frameIndex, VkCommandBuffer graphicsCommandBuffer, VkCommandBuffer transferCommandBuffer );
+	/// remember the CPU time of the submission to place the frame on the profiler timeline
+	void EndFrame( uint32_t frameIndex );
+
+	void BeginGraphicsSection( char const* name );
+	void EndGraphicsSection();
+	void BeginTransferSection( char const* name );
+	void EndTransferSection();
+	void BeginPipelineStatistics();
+	void EndPipelineStatistics();
+
+	GpuFrameTimings const& GetLastFrameTimings() const;
+
+	struct Section {
+		char const* m_name = nullptr;
+		uint32_t m_beginQuery = 0;
+		uint32_t m_endQuery = 0;
+		uint32_t m_depth = 0;
+	};
+
+	/// queries of one queue in one frame slot
+	struct QueueQueries {
+		VkQueryPool m_pool = VK_NULL_HANDLE;
+		VkCommandBuffer m_commandBuffer = VK_NULL_HANDLE;
+		uint32_t m_numOfQueries = 0;
+		std::vector<Section> m_sections;
+		std::vector<uint32_t> m_openSections;
+	};
+
+	struct FrameQueries {
+		QueueQueries m_graphics;
+		QueueQueries m_transfer;
+		VkQueryPool m_pipelineStatisticsPool = VK_NULL_HANDLE;
+		bool m_isPipelineStatisticsWritten = false;
+		bool m_isPending = false;
+		uint64_t m_frameNumber = 0;
+		int64_t m_cpuSubmitNanoseconds = 0;
+	};
+
+	void BeginSection( QueueQueries& queries, char const* name );
+	void EndSection( QueueQueries& queries );
+	VkQueryPool CreateTimestampPool();
+
+	VkDevice m_device = VK_NULL_HANDLE;
+	double m_nanosecondsPerTick = 1.0;
+	uint64_t m_graphicsTimestampMask = 0;
+	uint64_t m_transferTimestampMask = 0;
+	bool m_isTransferTimed = false;
+	bool m_usePipelineStatistics = false;
+	uint32_t m_currentFrame = 0;
+	uint64_t m_frameNumber = 0;
+	std::array<FrameQueries, MAX_FRAMES_IN_FLIGHT> m_frames;
+	GpuFrameTimings m_lastFrameTimings;
+	std::vector<uint64_t> m_results;
+};
@@ -28,6 +28,28 @@ struct VertexBufferBinding {
 	uint32_t m_vertexBufferVertexCount = 0;
 };
 
+/// Vertices in the transient ring of the current frame, write them before the binding is drawn in the same frame
+struct TransientVertexAllocation {
+	/// of the vertex struct of the format asked for
+	void* m_vertices = nullptr;
+	uint32_t m_vertexSize = 0;
+	VertexBufferBinding m_binding;
+};
+
+/// Transient vertex ring of one frame in flight, reset once the frame's fence signaled
+struct TransientVertexFrame {
+	VertexBuffer* m_buffer = nullptr;
+	uint64_t m_usedBytes = 0;
+	/// buffers this frame outgrew, its draws still read them until the fence signals
+	std::vector<VertexBuffer*> m_retiredBuffers;
+};
+
+/// quads are 4 vertices drawn as the triangles 0 1 2 and 2 3 0 with the renderer's shared quad index buffer
+constexpr uint32_t QUAD_VERTEX_COUNT = 4;
+constexpr uint32_t QUAD_INDEX_COUNT = 6;
+/// quads the shared quad index buffer holds, as many as 16 bit indices can address, longer draws are split
+constexpr uint32_t QUAD_INDEX_BUFFER_QUAD_COUNT = 65536 / QUAD_VERTEX_COUNT;
+
 struct IndexBufferBinding {
 	IndexBuffer* m_indexBuffer = nullptr;
 	uint64_t m_indexBufferOffset = 0;
@@ -60,6 +82,16 @@ struct BufferCopyCommand {
 	uint64_t m_size;
 };
 
+/// Texture rectangle waiting to be copied from the pending pixels at the next BeginFrame
+struct TextureRegionUpdate {
+	Texture* m_texture;
+	uint32_t m_x;
+	uint32_t m_y;
+	uint32_t m_width;
+	uint32_t m_height;
+	uint64_t m_pixelOffset;
+};
+
 struct BufferPendingToDestroy {
 	VkBuffer m_buffer;
 	VkDeviceMemory m_deviceMemory;
@@ -67,11 +99,67 @@ struct BufferPendingToDestroy {
 	int m_destroyCount = 0;
 };
 
+struct GpuSectionTiming {
+	char const* m_name = nullptr;
+	/// relative to the first timestamp of the frame
+	double m_startMilliseconds = 0.0;
+	double m_durationMilliseconds = 0.0;
+	uint32_t m_depth = 0;
+};
+
+struct GpuPipelineStatistics {
+	uint64_t m_inputAssemblyVertices = 0;
+	uint64_t m_inputAssemblyPrimitives = 0;
+	uint64_t m_vertexShaderInvocations = 0;
+	uint64_t m_clippingPrimitives = 0;
+	uint64_t m_fragmentShaderInvocations = 0;
+};
+
+struct GpuFrameTimings {
+	/// number of the frame the queries were recorded in, frames without results keep the older timings
+	uint64_t m_frameNumber = 0;
+	std::vector<GpuSectionTiming> m_sections;
+	bool m_hasPipelineStatistics = false;
+	GpuPipelineStatistics m_pipelineStatistics;
+};
+
+/// Free list state of a shared buffer, fragmentation is high when the free bytes are split into many small blocks
+struct SharedBufferOccupancy {
+	uint64_t m_size = 0;
+	uint64_t m_usedBytes = 0;
+	uint64_t m_freeBlockCount = 0;
+	uint64_t m_largestFreeBlock = 0;
+};
+
+/// CPU side work the renderer did in one frame, shared buffer occupancy is taken at the end of the frame
+struct RendererFrameStatistics {
+	uint64_t m_draws = 0;
+	uint64_t m_instancedDraws = 0;
+	uint64_t m_pipelineBinds = 0;
+	uint64_t m_descriptorSetsAllocated = 0;
+	uint64_t m_descriptorSetWrites = 0;
+	uint64_t m_vertexBytesDrawn = 0;
+	uint64_t m_indexBytesDrawn = 0;
+	uint64_t m_vertexUploadBytes = 0;
+	uint64_t m_indexUploadBytes = 0;
+	uint64_t m_uniformUploadBytes = 0;
+	uint64_t m_textureUploadBytes = 0;
+	uint64_t m_transientVertexBytes = 0;
+	uint64_t m_stagingBytesUsed = 0;
+	uint64_t m_copyCommands = 0;
+	/// buffers waiting for the GPU to finish with them before they are destroyed
+	uint64_t m_pendingDeletions = 0;
+	SharedBufferOccupancy m_sharedVertexBuffer;
+	SharedBufferOccupancy m_sharedIndexBuffer;
+	SharedBufferOccupancy m_sharedUniformBuffer;
+};
+
 constexpr uint32_t WINDOW_WIDTH = 2000;
 constexpr uint32_t WINDOW_HEIGHT = 1000;
 constexpr int MAX_FRAMES_IN_FLIGHT = 2;
 constexpr uint64_t INITIAL_SHARED_VERTEX_BUFFER_MAX_SIZE = 1000000; // around 1MB
 constexpr uint64_t INITIAL_SHARED_INDEX_BUFFER_MAX_SIZE = 100000; // around 100KB
+constexpr uint64_t INITIAL_TRANSIENT_VERTEX_BUFFER_SIZE = 1048576; // per frame in flight, doubles when a frame needs more
 constexpr uint64_t STAGING_BUFFER_MAX_SIZE = 64000000; // around 64MB
 constexpr uint64_t INITIAL_MODEL_UNIFORM_BUFFER_MAX_COUNT = 16384;
 constexpr uint64_t INITIAL_MODEL_UNIFORM_BUFFER_MAX_SIZE = sizeof( ModelUniformBufferObject ) * INITIAL_MODEL_UNIFORM_BUFFER_MAX_COUNT;
\ No newline at end of file
@@ -7,11 +7,14 @@ class IndexBuffer {
 public:
 	~IndexBuffer()
 	{
-		vkDestroyBuffer( m_device, m_buffer, nullptr );
-		vkFreeMemory( m_device, m_deviceMemory, nullptr );
+		if (m_device) {
+			vkDestroyBuffer( m_device, m_buffer, nullptr );
+			vkFreeMemory( m_device, m_deviceMemory, nullptr );
+		}
 	};
 protected:
 	friend class Renderer;
+	friend class NullRenderer;
 	IndexBuffer( VkDevice device, uint32_t indexCount, uint64_t size );;
 	bool FindProperPositionForSizeInBuffer( uint64_t& out_pos, uint64_t size );
 	void EnlargeBuffer( uint64_t newSize );
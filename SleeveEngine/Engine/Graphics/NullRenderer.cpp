@@ -0,0 +1,492 @@
+#include "Graphics/NullRenderer.h"
+#include "Graphics/GraphicsFwd.h"
+
+#include <cstdio>
+
+void NullRenderer::Initialize( RendererConfig const& config )
+{
+	m_config = config;
+	m_sharedMeshVertexBuffer = new VertexBuffer( VK_NULL_HANDLE, INITIAL_SHARED_VERTEX_BUFFER_MAX_SIZE );
+	m_sharedMeshVertexBuffer->m_stride = sizeof( VertexPCU3D );
+	m_sharedMeshIndexBuffer = new IndexBuffer( VK_NULL_HANDLE, 0, INITIAL_SHARED_INDEX_BUFFER_MAX_SIZE );
+	for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+		m_sharedModelUniformBuffers[i] = new UniformBuffer( VK_NULL_HANDLE, INITIAL_MODEL_UNIFORM_BUFFER_MAX_SIZE );
+		m_sharedModelUniformBuffers[i]->m_stride = sizeof( ModelUniformBufferObject );
+		m_transientVertexFrames[i].m_buffer = CreateDynamicVertexBuffer( INITIAL_TRANSIENT_VERTEX_BUFFER_SIZE );
+	}
+}
+
+void NullRenderer::Cleanup()
+{
+	delete m_sharedMeshVertexBuffer;
+	m_sharedMeshVertexBuffer = nullptr;
+	delete m_sharedMeshIndexBuffer;
+	m_sharedMeshIndexBuffer = nullptr;
+	for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+		delete m_sharedModelUniformBuffers[i];
+		m_sharedModelUniformBuffers[i] = nullptr;
+		TransientVertexFrame& frame = m_transientVertexFrames[i];
+		for (VertexBuffer* buffer : frame.m_retiredBuffers) {
+			DestroyHostVertexBuffer( buffer );
+		}
+		frame.m_retiredBuffers.clear();
+		DestroyHostVertexBuffer( frame.m_buffer );
+		frame.m_buffer = nullptr;
+	}
+	m_hostMemories.clear();
+	// nothing to report if it was only used for its allocators
+	if (m_totalCounters.m_frames > 0) {
+		PrintCounters( "Null renderer" );
+	}
+}
+
+void NullRenderer::WaitForCleanup()
+{
+}
+
+void NullRenderer::BeginFrame()
+{
+	m_currentShader = nullptr;
+	TransientVertexFrame& frame = m_transientVertexFrames[m_currentFrame];
+	for (VertexBuffer* buffer : frame.m_retiredBuffers) {
+		DestroyHostVertexBuffer( buffer );
+	}
+	frame.m_retiredBuffers.clear();
+	frame.m_usedBytes = 0;
+}
+
+void NullRenderer::EndFrame()
+{
+	// calls made before the first frame (loading) are counted in the first frame
+	m_frameCounters.m_frames = 1;
+	AddFrameCountersToTotal();
+	// no staging, copies or deferred deletions without a device, those stay zero
+	RendererFrameStatistics statistics;
+	statistics.m_draws = m_frameCounters.m_draws + m_frameCounters.m_indexedDraws;
+	statistics.m_pipelineBinds = m_frameCounters.m_shaderBinds;
+	statistics.m_descriptorSetsAllocated = m_frameCounters.m_drawCommands;
+	statistics.m_descriptorSetWrites = m_frameCounters.m_drawCommands;
+	statistics.m_vertexBytesDrawn = m_frameCounters.m_vertexBytesDrawn;
+	statistics.m_indexBytesDrawn = m_frameCounters.m_indicesDrawn * sizeof( uint16_t );
+	statistics.m_vertexUploadBytes = m_frameCounters.m_vertexUploadBytes;
+	statistics.m_indexUploadBytes = m_frameCounters.m_indexUploadBytes;
+	statistics.m_uniformUploadBytes = m_frameCounters.m_uniformBytes;
+	statistics.m_textureUploadBytes = m_frameCounters.m_textureUploadBytes;
+	statistics.m_transientVertexBytes = m_frameCounters.m_transientVertexBytes;
+	statistics.m_sharedVertexBuffer = GetSharedBufferOccupancy( m_sharedMeshVertexBuffer->m_memoryBlocks, m_sharedMeshVertexBuffer->m_maxSize );
+	statistics.m_sharedIndexBuffer = GetSharedBufferOccupancy( m_sharedMeshIndexBuffer->m_memoryBlocks, m_sharedMeshIndexBuffer->m_maxSize );
+	UniformBuffer const* uniformBuffer = m_sharedModelUniformBuffers[m_currentFrame];
+	statistics.m_sharedUniformBuffer = GetSharedBufferOccupancy( uniformBuffer->m_memoryBlocks, uniformBuffer->m_maxSize );
+	m_statisticsHistory.AddFrame( statistics );
+	m_lastFrameCounters = m_frameCounters;
+	m_frameCounters = NullRendererCounters();
+	m_currentFrame = (m_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+}
+
+void NullRenderer::BeginCamera( Camera const* camera )
+{
+	++m_frameCounters.m_cameras;
+}
+
+void NullRenderer::EndCamera( Camera const* camera )
+{
+
+}
+
+float NullRenderer::GetSwapChainExtentRatio() const
+{
+	return m_config.m_offscreenWidth / (float)m_config.m_offscreenHeight;
+}
+
+void NullRenderer::DrawSingleBufferIndexed( VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, uint64_t vertexOffset, uint64_t indexOffset )
+{
+	++m_frameCounters.m_indexedDraws;
+	m_frameCounters.m_indicesDrawn += indexBuffer->m_indexCount;
+}
+
+void NullRenderer::Draw( VertexBufferBinding const& vertexBinding )
+{
+	++m_frameCounters.m_draws;
+	m_frameCounters.m_verticesDrawn += vertexBinding.m_vertexBufferVertexCount;
+	m_frameCounters.m_vertexBytesDrawn += (uint64_t)vertexBinding.m_vertexBufferVertexCount * GetBoundVertexSize();
+}
+
+void NullRenderer::DrawIndexed( VertexBufferBinding const& vertexBinding, IndexBufferBinding const& indexBinding )
+{
+	++m_frameCounters.m_indexedDraws;
+	m_frameCounters.m_indicesDrawn += indexBinding.m_indexBufferIndexCount;
+	m_frameCounters.m_vertexBytesDrawn += (uint64_t)vertexBinding.m_vertexBufferVertexCount * GetBoundVertexSize();
+}
+
+void NullRenderer::DrawQuads( VertexBufferBinding const& vertexBinding )
+{
+	uint32_t quadCount = vertexBinding.m_vertexBufferVertexCount / QUAD_VERTEX_COUNT;
+	if (quadCount == 0) {
+		return;
+	}
+	// split like the Vulkan renderer so the draw counts match
+	m_frameCounters.m_indexedDraws += (quadCount + QUAD_INDEX_BUFFER_QUAD_COUNT - 1) / QUAD_INDEX_BUFFER_QUAD_COUNT;
+	m_frameCounters.m_indicesDrawn += (uint64_t)quadCount * QUAD_INDEX_COUNT;
+	m_frameCounters.m_vertexBytesDrawn += (uint64_t)vertexBinding.m_vertexBufferVertexCount * GetBoundVertexSize();
+}
+
+void NullRenderer::BindShader( Shader* shader )
+{
+	// same filtering as the Vulkan renderer, only real pipeline changes are counted
+	if (m_currentShader != shader) {
+		m_currentShader = shader;
+		++m_frameCounters.m_shaderBinds;
+	}
+}
+
+void NullRenderer::BeginDrawCommands( UniformBufferBinding const& uniformBufferBinding, TextureBinding const& textureBinding )
+{
+	++m_frameCounters.m_drawCommands;
+}
+
+void NullRenderer::UpdateUniformBuffer( UniformBuffer* uniformBuffer, void* newData, size_t dataSize )
+{
+	++m_frameCounters.m_uniformUpdates;
+	m_frameCounters.m_uniformBytes += dataSize;
+}
+
+void NullRenderer::UpdateSharedModelUniformBuffer( UniformBufferBinding const& binding, void* newData, size_t dataSize )
+{
+	if (binding.m_flags & UNIFORM_BUFFER_USE_MODEL_CONSTANTS_BINDING_2) {
+		++m_frameCounters.m_uniformUpdates;
+		m_frameCounters.m_uniformBytes += dataSize;
+	}
+}
+
+uint32_t NullRenderer::GetCurFrameNumber() const
+{
+	return m_currentFrame;
+}
+
+uint32_t NullRenderer::GetSharedUniformGeneration() const
+{
+	// the shared model uniform buffers keep their contents, even when they grow
+	return 0;
+}
+
+Texture* NullRenderer::CreateTextureFromFile( std::string const& fileName )
+{
+	++m_totalCounters.m_texturesCreated;
+	return new Texture( VK_NULL_HANDLE );
+}
+
+Texture* NullRenderer::CreateTextureFromBuffer( unsigned char const* buffer, uint64_t size, uint32_t width, uint32_t height )
+{
+	++m_totalCounters.m_texturesCreated;
+	return new Texture( VK_NULL_HANDLE );
+}
+
+Texture* NullRenderer::CreateWhiteTexture()
+{
+	++m_totalCounters.m_texturesCreated;
+	return new Texture( VK_NULL_HANDLE );
+}
+
+void NullRenderer::UpdateTextureRegion( Texture* texture, uint32_t x, uint32_t y, uint32_t width, uint32_t height, unsigned char const* pixels )
+{
+	m_frameCounters.m_textureUploadBytes += (uint64_t)width * height * 4;
+}
+
+IndexBuffer* NullRenderer::CreateIndexBuffer( void* indexData, uint64_t size, uint32_t indexCount )
+{
+	++m_totalCounters.m_buffersCreated;
+	return new IndexBuffer( VK_NULL_HANDLE, indexCount, size );
+}
+
+VertexBuffer* NullRenderer::CreateVertexBuffer( void* vertexData, uint64_t size, uint32_t vertexCount )
+{
+	++m_totalCounters.m_buffersCreated;
+	return new VertexBuffer( VK_NULL_HANDLE, size );
+}
+
+UniformBuffer* NullRenderer::CreateUniformBuffer( uint64_t size )
+{
+	++m_totalCounters.m_buffersCreated;
+	return new UniformBuffer( VK_NULL_HANDLE, size );
+}
+
+Shader* NullRenderer::CreateShader( std::string const& fileName )
+{
+	++m_totalCounters.m_shadersCreated;
+	Shader* shader = new Shader( VK_NULL_HANDLE, nullptr );
+	shader->m_name = fileName;
+	shader->m_vertexFormat = GetShaderVertexFormat( fileName );
+	return shader;
+}
+
+Shader* NullRenderer::CreateShader( ShaderSource const& source )
+{
+	return CreateShader( source.m_name );
+}
+
+VertexBufferBinding NullRenderer::AddVertsDataToSharedVertexBuffer( void* vertexData, uint64_t size, uint32_t vertexCount )
+{
+	if (size == 0 || vertexCount == 0) {
+		return VertexBufferBinding();
+	}
+	++m_frameCounters.m_vertexUploads;
+	m_frameCounters.m_vertexUploadBytes += size;
+
+	uint64_t dstOffset;
+	if (!m_sharedMeshVertexBuffer->FindProperPositionForSizeInBuffer( dstOffset, size )) {
+		uint64_t newSize = m_sharedMeshVertexBuffer->m_maxSize;
+		do {
+			newSize *= 2;
+		} while (m_sharedMeshVertexBuffer->m_maxSize + (uint64_t)vertexCount * m_sharedMeshVertexBuffer->m_stride >= newSize);
+		m_sharedMeshVertexBuffer->EnlargeBuffer( newSize );
+		m_sharedMeshVertexBuffer->FindProperPositionForSizeInBuffer( dstOffset, size );
+	}
+
+	VertexBufferBinding binding;
+	binding.m_vertexBuffer = m_sharedMeshVertexBuffer;
+	binding.m_vertexBufferOffset = dstOffset;
+	binding.m_vertexBufferVertexCount = vertexCount;
+	return binding;
+}
+
+IndexBufferBinding NullRenderer::AddIndicesDataToSharedIndexBuffer( void* indexData, uint64_t size, uint32_t indexCount )
+{
+	if (size == 0 || indexCount == 0) {
+		return IndexBufferBinding();
+	}
+	++m_frameCounters.m_indexUploads;
+	m_frameCounters.m_indexUploadBytes += size;
+
+	uint64_t dstOffset;
+	if (!m_sharedMeshIndexBuffer->FindProperPositionForSizeInBuffer( dstOffset, size )) {
+		uint64_t newSize = m_sharedMeshIndexBuffer->m_maxSize;
+		do {
+			newSize *= 2;
+		} while (m_sharedMeshIndexBuffer->m_maxSize + indexCount * sizeof( uint16_t ) >= newSize);
+		m_sharedMeshIndexBuffer->EnlargeBuffer( newSize );
+		m_sharedMeshIndexBuffer->FindProperPositionForSizeInBuffer( dstOffset, size );
+	}
+	m_sharedMeshIndexBuffer->m_indexCount += indexCount;
+
+	IndexBufferBinding binding;
+	binding.m_indexBuffer = m_sharedMeshIndexBuffer;
+	binding.m_indexBufferOffset = dstOffset;
+	binding.m_indexBufferIndexCount = indexCount;
+	return binding;
+}
+
+UniformBufferBinding NullRenderer::AddDataToSharedUniformBuffer( UniformBufferDataBindingFlags flags )
+{
+	UniformBufferBinding binding;
+	binding.m_flags = flags;
+	if (flags & UNIFORM_BUFFER_USE_MODEL_CONSTANTS_BINDING_2) {
+		for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+			uint64_t dstOffset;
+			bool result = m_sharedModelUniformBuffers[i]->FindProperPositionForSizeInBuffer( dstOffset, sizeof( ModelUniformBufferObject ) );
+			if (!result) {
+				m_sharedModelUniformBuffers[i]->EnlargeBuffer( m_sharedModelUniformBuffers[i]->m_maxSize * 2 );
+				result = m_sharedModelUniformBuffers[i]->FindProperPositionForSizeInBuffer( dstOffset, sizeof( ModelUniformBufferObject ) );
+			}
+			if (result) {
+				binding.m_modelUniformBufferOffset = dstOffset;
+			}
+			else {
+				THROW_ERROR( "failed to allocate uniform buffer memory!" );
+			}
+		}
+	}
+	return binding;
+}
+
+void NullRenderer::ReturnMemoryToSharedBuffer( VertexBufferBinding const& vBinding, IndexBufferBinding const& iBinding, UniformBufferBinding const& uBinding )
+{
+	ReturnMemoryToSharedBuffer( vBinding );
+	ReturnMemoryToSharedBuffer( iBinding );
+	ReturnMemoryToSharedBuffer( uBinding );
+}
+
+void NullRenderer::ReturnMemoryToSharedBuffer( VertexBufferBinding const& vBinding )
+{
+	if (vBinding.m_vertexBuffer) {
+		vBinding.m_vertexBuffer->ReturnMemory( vBinding.m_vertexBufferOffset, vBinding.m_vertexBufferVertexCount * vBinding.m_vertexBuffer->m_stride );
+	}
+}
+
+void NullRenderer::ReturnMemoryToSharedBuffer( UniformBufferBinding const& uBinding )
+{
+	if (uBinding.m_flags & UNIFORM_BUFFER_USE_MODEL_CONSTANTS_BINDING_2) {
+		for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+			m_sharedModelUniformBuffers[i]->ReturnMemory( uBinding.m_modelUniformBufferOffset, sizeof( ModelUniformBufferObject ) );
+		}
+	}
+}
+
+void NullRenderer::ReturnMemoryToSharedBuffer( IndexBufferBinding const& iBinding )
+{
+	if (iBinding.m_indexBuffer) {
+		iBinding.m_indexBuffer->ReturnMemory( iBinding.m_indexBufferOffset, iBinding.m_indexBufferIndexCount * sizeof( uint16_t ) );
+	}
+}
+
+VertexBuffer* NullRenderer::CreateDynamicVertexBuffer( uint64_t size )
+{
+	++m_totalCounters.m_buffersCreated;
+	VertexBuffer* vertexBuffer = new VertexBuffer( VK_NULL_HANDLE, size );
+	vertexBuffer->m_stride = 0;
+	// the game writes the mapped data directly, so it has to point to real memory
+	std::unique_ptr<unsigned char[]>& memory = m_hostMemories[vertexBuffer];
+	memory.reset( new unsigned char[size] );
+	vertexBuffer->m_mappedData = memory.get();
+	return vertexBuffer;
+}
+
+TransientVertexAllocation NullRenderer::AllocateTransientVertices( uint32_t vertexCount, VertexFormat format )
+{
+	// same growth as the Vulkan renderer so the buffer counters match
+	TransientVertexFrame& frame = m_transientVertexFrames[m_currentFrame];
+	uint32_t vertexSize = GetVertexSize( format );
+	uint64_t size = (uint64_t)vertexCount * vertexSize;
+	if (frame.m_usedBytes + size > frame.m_buffer->m_maxSize) {
+		uint64_t newSize = frame.m_buffer->m_maxSize * 2;
+		while (newSize < size) {
+			newSize *= 2;
+		}
+		frame.m_retiredBuffers.push_back( frame.m_buffer );
+		frame.m_buffer = CreateDynamicVertexBuffer( newSize );
+		frame.m_usedBytes = 0;
+	}
+	TransientVertexAllocation allocation;
+	allocation.m_vertices = (unsigned char*)frame.m_buffer->m_mappedData + frame.m_usedBytes;
+	allocation.m_vertexSize = vertexSize;
+	allocation.m_binding.m_vertexBuffer = frame.m_buffer;
+	allocation.m_binding.m_vertexBufferOffset = frame.m_usedBytes;
+	allocation.m_binding.m_vertexBufferVertexCount = vertexCount;
+	frame.m_usedBytes += size;
+	m_frameCounters.m_transientVertexBytes += size;
+	return allocation;
+}
+
+uint32_t NullRenderer::GetBoundVertexSize() const
+{
+	return GetVertexSize( m_currentShader ? m_currentShader->m_vertexFormat : VertexFormat::PCU3D );
+}
+
+void NullRenderer::DestroyHostVertexBuffer( VertexBuffer* buffer )
+{
+	if (buffer) {
+		m_hostMemories.erase( buffer );
+		delete buffer;
+	}
+}
+
+void NullRenderer::DeferredDestroyBuffer( UniformBuffer* buffer, bool isTransfer )
+{
+	++m_totalCounters.m_buffersDestroyed;
+}
+
+void NullRenderer::DeferredDestroyBuffer( VertexBuffer* buffer, bool isTransfer )
+{
+	++m_totalCounters.m_buffersDestroyed;
+	// nothing reads the host memory once the buffer is destroyed, no need to wait for frames in flight
+	m_hostMemories.erase( buffer );
+	buffer->m_mappedData = nullptr;
+}
+
+void NullRenderer::DeferredDestroyBuffer( IndexBuffer* buffer, bool isTransfer )
+{
+	++m_totalCounters.m_buffersDestroyed;
+}
+
+void NullRenderer::BeginGpuSection( char const* name )
+{
+}
+
+void NullRenderer::EndGpuSection()
+{
+}
+
+GpuFrameTimings const& NullRenderer::GetLastGpuFrameTimings() const
+{
+	return m_emptyGpuFrameTimings;
+}
+
+RendererFrameStatistics const& NullRenderer::GetLastFrameStatistics() const
+{
+	return m_statisticsHistory.GetLast();
+}
+
+RendererStatisticsHistory const& NullRenderer::GetFrameStatisticsHistory() const
+{
+	return m_statisticsHistory;
+}
+
+bool NullRenderer::IsHeadless() const
+{
+	return true;
+}
+
+bool NullRenderer::ReadLastFrame( std::vector<unsigned char>& out_pixels, uint32_t& out_width, uint32_t& out_height ) const
+{
+	return false;
+}
+
+NullRendererCounters const& NullRenderer::GetTotalCounters() const
+{
+	return m_totalCounters;
+}
+
+NullRendererCounters const& NullRenderer::GetLastFrameCounters() const
+{
+	return m_lastFrameCounters;
+}
+
+void NullRenderer::PrintCounters( char const* title ) const
+{
+	NullRendererCounters const& c = m_totalCounters;
+	double frames = c.m_frames > 0 ? (double)c.m_frames : 1.0;
+	printf( "%s: %llu frames\n", title, c.m_frames );
+	printf( "  %-22s %12s %12s\n", "", "total", "per frame" );
+	auto printRow = [frames]( char const* name, uint64_t value ) {
+		printf( "  %-22s %12llu %12.1f\n", name, value, value / frames );
+	};
+	printRow( "cameras", c.m_cameras );
+	printRow( "shader binds", c.m_shaderBinds );
+	printRow( "draw commands", c.m_drawCommands );
+	printRow( "draws", c.m_draws );
+	printRow( "indexed draws", c.m_indexedDraws );
+	printRow( "vertices drawn", c.m_verticesDrawn );
+	printRow( "indices drawn", c.m_indicesDrawn );
+	printRow( "vertex bytes drawn", c.m_vertexBytesDrawn );
+	printRow( "uniform updates", c.m_uniformUpdates );
+	printRow( "uniform bytes", c.m_uniformBytes );
+	printRow( "vertex uploads", c.m_vertexUploads );
+	printRow( "vertex upload bytes", c.m_vertexUploadBytes );
+	printRow( "index uploads", c.m_indexUploads );
+	printRow( "index upload bytes", c.m_indexUploadBytes );
+	printRow( "texture upload bytes", c.m_textureUploadBytes );
+	printRow( "transient vertex bytes", c.m_transientVertexBytes );
+	printf( "  buffers created %llu, destroyed %llu, textures %llu, shaders %llu\n", c.m_buffersCreated, c.m_buffersDestroyed, c.m_texturesCreated, c.m_shadersCreated );
+}
+
+void NullRenderer::AddFrameCountersToTotal()
+{
+	NullRendererCounters& t = m_totalCounters;
+	NullRendererCounters const& f = m_frameCounters;
+	t.m_frames += f.m_frames;
+	t.m_cameras += f.m_cameras;
+	t.m_shaderBinds += f.m_shaderBinds;
+	t.m_drawCommands += f.m_drawCommands;
+	t.m_draws += f.m_draws;
+	t.m_indexedDraws += f.m_indexedDraws;
+	t.m_verticesDrawn += f.m_verticesDrawn;
+	t.m_indicesDrawn += f.m_indicesDrawn;
+	t.m_vertexBytesDrawn += f.m_vertexBytesDrawn;
+	t.m_uniformUpdates += f.m_uniformUpdates;
+	t.m_uniformBytes += f.m_uniformBytes;
+	t.m_vertexUploads += f.m_vertexUploads;
+	t.m_vertexUploadBytes += f.m_vertexUploadBytes;
+	t.m_indexUploads += f.m_indexUploads;
+	t.m_indexUploadBytes += f.m_indexUploadBytes;
+	t.m_textureUploadBytes += f.m_textureUploadBytes;
+	t.m_transientVertexBytes += f.m_transientVertexBytes;
+}
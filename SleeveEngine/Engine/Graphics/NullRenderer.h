@@ -0,0 +1,121 @@
+#pragma once
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include "Graphics/RendererInterface.h"
+
+/// Number of calls the game made into the renderer, per frame or in total
+struct NullRendererCounters {
+	uint64_t m_frames = 0;
+	uint64_t m_cameras = 0;
+	uint64_t m_shaderBinds = 0;
+	uint64_t m_drawCommands = 0;
+	uint64_t m_draws = 0;
+	uint64_t m_indexedDraws = 0;
+	uint64_t m_verticesDrawn = 0;
+	uint64_t m_indicesDrawn = 0;
+	uint64_t m_vertexBytesDrawn = 0;
+	uint64_t m_uniformUpdates = 0;
+	uint64_t m_uniformBytes = 0;
+	uint64_t m_vertexUploads = 0;
+	uint64_t m_vertexUploadBytes = 0;
+	uint64_t m_indexUploads = 0;
+	uint64_t m_indexUploadBytes = 0;
+	uint64_t m_buffersCreated = 0;
+	uint64_t m_buffersDestroyed = 0;
+	uint64_t m_texturesCreated = 0;
+	uint64_t m_textureUploadBytes = 0;
+	uint64_t m_transientVertexBytes = 0;
+	uint64_t m_shadersCreated = 0;
+};
+
+/// Accepts the same calls as the Vulkan Renderer without a device and only counts them,
+/// so game and engine CPU cost can be measured and run without a GPU
+/// Shared buffers still go through the same first fit allocators, dynamic vertex buffers are backed by host memory
+class NullRenderer : public RendererInterface {
+public:
+	virtual void Initialize( RendererConfig const& config = RendererConfig() ) override;
+	virtual void Cleanup() override;
+	virtual void WaitForCleanup() override;
+	virtual void BeginFrame() override;
+	virtual void EndFrame() override;
+
+	virtual void BeginCamera( Camera const* camera ) override;
+	virtual void EndCamera( Camera const* camera ) override;
+
+	virtual float GetSwapChainExtentRatio() const override;
+
+	virtual void DrawSingleBufferIndexed( VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, uint64_t vertexOffset = 0, uint64_t indexOffset = 0 ) override;
+	virtual void Draw( VertexBufferBinding const& vertexBinding ) override;
+	virtual void DrawIndexed( VertexBufferBinding const& vertexBinding, IndexBufferBinding const& indexBinding ) override;
+	virtual void DrawQuads( VertexBufferBinding const& vertexBinding ) override;
+
+	virtual void BindShader( Shader* shader ) override;
+	virtual void BeginDrawCommands( UniformBufferBinding const& uniformBufferBinding, TextureBinding const& textureBinding ) override;
+
+	virtual void UpdateUniformBuffer( UniformBuffer* uniformBuffer, void* newData, size_t dataSize ) override;
+	virtual void UpdateSharedModelUniformBuffer( UniformBufferBinding const& binding, void* newData, size_t dataSize ) override;
+	virtual uint32_t GetCurFrameNumber() const override;
+	virtual uint32_t GetSharedUniformGeneration() const override;
+
+	virtual Texture* CreateTextureFromFile( std::string const& fileName ) override;
+	virtual Texture* CreateTextureFromBuffer( unsigned char const* buffer, uint64_t size, uint32_t width, uint32_t height ) override;
+	virtual Texture* CreateWhiteTexture() override;
+	virtual void UpdateTextureRegion( Texture* texture, uint32_t x, uint32_t y, uint32_t width, uint32_t height, unsigned char const* pixels ) override;
+	virtual IndexBuffer* CreateIndexBuffer( void* indexData, uint64_t size, uint32_t indexCount ) override;
+	virtual VertexBuffer* CreateVertexBuffer( void* vertexData, uint64_t size, uint32_t vertexCount ) override;
+	virtual UniformBuffer* CreateUniformBuffer( uint64_t size ) override;
+	virtual Shader* CreateShader( std::string const& fileName ) override;
+	virtual Shader* CreateShader( ShaderSource const& source ) override;
+
+	virtual VertexBufferBinding AddVertsDataToSharedVertexBuffer( void* vertexData, uint64_t size, uint32_t vertexCount ) override;
+	virtual IndexBufferBinding AddIndicesDataToSharedIndexBuffer( void* indexData, uint64_t size, uint32_t indexCount ) override;
+	virtual UniformBufferBinding AddDataToSharedUniformBuffer( UniformBufferDataBindingFlags flags ) override;
+	virtual void ReturnMemoryToSharedBuffer( VertexBufferBinding const& vBinding, IndexBufferBinding const& iBinding, UniformBufferBinding const& uBinding ) override;
+	virtual void ReturnMemoryToSharedBuffer( VertexBufferBinding const& vBinding ) override;
+	virtual void ReturnMemoryToSharedBuffer( UniformBufferBinding const& uBinding ) override;
+	virtual void ReturnMemoryToSharedBuffer( IndexBufferBinding const& iBinding ) override;
+
+	virtual VertexBuffer* CreateDynamicVertexBuffer( uint64_t size ) override;
+	virtual TransientVertexAllocation AllocateTransientVertices( uint32_t vertexCount, VertexFormat format ) override;
+
+	virtual void DeferredDestroyBuffer( UniformBuffer* buffer, bool isTransfer ) override;
+	virtual void DeferredDestroyBuffer( VertexBuffer* buffer, bool isTransfer ) override;
+	virtual void DeferredDestroyBuffer( IndexBuffer* buffer, bool isTransfer ) override;
+
+	virtual void BeginGpuSection( char const* name ) override;
+	virtual void EndGpuSection() override;
+	virtual GpuFrameTimings const& GetLastGpuFrameTimings() const override;
+	virtual RendererFrameStatistics const& GetLastFrameStatistics() const override;
+	virtual RendererStatisticsHistory const& GetFrameStatisticsHistory() const override;
+
+	virtual bool IsHeadless() const override;
+	virtual bool ReadLastFrame( std::vector<unsigned char>& out_pixels, uint32_t& out_width, uint32_t& out_height ) const override;
+
+	NullRendererCounters const& GetTotalCounters() const;
+	/// counters of the last finished frame
+	NullRendererCounters const& GetLastFrameCounters() const;
+	void PrintCounters( char const* title ) const;
+
+protected:
+	void AddFrameCountersToTotal();
+	void DestroyHostVertexBuffer( VertexBuffer* buffer );
+	/// vertex size of the bound shader's format
+	uint32_t GetBoundVertexSize() const;
+
+	RendererConfig m_config;
+	uint32_t m_currentFrame = 0;
+	Shader* m_currentShader = nullptr;
+	NullRendererCounters m_frameCounters;
+	NullRendererCounters m_lastFrameCounters;
+	NullRendererCounters m_totalCounters;
+	GpuFrameTimings m_emptyGpuFrameTimings;
+	RendererStatisticsHistory m_statisticsHistory;
+
+	VertexBuffer* m_sharedMeshVertexBuffer = nullptr;
+	IndexBuffer* m_sharedMeshIndexBuffer = nullptr;
+	std::array<UniformBuffer*, MAX_FRAMES_IN_FLIGHT> m_sharedModelUniformBuffers = {};
+	std::array<TransientVertexFrame, MAX_FRAMES_IN_FLIGHT> m_transientVertexFrames;
+	/// host memory behind the mapped data of dynamic vertex buffers
+	std::unordered_map<VertexBuffer const*, std::unique_ptr<unsigned char[]>> m_hostMemories;
+};
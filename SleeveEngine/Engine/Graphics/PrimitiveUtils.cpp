@@ -1,4 +1,5 @@
 #include "Graphics/PrimitiveUtils.h"
+#include "Graphics/GraphicsCommon.h"
 
 void AddVertsForAABB2D( std::vector<VertexPCU3D>& verts, AABB2 const& aabbBox, Rgba8 const& color, AABB2 const& uvs /*= AABB2::Identity */ )
 {
@@ -15,3 +16,16 @@ void AddVertsForAABB2D( std::vector<VertexPCU3D>& verts, AABB2 const& aabbBox, R
 	verts.emplace_back( Vec2( aabbBox.m_maxs.x, aabbBox.m_mins.y ), color, Vec2( uvMaxs.x, uvMins.y ) );
 }
 
+void AddVertsForQuad2D( std::vector<VertexPCU3D>& verts, AABB2 const& aabbBox, Rgba8 const& color, AABB2 const& uvs /*= AABB2::Identity */ )
+{
+	verts.resize( verts.size() + QUAD_VERTEX_COUNT );
+	AddVertsForQuad2D( &verts[verts.size() - QUAD_VERTEX_COUNT], aabbBox, color, uvs.m_mins, uvs.m_maxs );
+}
+
+void AddVertsForQuad2D( VertexPCU3D* verts, AABB2 const& aabbBox, Rgba8 const& color, Vec2 const& uvMins, Vec2 const& uvMaxs )
+{
+	verts[0] = VertexPCU3D( aabbBox.m_mins, color, uvMins );
+	verts[1] = VertexPCU3D( Vec2( aabbBox.m_maxs.x, aabbBox.m_mins.y ), color, Vec2( uvMaxs.x, uvMins.y ) );
+	verts[2] = VertexPCU3D( aabbBox.m_maxs, color, uvMaxs );
+	verts[3] = VertexPCU3D( Vec2( aabbBox.m_mins.x, aabbBox.m_maxs.y ), color, Vec2( uvMins.x, uvMaxs.y ) );
+}
@@ -5,4 +5,8 @@
 /// Add AABB2D vertexes to a vector
 void AddVertsForAABB2D( std::vector<VertexPCU3D>& verts, AABB2 const& aabbBox, Rgba8 const& color, AABB2 const& uvs = AABB2::Identity );
 /// Add AABB2D vertexes to a vector
-void AddVertsForAABB2D( std::vector<VertexPCU3D>& verts, AABB2 const& aabbBox, Rgba8 const& color, Vec2 const& uvMins, Vec2 const& uvMaxs );
\ No newline at end of file
+void AddVertsForAABB2D( std::vector<VertexPCU3D>& verts, AABB2 const& aabbBox, Rgba8 const& color, Vec2 const& uvMins, Vec2 const& uvMaxs );
+/// Add the 4 corners of an AABB2D: min, (max x, min y), max, (min x, max y), draw them with RendererInterface::DrawQuads
+void AddVertsForQuad2D( std::vector<VertexPCU3D>& verts, AABB2 const& aabbBox, Rgba8 const& color, AABB2 const& uvs = AABB2::Identity );
+/// Write the 4 corners of an AABB2D to verts, which has room for them
+void AddVertsForQuad2D( VertexPCU3D* verts, AABB2 const& aabbBox, Rgba8 const& color, Vec2 const& uvMins, Vec2 const& uvMaxs );
\ No newline at end of file
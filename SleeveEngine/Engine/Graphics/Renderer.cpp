@@ -8,17 +8,28 @@
 #include <GLFW/glfw3.h>
 
 #include "Graphics/StagingBuffer.h"
+#include "Graphics/GpuProfiler.h"
+#include "Core/Profiler.h"
+#include "Core/AllocationTracker.h"
 #include "Window/Window.h"
 
-void Renderer::Initialize()
+void Renderer::Initialize( RendererConfig const& config )
 {
+	m_config = config;
 	CreateInstance();
 	SetupDebugMessenger();
-	CreateSurface();
+	if (!m_config.m_headless) {
+		CreateSurface();
+	}
 	PickPhysicalDevice();
 	CreateLogicalDevice();
-	CreateSwapChain();
-	CreateSwapChainImageViews();
+	if (m_config.m_headless) {
+		CreateOffscreenTargets();
+	}
+	else {
+		CreateSwapChain();
+		CreateSwapChainImageViews();
+	}
 	CreateRenderPass();
 	CreateCommandPools();
 	CreateDepthResources();
@@ -27,11 +38,20 @@ void Renderer::Initialize()
 	CreateCommandBuffers();
 	CreateSyncObjects();
 	CreateStagingBuffer();
+	if (m_config.m_gpuTimestamps) {
+		QueueFamilyIndices indices = FindQueueFamilies( m_physicalDevice );
+		m_gpuProfiler = new GpuProfiler( m_device, m_physicalDevice, indices.m_graphicsFamily.value(), indices.m_transferFamily.value(), m_config.m_gpuPipelineStatistics && m_supportsPipelineStatistics );
+	}
+	if (m_config.m_headless && m_config.m_readbackFrames) {
+		CreateReadbackBuffers();
+	}
 
 	m_sharedMeshVertexBuffer = CreateSharedVertexBuffer( INITIAL_SHARED_VERTEX_BUFFER_MAX_SIZE, sizeof( VertexPCU3D ) );
 	m_sharedMeshIndexBuffer = CreateSharedIndexBuffer( INITIAL_SHARED_INDEX_BUFFER_MAX_SIZE );
+	CreateQuadIndexBuffer();
 	for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
 		m_sharedModelUniformBuffers[i] = CreateSharedUniformBuffer( INITIAL_MODEL_UNIFORM_BUFFER_MAX_SIZE, sizeof(ModelUniformBufferObject) );
+		m_transientVertexFrames[i].m_buffer = CreateDynamicVertexBuffer( INITIAL_TRANSIENT_VERTEX_BUFFER_SIZE );
 	}
 
 }
@@ -45,12 +65,22 @@ void Renderer::Cleanup()
 		vkFreeMemory( m_device, it->m_deviceMemory, nullptr );
 		++it;
 	}
+	for (size_t i = 0; i < m_readbackBuffers.size(); ++i) {
+		vkDestroyBuffer( m_device, m_readbackBuffers[i], nullptr );
+		vkFreeMemory( m_device, m_readbackBufferMemories[i], nullptr );
+	}
+	delete m_gpuProfiler;
 	delete m_depthTexture;
 	delete m_sharedMeshIndexBuffer;
 	delete m_sharedMeshVertexBuffer;
+	delete m_quadIndexBuffer;
 	for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
 		delete m_stagingBuffers[i];
 		delete m_sharedModelUniformBuffers[i];
+		delete m_transientVertexFrames[i].m_buffer;
+		for (VertexBuffer* buffer : m_transientVertexFrames[i].m_retiredBuffers) {
+			delete buffer;
+		}
 	}
 	vkDestroySampler( m_device, m_textureSampler, nullptr );
 	for (auto& pair : m_descriptorPoolsDictionary) {
@@ -77,7 +107,9 @@ void Renderer::Cleanup()
 		DestroyDebugUtilsMessengerEXT( m_instance, m_debugMessenger, nullptr );
 	}
 
-	vkDestroySurfaceKHR( m_instance, m_surface, nullptr );
+	if (m_surface != VK_NULL_HANDLE) {
+		vkDestroySurfaceKHR( m_instance, m_surface, nullptr );
+	}
 	vkDestroyInstance( m_instance, nullptr );
 
 }
@@ -91,21 +123,48 @@ void Renderer::WaitForCleanup()
 	vkQueueWaitIdle( m_graphicsQueue );
 	vkQueueWaitIdle( m_presentQueue );
 	vkQueueWaitIdle( m_transferQueue );
+
+	// collect the frames still waiting for readback, oldest first
+	for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+		CopyFinishedReadback( (m_currentFrame + i) % MAX_FRAMES_IN_FLIGHT );
+	}
 }
 
 void Renderer::BeginFrame()
 {
+	PROFILE_SCOPE( "Renderer::BeginFrame" );
+	ALLOCATION_TAG_SCOPE( "Renderer" );
 	VkFence fences[] = { m_inFlightFences[m_currentFrame], m_transferFences[m_currentFrame] };
 	vkWaitForFences( m_device, 2, fences, VK_TRUE, UINT64_MAX );
 
-	VkResult result = vkAcquireNextImageKHR( m_device, m_swapChain, UINT64_MAX, m_imageAvailableSemaphores[m_currentFrame], VK_NULL_HANDLE, &m_curImageIndex );
+	// the queries of this frame slot finished with the fences, reading them now never waits for the GPU
+	if (m_gpuProfiler) {
+		m_gpuProfiler->CollectResults( m_currentFrame );
+	}
 
-	if (result == VK_ERROR_OUT_OF_DATE_KHR) {
-		RecreateSwapChain();
-		return;
+	// so did the draws reading the transient vertices of this frame slot
+	TransientVertexFrame& transientVertexFrame = m_transientVertexFrames[m_currentFrame];
+	for (VertexBuffer* buffer : transientVertexFrame.m_retiredBuffers) {
+		delete buffer;
 	}
-	else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
-		THROW_ERROR( "failed to acquire swap chain image!" );
+	transientVertexFrame.m_retiredBuffers.clear();
+	transientVertexFrame.m_usedBytes = 0;
+
+	if (m_config.m_headless) {
+		// each frame in flight owns one offscreen image, the fences above already made sure it is free
+		m_curImageIndex = m_currentFrame;
+		CopyFinishedReadback( m_currentFrame );
+	}
+	else {
+		VkResult result = vkAcquireNextImageKHR( m_device, m_swapChain, UINT64_MAX, m_imageAvailableSemaphores[m_currentFrame], VK_NULL_HANDLE, &m_curImageIndex );
+
+		if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+			RecreateSwapChain();
+			return;
+		}
+		else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+			THROW_ERROR( "failed to acquire swap chain image!" );
+		}
 	}
 
 	// Only reset the fence if we are submitting work
@@ -140,6 +199,15 @@ void Renderer::BeginFrame()
 
 	vkBeginCommandBuffer( m_transferCommandBuffers[m_currentFrame], &transferBeginInfo);
 
+	RecordTextureRegionUpdates();
+
+	if (m_gpuProfiler) {
+		m_gpuProfiler->BeginFrame( m_currentFrame, m_commandBuffers[m_currentFrame], m_transferCommandBuffers[m_currentFrame] );
+		// query pools can only be reset and pipeline statistics begun outside the render pass
+		m_gpuProfiler->BeginGraphicsSection( "Render pass" );
+		m_gpuProfiler->BeginPipelineStatistics();
+	}
+
 	for (auto& pair : m_descriptorPoolsDictionary) {
 		pair.second->BeginFrame();
 	}
@@ -179,10 +247,25 @@ void Renderer::BeginFrame()
 
 void Renderer::EndFrame()
 {
+	PROFILE_SCOPE( "Renderer::EndFrame" );
+	ALLOCATION_TAG_SCOPE( "Renderer" );
 	vkCmdEndRenderPass( m_commandBuffers[m_currentFrame] );
+	if (m_gpuProfiler) {
+		m_gpuProfiler->EndPipelineStatistics();
+		m_gpuProfiler->EndGraphicsSection();
+	}
+
+	if (m_config.m_headless && m_config.m_readbackFrames) {
+		BeginGpuSection( "Frame readback" );
+		RecordFrameReadback();
+		EndGpuSection();
+	}
 
 	ASSERT_OR_ERROR( vkEndCommandBuffer( m_commandBuffers[m_currentFrame] ) == VK_SUCCESS, "failed to record command buffer!" );
 
+	if (m_gpuProfiler) {
+		m_gpuProfiler->BeginTransferSection( "Transfer copies" );
+	}
 	for (size_t i = 0; i < m_copyCommands.size(); ++i) {
 		VkBufferCopy copyRegion{};
 		copyRegion.dstOffset = m_copyCommands[i].m_dstOffset;
@@ -196,7 +279,11 @@ void Renderer::EndFrame()
 			&copyRegion
 		);
 	}
+	m_frameStatistics.m_copyCommands = m_copyCommands.size();
 	m_copyCommands.clear();
+	if (m_gpuProfiler) {
+		m_gpuProfiler->EndTransferSection();
+	}
 	vkEndCommandBuffer( m_transferCommandBuffers[m_currentFrame]);
 
 	VkSubmitInfo transferQueueSubmitInfo{};
@@ -211,37 +298,43 @@ void Renderer::EndFrame()
 	VkSubmitInfo graphicsQueueSubmitInfo{};
 	graphicsQueueSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-	VkSemaphore waitSemaphores[] = { m_imageAvailableSemaphores[m_currentFrame], m_transferCompleteSemaphores[m_currentFrame] };
-	VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT };
-	graphicsQueueSubmitInfo.waitSemaphoreCount = 2;
+	// headless mode has no image to acquire and nothing to present, so it only waits for the transfer
+	VkSemaphore waitSemaphores[] = { m_transferCompleteSemaphores[m_currentFrame], m_imageAvailableSemaphores[m_currentFrame] };
+	VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+	graphicsQueueSubmitInfo.waitSemaphoreCount = m_config.m_headless ? 1 : 2;
 	graphicsQueueSubmitInfo.pWaitSemaphores = waitSemaphores;
 	graphicsQueueSubmitInfo.pWaitDstStageMask = waitStages;
 	graphicsQueueSubmitInfo.commandBufferCount = 1;
 	graphicsQueueSubmitInfo.pCommandBuffers = &m_commandBuffers[m_currentFrame];
 	VkSemaphore signalSemaphores[] = { m_renderFinishedSemaphores[m_currentFrame] };
-	graphicsQueueSubmitInfo.signalSemaphoreCount = 1;
+	graphicsQueueSubmitInfo.signalSemaphoreCount = m_config.m_headless ? 0 : 1;
 	graphicsQueueSubmitInfo.pSignalSemaphores = signalSemaphores;
 
 	ASSERT_OR_ERROR( vkQueueSubmit( m_graphicsQueue, 1, &graphicsQueueSubmitInfo, m_inFlightFences[m_currentFrame] ) == VK_SUCCESS, "failed to submit draw command buffer!" );
-
-	VkPresentInfoKHR presentInfo{};
-	presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-
-	presentInfo.waitSemaphoreCount = 1;
-	presentInfo.pWaitSemaphores = signalSemaphores;
-	VkSwapchainKHR swapChains[] = { m_swapChain };
-	presentInfo.swapchainCount = 1;
-	presentInfo.pSwapchains = swapChains;
-	presentInfo.pImageIndices = &m_curImageIndex;
-	presentInfo.pResults = nullptr; // Optional
-	VkResult result = vkQueuePresentKHR( m_presentQueue, &presentInfo );
-
-	if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || g_mainWindow->HasFrameBufferResized()) {
-		g_mainWindow->SetFrameBufferResized( false );
-		RecreateSwapChain();
-	}
-	else if (result != VK_SUCCESS) {
-		THROW_ERROR( "failed to present swap chain image!" );
+	if (m_gpuProfiler) {
+		m_gpuProfiler->EndFrame( m_currentFrame );
+	}
+
+	if (!m_config.m_headless) {
+		VkPresentInfoKHR presentInfo{};
+		presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+
+		presentInfo.waitSemaphoreCount = 1;
+		presentInfo.pWaitSemaphores = signalSemaphores;
+		VkSwapchainKHR swapChains[] = { m_swapChain };
+		presentInfo.swapchainCount = 1;
+		presentInfo.pSwapchains = swapChains;
+		presentInfo.pImageIndices = &m_curImageIndex;
+		presentInfo.pResults = nullptr; // Optional
+		VkResult result = vkQueuePresentKHR( m_presentQueue, &presentInfo );
+
+		if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || g_mainWindow->HasFrameBufferResized()) {
+			g_mainWindow->SetFrameBufferResized( false );
+			RecreateSwapChain();
+		}
+		else if (result != VK_SUCCESS) {
+			THROW_ERROR( "failed to present swap chain image!" );
+		}
 	}
 
 	// destroy pending buffers
@@ -259,6 +352,16 @@ void Renderer::EndFrame()
 		}
 	}
 
+	StagingBuffer const* stagingBuffer = m_stagingBuffers[m_currentFrame];
+	m_frameStatistics.m_stagingBytesUsed = GetSharedBufferOccupancy( stagingBuffer->m_memoryBlocks, stagingBuffer->m_maxSize ).m_usedBytes;
+	m_frameStatistics.m_pendingDeletions = m_pendingDestroyBuffers.size();
+	m_frameStatistics.m_sharedVertexBuffer = GetSharedBufferOccupancy( m_sharedMeshVertexBuffer->m_memoryBlocks, m_sharedMeshVertexBuffer->m_maxSize );
+	m_frameStatistics.m_sharedIndexBuffer = GetSharedBufferOccupancy( m_sharedMeshIndexBuffer->m_memoryBlocks, m_sharedMeshIndexBuffer->m_maxSize );
+	UniformBuffer const* uniformBuffer = m_sharedModelUniformBuffers[m_currentFrame];
+	m_frameStatistics.m_sharedUniformBuffer = GetSharedBufferOccupancy( uniformBuffer->m_memoryBlocks, uniformBuffer->m_maxSize );
+	m_statisticsHistory.AddFrame( m_frameStatistics );
+	m_frameStatistics = RendererFrameStatistics();
+
 	m_currentFrame = (m_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 }
 
@@ -306,6 +409,56 @@ void Renderer::LetDeviceWaitIdle()
 	vkDeviceWaitIdle( m_device );
 }
 
+void Renderer::BeginGpuSection( char const* name )
+{
+	if (m_gpuProfiler) {
+		m_gpuProfiler->BeginGraphicsSection( name );
+	}
+}
+
+void Renderer::EndGpuSection()
+{
+	if (m_gpuProfiler) {
+		m_gpuProfiler->EndGraphicsSection();
+	}
+}
+
+GpuFrameTimings const& Renderer::GetLastGpuFrameTimings() const
+{
+	return m_gpuProfiler ? m_gpuProfiler->GetLastFrameTimings() : m_emptyGpuFrameTimings;
+}
+
+RendererFrameStatistics const& Renderer::GetLastFrameStatistics() const
+{
+	return m_statisticsHistory.GetLast();
+}
+
+RendererStatisticsHistory const& Renderer::GetFrameStatisticsHistory() const
+{
+	return m_statisticsHistory;
+}
+
+bool Renderer::IsHeadless() const
+{
+	return m_config.m_headless;
+}
+
+bool Renderer::ReadLastFrame( std::vector<unsigned char>& out_pixels, uint32_t& out_width, uint32_t& out_height ) const
+{
+	if (m_lastReadbackPixels.empty()) {
+		return false;
+	}
+	out_width = m_swapChainExtent.width;
+	out_height = m_swapChainExtent.height;
+	out_pixels = m_lastReadbackPixels;
+	if (m_swapChainImageFormat == VK_FORMAT_B8G8R8A8_SRGB) {
+		for (size_t i = 0; i < out_pixels.size(); i += 4) {
+			std::swap( out_pixels[i], out_pixels[i + 2] );
+		}
+	}
+	return true;
+}
+
 void Renderer::CreateInstance()
 {
 	ASSERT_OR_ERROR( !(enableValidationLayers && !CheckValidationLayerSupport()), "validation layers requested, but not available!" );
@@ -419,7 +572,8 @@ void Renderer::CreateLogicalDevice()
 	QueueFamilyIndices indices = FindQueueFamilies( m_physicalDevice );
 
 	std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-	std::set<uint32_t> uniqueQueueFamilies = { indices.m_graphicsFamily.value(), indices.m_presentFamily.value() };
+	// software drivers usually expose a single family, so transfer can share it with graphics
+	std::set<uint32_t> uniqueQueueFamilies = { indices.m_graphicsFamily.value(), indices.m_presentFamily.value(), indices.m_transferFamily.value() };
 
 	float queuePriority = 1.0f;
 	for (uint32_t queueFamily : uniqueQueueFamilies) {
@@ -431,21 +585,20 @@ void Renderer::CreateLogicalDevice()
 		queueCreateInfos.push_back( queueCreateInfo );
 	}
 
-	VkDeviceQueueCreateInfo queueCreateInfo{};
-	queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-	queueCreateInfo.queueFamilyIndex = indices.m_transferFamily.value();
-	queueCreateInfo.queueCount = 1;
-	queueCreateInfo.pQueuePriorities = &queuePriority;
-	queueCreateInfos.push_back( queueCreateInfo );
+	VkPhysicalDeviceFeatures supportedFeatures;
+	vkGetPhysicalDeviceFeatures( m_physicalDevice, &supportedFeatures );
+	m_supportsPipelineStatistics = supportedFeatures.pipelineStatisticsQuery == VK_TRUE;
 
 	VkPhysicalDeviceFeatures deviceFeatures{};
 	deviceFeatures.samplerAnisotropy = VK_TRUE;
+	deviceFeatures.pipelineStatisticsQuery = m_config.m_gpuPipelineStatistics && m_supportsPipelineStatistics ? VK_TRUE : VK_FALSE;
 	VkDeviceCreateInfo createInfo{};
 	createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 	createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
 	createInfo.pQueueCreateInfos = queueCreateInfos.data();
-	createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-	createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+	std::vector<const char*> extensions = GetRequiredDeviceExtensions();
+	createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+	createInfo.ppEnabledExtensionNames = extensions.data();
 	createInfo.pEnabledFeatures = &deviceFeatures;
 
 	if (vkCreateDevice( m_physicalDevice, &createInfo, nullptr, &m_device ) != VK_SUCCESS) {
@@ -518,6 +671,74 @@ void Renderer::CreateSwapChainImageViews()
 	}
 }
 
+void Renderer::CreateOffscreenTargets()
+{
+	m_swapChainExtent = { m_config.m_offscreenWidth, m_config.m_offscreenHeight };
+	m_swapChainImageFormat = FindSupportedFormat( { VK_FORMAT_B8G8R8A8_SRGB, VK_FORMAT_R8G8B8A8_SRGB }, VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT | VK_FORMAT_FEATURE_TRANSFER_SRC_BIT );
+
+	// one color target per frame in flight, so the in flight fence is enough to know when it can be reused
+	m_swapChainImages.resize( MAX_FRAMES_IN_FLIGHT );
+	m_offscreenImageMemories.resize( MAX_FRAMES_IN_FLIGHT );
+	m_swapChainImageViews.resize( MAX_FRAMES_IN_FLIGHT );
+	for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+		CreateImage( m_swapChainExtent.width, m_swapChainExtent.height, m_swapChainImageFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_swapChainImages[i], m_offscreenImageMemories[i] );
+		m_swapChainImageViews[i] = CreateImageView( m_swapChainImages[i], m_swapChainImageFormat, VK_IMAGE_ASPECT_COLOR_BIT );
+	}
+}
+
+void Renderer::CreateReadbackBuffers()
+{
+	VkDeviceSize frameSize = (VkDeviceSize)m_swapChainExtent.width * m_swapChainExtent.height * 4;
+	m_readbackBuffers.resize( MAX_FRAMES_IN_FLIGHT );
+	m_readbackBufferMemories.resize( MAX_FRAMES_IN_FLIGHT );
+	m_readbackMappedData.resize( MAX_FRAMES_IN_FLIGHT );
+	for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+		CreateBuffer( frameSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_readbackBuffers[i], m_readbackBufferMemories[i] );
+		vkMapMemory( m_device, m_readbackBufferMemories[i], 0, frameSize, 0, &m_readbackMappedData[i] );
+	}
+}
+
+void Renderer::RecordFrameReadback()
+{
+	// the render pass leaves the image in TRANSFER_SRC_OPTIMAL and its outgoing dependency covers the transfer read
+	VkBufferImageCopy region{};
+	region.bufferOffset = 0;
+	region.bufferRowLength = 0;
+	region.bufferImageHeight = 0;
+	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.mipLevel = 0;
+	region.imageSubresource.baseArrayLayer = 0;
+	region.imageSubresource.layerCount = 1;
+	region.imageOffset = { 0, 0, 0 };
+	region.imageExtent = { m_swapChainExtent.width, m_swapChainExtent.height, 1 };
+	vkCmdCopyImageToBuffer( m_commandBuffers[m_currentFrame], m_swapChainImages[m_curImageIndex], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m_readbackBuffers[m_currentFrame], 1, &region );
+
+	// make the copy visible to the host once the in flight fence is signaled
+	VkBufferMemoryBarrier bufferBarrier{};
+	bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	bufferBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+	bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	bufferBarrier.buffer = m_readbackBuffers[m_currentFrame];
+	bufferBarrier.offset = 0;
+	bufferBarrier.size = VK_WHOLE_SIZE;
+	vkCmdPipelineBarrier( m_commandBuffers[m_currentFrame], VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &bufferBarrier, 0, nullptr );
+
+	m_isReadbackPending[m_currentFrame] = true;
+}
+
+void Renderer::CopyFinishedReadback( uint32_t frameIndex )
+{
+	if (!m_isReadbackPending[frameIndex]) {
+		return;
+	}
+	size_t frameSize = (size_t)m_swapChainExtent.width * m_swapChainExtent.height * 4;
+	m_lastReadbackPixels.resize( frameSize );
+	memcpy( m_lastReadbackPixels.data(), m_readbackMappedData[frameIndex], frameSize );
+	m_isReadbackPending[frameIndex] = false;
+}
+
 void Renderer::CreateRenderPass()
 {
 	VkAttachmentDescription colorAttachment{};
@@ -528,7 +749,7 @@ void Renderer::CreateRenderPass()
 	colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 	colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 	colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	colorAttachment.finalLayout = m_config.m_headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 	VkAttachmentReference colorAttachmentRef{};
 	colorAttachmentRef.attachment = 0;
 	colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
@@ -559,6 +780,15 @@ void Renderer::CreateRenderPass()
 	dependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
 	dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
 	dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	// headless: the color target is read back by a copy after the pass
+	VkSubpassDependency readbackDependency{};
+	readbackDependency.srcSubpass = 0;
+	readbackDependency.dstSubpass = VK_SUBPASS_EXTERNAL;
+	readbackDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	readbackDependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	readbackDependency.dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	readbackDependency.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	std::array<VkSubpassDependency, 2> dependencies = { dependency, readbackDependency };
 	std::array<VkAttachmentDescription, 2> attachments = { colorAttachment, depthAttachment };
 	VkRenderPassCreateInfo renderPassInfo{};
 	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
@@ -566,8 +796,8 @@ void Renderer::CreateRenderPass()
 	renderPassInfo.pAttachments = attachments.data();
 	renderPassInfo.subpassCount = 1;
 	renderPassInfo.pSubpasses = &subpass;
-	renderPassInfo.dependencyCount = 1;
-	renderPassInfo.pDependencies = &dependency;
+	renderPassInfo.dependencyCount = m_config.m_headless ? 2 : 1;
+	renderPassInfo.pDependencies = dependencies.data();
 
 	if (vkCreateRenderPass( m_device, &renderPassInfo, nullptr, &m_renderPass ) != VK_SUCCESS) {
 		THROW_ERROR( "failed to create render pass!" );
@@ -758,7 +988,7 @@ DescriptorPools* Renderer::GetOrCreateDescriptorPools( uint8_t numOfUniformBuffe
 	uint64_t key = GetDescriptorPoolKey( numOfUniformBuffers, numOfSamplers );
 	auto iter = m_descriptorPoolsDictionary.find( key );
 	if (iter == m_descriptorPoolsDictionary.end()) {
-		DescriptorPools* newPools = new DescriptorPools( m_device, numOfUniformBuffers, numOfSamplers );
+		DescriptorPools* newPools = new DescriptorPools( m_device, this, numOfUniformBuffers, numOfSamplers );
 		m_descriptorPoolsDictionary[key] = newPools;
 		return newPools;
 	}
@@ -843,6 +1073,19 @@ void Renderer::DrawSingleBufferIndexed( VertexBuffer* vertexBuffer, IndexBuffer*
 	vkCmdBindVertexBuffers( m_commandBuffers[m_currentFrame], 0, 1, vertexBuffers, offsets );
 	vkCmdBindIndexBuffer( m_commandBuffers[m_currentFrame], indexBuffer->m_buffer, indexOffset, VK_INDEX_TYPE_UINT16 );
 	vkCmdDrawIndexed( m_commandBuffers[m_currentFrame], indexBuffer->m_indexCount, 1, 0, 0, 0 );
+	++m_frameStatistics.m_draws;
+	// the vertex count behind the indices is unknown here, only the indices are counted
+	m_frameStatistics.m_indexBytesDrawn += (uint64_t)indexBuffer->m_indexCount * sizeof( uint16_t );
+}
+
+uint64_t Renderer::GetVertexBytes( VertexBufferBinding const& vertexBinding ) const
+{
+	// buffers without a stride of their own are read with the vertex format of the bound pipeline
+	uint64_t stride = vertexBinding.m_vertexBuffer->m_stride;
+	if (stride == 0) {
+		stride = GetVertexSize( m_currentShader ? m_currentShader->m_vertexFormat : VertexFormat::PCU3D );
+	}
+	return (uint64_t)vertexBinding.m_vertexBufferVertexCount * stride;
 }
 
 void Renderer::Draw( VertexBufferBinding const& vertexBinding )
@@ -851,6 +1094,8 @@ void Renderer::Draw( VertexBufferBinding const& vertexBinding )
 	VkDeviceSize offsets[] = { vertexBinding.m_vertexBufferOffset };
 	vkCmdBindVertexBuffers( m_commandBuffers[m_currentFrame], 0, 1, vertexBuffers, offsets );
 	vkCmdDraw( m_commandBuffers[m_currentFrame], vertexBinding.m_vertexBufferVertexCount, 1, 0, 0 );
+	++m_frameStatistics.m_draws;
+	m_frameStatistics.m_vertexBytesDrawn += GetVertexBytes( vertexBinding );
 }
 
 void Renderer::DrawIndexed( VertexBufferBinding const& vertexBinding, IndexBufferBinding const& indexBinding )
@@ -860,6 +1105,29 @@ void Renderer::DrawIndexed( VertexBufferBinding const& vertexBinding, IndexBuffe
 	vkCmdBindVertexBuffers( m_commandBuffers[m_currentFrame], 0, 1, vertexBuffers, offsets );
 	vkCmdBindIndexBuffer( m_commandBuffers[m_currentFrame], indexBinding.m_indexBuffer->m_buffer, indexBinding.m_indexBufferOffset, VK_INDEX_TYPE_UINT16 );
 	vkCmdDrawIndexed( m_commandBuffers[m_currentFrame], indexBinding.m_indexBufferIndexCount, 1, 0, 0, 0 );
+	++m_frameStatistics.m_draws;
+	m_frameStatistics.m_vertexBytesDrawn += GetVertexBytes( vertexBinding );
+	m_frameStatistics.m_indexBytesDrawn += (uint64_t)indexBinding.m_indexBufferIndexCount * sizeof( uint16_t );
+}
+
+void Renderer::DrawQuads( VertexBufferBinding const& vertexBinding )
+{
+	uint32_t quadCount = vertexBinding.m_vertexBufferVertexCount / QUAD_VERTEX_COUNT;
+	if (quadCount == 0) {
+		return;
+	}
+	VkBuffer vertexBuffers[] = { vertexBinding.m_vertexBuffer->m_buffer };
+	VkDeviceSize offsets[] = { vertexBinding.m_vertexBufferOffset };
+	vkCmdBindVertexBuffers( m_commandBuffers[m_currentFrame], 0, 1, vertexBuffers, offsets );
+	vkCmdBindIndexBuffer( m_commandBuffers[m_currentFrame], m_quadIndexBuffer->m_buffer, 0, VK_INDEX_TYPE_UINT16 );
+	// 16 bit indices reach QUAD_INDEX_BUFFER_QUAD_COUNT quads, the vertex offset moves the rest into their range
+	for (uint32_t firstQuad = 0; firstQuad < quadCount; firstQuad += QUAD_INDEX_BUFFER_QUAD_COUNT) {
+		uint32_t batchQuadCount = std::min( quadCount - firstQuad, QUAD_INDEX_BUFFER_QUAD_COUNT );
+		vkCmdDrawIndexed( m_commandBuffers[m_currentFrame], batchQuadCount * QUAD_INDEX_COUNT, 1, 0, (int32_t)(firstQuad * QUAD_VERTEX_COUNT), 0 );
+		++m_frameStatistics.m_draws;
+	}
+	m_frameStatistics.m_vertexBytesDrawn += GetVertexBytes( vertexBinding );
+	m_frameStatistics.m_indexBytesDrawn += (uint64_t)quadCount * QUAD_INDEX_COUNT * sizeof( uint16_t );
 }
 
 void Renderer::BindShader( Shader* shader )
@@ -867,12 +1135,14 @@ void Renderer::BindShader( Shader* shader )
 	if (m_currentShader != shader) {
 		m_currentShader = shader;
 		vkCmdBindPipeline( m_commandBuffers[m_currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, m_currentShader->m_graphicsPipeline );
+		++m_frameStatistics.m_pipelineBinds;
 	}
 }
 
 void Renderer::BeginDrawCommands( UniformBufferBinding const& uniformBufferBinding, TextureBinding const& textureBinding )
 {
 	m_currentShader->UpdateDescriptorSets( uniformBufferBinding, textureBinding );
+	++m_frameStatistics.m_descriptorSetWrites;
 }
 
 VkCommandBuffer Renderer::BeginSingleTimeCommands()
@@ -914,6 +1184,7 @@ void Renderer::UpdateUniformBuffer( UniformBuffer* uniformBuffer, void* newData,
 {
 	//CopyDataToUniformBufferThroughStagingBuffer( newData, dataSize, uniformBuffer, 0 );
 	memcpy( uniformBuffer->m_uniformBufferMapped, newData, dataSize );
+	m_frameStatistics.m_uniformUploadBytes += dataSize;
 }
 
 void Renderer::UpdateSharedModelUniformBuffer( UniformBufferBinding const& binding, void* newData, size_t dataSize )
@@ -921,6 +1192,7 @@ void Renderer::UpdateSharedModelUniformBuffer( UniformBufferBinding const& bindi
 	if (binding.m_flags & UNIFORM_BUFFER_USE_MODEL_CONSTANTS_BINDING_2) {
 		//CopyDataToUniformBufferThroughStagingBuffer( newData, dataSize, m_sharedModelUniformBuffers[m_currentFrame], binding.m_modelUniformBufferOffset );
 		memcpy( (void*)((uint64_t)(m_sharedModelUniformBuffers[m_currentFrame])->m_uniformBufferMapped + binding.m_modelUniformBufferOffset), newData, dataSize );
+		m_frameStatistics.m_uniformUploadBytes += dataSize;
 	}
 }
 
@@ -929,6 +1201,12 @@ uint32_t Renderer::GetCurFrameNumber() const
 	return m_currentFrame;
 }
 
+uint32_t Renderer::GetSharedUniformGeneration() const
+{
+	// the shared model uniform buffers keep their contents, even when they grow
+	return 0;
+}
+
 Texture* Renderer::CreateTextureFromFile( std::string const& fileName )
 {
 	int texWidth, texHeight, texChannels;
@@ -988,6 +1266,71 @@ Texture* Renderer::CreateTextureFromBuffer( unsigned char const* buffer, uint64_
 	return texture;
 }
 
+void Renderer::UpdateTextureRegion( Texture* texture, uint32_t x, uint32_t y, uint32_t width, uint32_t height, unsigned char const* pixels )
+{
+	m_textureRegionUpdates.push_back( TextureRegionUpdate{ texture, x, y, width, height, m_textureRegionPixels.size() } );
+	m_textureRegionPixels.insert( m_textureRegionPixels.end(), pixels, pixels + (size_t)width * height * 4 );
+}
+
+void Renderer::RecordTextureRegionUpdates()
+{
+	if (m_textureRegionUpdates.empty()) {
+		return;
+	}
+	// one staging buffer for all regions of the frame, destroyed once the frame finished with it
+	VkBuffer stagingBuffer;
+	VkDeviceMemory stagingBufferMemory;
+	VkDeviceSize size = m_textureRegionPixels.size();
+	CreateBuffer( size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory );
+	void* data;
+	vkMapMemory( m_device, stagingBufferMemory, 0, size, 0, &data );
+	memcpy( data, m_textureRegionPixels.data(), m_textureRegionPixels.size() );
+	vkUnmapMemory( m_device, stagingBufferMemory );
+
+	VkCommandBuffer commandBuffer = m_commandBuffers[m_currentFrame];
+	VkImageMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.baseMipLevel = 0;
+	barrier.subresourceRange.levelCount = 1;
+	barrier.subresourceRange.baseArrayLayer = 0;
+	barrier.subresourceRange.layerCount = 1;
+	for (TextureRegionUpdate const& update : m_textureRegionUpdates) {
+		// the barrier also waits for the earlier frames still sampling the texture on this queue
+		barrier.image = update.m_texture->m_textureImage;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		vkCmdPipelineBarrier( commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier );
+
+		VkBufferImageCopy region{};
+		region.bufferOffset = update.m_pixelOffset;
+		region.bufferRowLength = 0;
+		region.bufferImageHeight = 0;
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = 0;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+		region.imageOffset = { (int32_t)update.m_x, (int32_t)update.m_y, 0 };
+		region.imageExtent = { update.m_width, update.m_height, 1 };
+		vkCmdCopyBufferToImage( commandBuffer, stagingBuffer, update.m_texture->m_textureImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region );
+
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier( commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier );
+	}
+	DeferredDestroyBuffer( stagingBuffer, stagingBufferMemory, false );
+
+	m_frameStatistics.m_textureUploadBytes += size;
+	m_textureRegionUpdates.clear();
+	m_textureRegionPixels.clear();
+}
+
 Texture* Renderer::CreateWhiteTexture()
 {
 	// RGBA (8 bits per component), 4 pixels (2x2)
@@ -1044,6 +1387,22 @@ IndexBuffer* Renderer::CreateIndexBuffer( void* indexData, uint64_t size, uint32
 	return indexBuffer;
 }
 
+void Renderer::CreateQuadIndexBuffer()
+{
+	std::vector<uint16_t> indices( (size_t)QUAD_INDEX_BUFFER_QUAD_COUNT * QUAD_INDEX_COUNT );
+	for (uint32_t quad = 0; quad < QUAD_INDEX_BUFFER_QUAD_COUNT; ++quad) {
+		uint16_t firstVertex = (uint16_t)(quad * QUAD_VERTEX_COUNT);
+		uint16_t* quadIndices = &indices[(size_t)quad * QUAD_INDEX_COUNT];
+		quadIndices[0] = firstVertex;
+		quadIndices[1] = firstVertex + 1;
+		quadIndices[2] = firstVertex + 2;
+		quadIndices[3] = firstVertex + 2;
+		quadIndices[4] = firstVertex + 3;
+		quadIndices[5] = firstVertex;
+	}
+	m_quadIndexBuffer = CreateIndexBuffer( indices.data(), indices.size() * sizeof( uint16_t ), (uint32_t)indices.size() );
+}
+
 VertexBuffer* Renderer::CreateVertexBuffer( void* vertexData, uint64_t size, uint32_t vertexCount )
 {
 	VkDeviceSize bufferSize = size;
@@ -1090,6 +1449,13 @@ Shader* Renderer::CreateShader( std::string const& fileName )
 	return shader;
 }
 
+Shader* Renderer::CreateShader( ShaderSource const& source )
+{
+	Shader* shader = new Shader( m_device, this );
+	shader->LoadShader( source );
+	return shader;
+}
+
 VertexBufferBinding Renderer::AddVertsDataToSharedVertexBuffer( void* vertexData, uint64_t size, uint32_t vertexCount )
 {
 	if (size == 0 || vertexCount == 0) {
@@ -1158,6 +1524,7 @@ VertexBufferBinding Renderer::AddVertsDataToSharedVertexBuffer( void* vertexData
 	}
 
 	CopyBuffer( m_stagingBuffers[m_currentFrame]->m_stagingBuffer, m_sharedMeshVertexBuffer->m_buffer, bufferSize, stagingOffset, dstOffset );
+	m_frameStatistics.m_vertexUploadBytes += bufferSize;
 	//DeferredDestroyBuffer( stagingBuffer, stagingBufferMemory );
 
 	VertexBufferBinding binding;
@@ -1234,6 +1601,7 @@ IndexBufferBinding Renderer::AddIndicesDataToSharedIndexBuffer( void* indexData,
 
 	m_sharedMeshIndexBuffer->m_indexCount += indexCount;
 	CopyBuffer( m_stagingBuffers[m_currentFrame]->m_stagingBuffer, m_sharedMeshIndexBuffer->m_buffer, bufferSize, stagingOffset, dstOffset );
+	m_frameStatistics.m_indexUploadBytes += bufferSize;
 
 	//DeferredDestroyBuffer( stagingBuffer, stagingBufferMemory );
 
@@ -1252,6 +1620,11 @@ UniformBufferBinding Renderer::AddDataToSharedUniformBuffer( UniformBufferDataBi
 		for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
 			VkDeviceSize dstOffset;
 			bool result = m_sharedModelUniformBuffers[i]->FindProperPositionForSizeInBuffer( dstOffset, sizeof( ModelUniformBufferObject ) );
+			// if the shared buffer is full, double it, every frame's buffer grows the same way so the offsets stay equal
+			if (!result) {
+				EnlargeSharedUniformBuffer( m_sharedModelUniformBuffers[i], m_sharedModelUniformBuffers[i]->m_maxSize * 2 );
+				result = m_sharedModelUniformBuffers[i]->FindProperPositionForSizeInBuffer( dstOffset, sizeof( ModelUniformBufferObject ) );
+			}
 			if (result) {
 				binding.m_modelUniformBufferOffset = dstOffset;
 			}
@@ -1263,6 +1636,23 @@ UniformBufferBinding Renderer::AddDataToSharedUniformBuffer( UniformBufferDataBi
 	return binding;
 }
 
+void Renderer::EnlargeSharedUniformBuffer( UniformBuffer* uniformBuffer, uint64_t newSize )
+{
+	VkBuffer newBuffer;
+	VkDeviceMemory newMemory;
+	void* newMapped;
+	CreateBuffer( newSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, newBuffer, newMemory );
+	vkMapMemory( m_device, newMemory, 0, newSize, 0, &newMapped );
+	memcpy( newMapped, uniformBuffer->m_uniformBufferMapped, (size_t)uniformBuffer->m_maxSize );
+
+	// draws recorded before still read the old buffer
+	DeferredDestroyBuffer( uniformBuffer->m_buffer, uniformBuffer->m_uniformBufferMemory, false );
+	uniformBuffer->m_buffer = newBuffer;
+	uniformBuffer->m_uniformBufferMemory = newMemory;
+	uniformBuffer->m_uniformBufferMapped = newMapped;
+	uniformBuffer->EnlargeBuffer( newSize );
+}
+
 void Renderer::ReturnMemoryToSharedBuffer( VertexBufferBinding const& vBinding, IndexBufferBinding const& iBinding, UniformBufferBinding const& uBinding )
 {
 	vBinding.m_vertexBuffer->ReturnMemory( vBinding.m_vertexBufferOffset, vBinding.m_vertexBufferVertexCount * vBinding.m_vertexBuffer->m_stride );
@@ -1301,6 +1691,32 @@ VertexBuffer* Renderer::CreateDynamicVertexBuffer( uint64_t size )
 	return vertexBuffer;
 }
 
+TransientVertexAllocation Renderer::AllocateTransientVertices( uint32_t vertexCount, VertexFormat format )
+{
+	TransientVertexFrame& frame = m_transientVertexFrames[m_currentFrame];
+	uint32_t vertexSize = GetVertexSize( format );
+	uint64_t size = (uint64_t)vertexCount * vertexSize;
+	if (frame.m_usedBytes + size > frame.m_buffer->m_maxSize) {
+		// the draws recorded so far still read the old buffer, the bigger one is kept for the next frames
+		uint64_t newSize = frame.m_buffer->m_maxSize * 2;
+		while (newSize < size) {
+			newSize *= 2;
+		}
+		frame.m_retiredBuffers.push_back( frame.m_buffer );
+		frame.m_buffer = CreateDynamicVertexBuffer( newSize );
+		frame.m_usedBytes = 0;
+	}
+	TransientVertexAllocation allocation;
+	allocation.m_vertices = (unsigned char*)frame.m_buffer->m_mappedData + frame.m_usedBytes;
+	allocation.m_vertexSize = vertexSize;
+	allocation.m_binding.m_vertexBuffer = frame.m_buffer;
+	allocation.m_binding.m_vertexBufferOffset = frame.m_usedBytes;
+	allocation.m_binding.m_vertexBufferVertexCount = vertexCount;
+	frame.m_usedBytes += size;
+	m_frameStatistics.m_transientVertexBytes += size;
+	return allocation;
+}
+
 void Renderer::CopyDataToVertexBufferThroughStagingBuffer( void* buffer, uint64_t size, VertexBuffer* vertexBuffer, uint64_t dstOffset )
 {
 	if (size == 0) {
@@ -1347,7 +1763,15 @@ void Renderer::CleanupSwapChain()
 		vkDestroyImageView( m_device, imageView, nullptr );
 	}
 
-	vkDestroySwapchainKHR( m_device, m_swapChain, nullptr );
+	if (m_config.m_headless) {
+		for (size_t i = 0; i < m_swapChainImages.size(); ++i) {
+			vkDestroyImage( m_device, m_swapChainImages[i], nullptr );
+			vkFreeMemory( m_device, m_offscreenImageMemories[i], nullptr );
+		}
+	}
+	else {
+		vkDestroySwapchainKHR( m_device, m_swapChain, nullptr );
+	}
 }
 
 void Renderer::RecreateSwapChain()
@@ -1550,7 +1974,9 @@ QueueFamilyIndices Renderer::FindQueueFamilies( VkPhysicalDevice device )
 			foundOne = true;
 		}
 		VkBool32 presentSupport = false;
-		vkGetPhysicalDeviceSurfaceSupportKHR( device, i, m_surface, &presentSupport );
+		if (m_surface != VK_NULL_HANDLE) {
+			vkGetPhysicalDeviceSurfaceSupportKHR( device, i, m_surface, &presentSupport );
+		}
 		if (presentSupport && !foundOne) {
 			indices.m_presentFamily = i;
 			foundOne = true;
@@ -1568,7 +1994,11 @@ QueueFamilyIndices Renderer::FindQueueFamilies( VkPhysicalDevice device )
 		i++;
 	}
 
-	if (!indices.m_presentFamily.has_value()) {
+	if (!indices.m_presentFamily.has_value() && m_config.m_headless) {
+		// nothing is presented, the present queue is just the graphics queue
+		indices.m_presentFamily = indices.m_graphicsFamily;
+	}
+	else if (!indices.m_presentFamily.has_value()) {
 		for (int i = 0; i < queueFamilies.size(); ++i) {
 			VkBool32 presentSupport = false;
 			vkGetPhysicalDeviceSurfaceSupportKHR( device, i, m_surface, &presentSupport );
@@ -1689,8 +2119,8 @@ bool Renderer::IsDeviceSuitable( VkPhysicalDevice device )
 
 	bool extensionsSupported = CheckDeviceExtensionSupport( device );
 
-	bool swapChainAdequate = false;
-	if (extensionsSupported) {
+	bool swapChainAdequate = m_config.m_headless;
+	if (extensionsSupported && !m_config.m_headless) {
 		SwapChainSupportDetails swapChainSupport = QuerySwapChainSupport( device );
 		swapChainAdequate = !swapChainSupport.m_formats.empty() && !swapChainSupport.m_presentModes.empty();
 	}
@@ -1771,11 +2201,13 @@ uint32_t Renderer::FindMemoryType( uint32_t typeFilter, VkMemoryPropertyFlags pr
 
 std::vector<const char*> Renderer::GetRequiredExtensions()
 {
-	uint32_t glfwExtensionCount = 0;
-	const char** glfwExtensions;
-	glfwExtensions = glfwGetRequiredInstanceExtensions( &glfwExtensionCount );
-
-	std::vector<const char*> extensions( glfwExtensions, glfwExtensions + glfwExtensionCount );
+	std::vector<const char*> extensions;
+	if (!m_config.m_headless) {
+		uint32_t glfwExtensionCount = 0;
+		const char** glfwExtensions;
+		glfwExtensions = glfwGetRequiredInstanceExtensions( &glfwExtensionCount );
+		extensions.assign( glfwExtensions, glfwExtensions + glfwExtensionCount );
+	}
 
 	if (enableValidationLayers) {
 		extensions.push_back( VK_EXT_DEBUG_UTILS_EXTENSION_NAME );
@@ -1784,6 +2216,14 @@ std::vector<const char*> Renderer::GetRequiredExtensions()
 	return extensions;
 }
 
+std::vector<const char*> Renderer::GetRequiredDeviceExtensions() const
+{
+	if (m_config.m_headless) {
+		return {};
+	}
+	return deviceExtensions;
+}
+
 bool Renderer::CheckDeviceExtensionSupport( VkPhysicalDevice device )
 {
 	uint32_t extensionCount;
@@ -1792,7 +2232,8 @@ bool Renderer::CheckDeviceExtensionSupport( VkPhysicalDevice device )
 	std::vector<VkExtensionProperties> availableExtensions( extensionCount );
 	vkEnumerateDeviceExtensionProperties( device, nullptr, &extensionCount, availableExtensions.data() );
 
-	std::set<std::string> requiredExtensions( deviceExtensions.begin(), deviceExtensions.end() );
+	std::vector<const char*> requiredDeviceExtensions = GetRequiredDeviceExtensions();
+	std::set<std::string> requiredExtensions( requiredDeviceExtensions.begin(), requiredDeviceExtensions.end() );
 
 	for (const auto& extension : availableExtensions) {
 		requiredExtensions.erase( extension.extensionName );
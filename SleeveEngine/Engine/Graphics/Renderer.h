@@ -13,8 +13,10 @@
 #include "Core/EngineFwdMinor.h"
 #include "Graphics/GraphicsFwd.h"
 #include "Graphics/GraphicsCommon.h"
+#include "Graphics/RendererInterface.h"
 
 struct PerspectiveCamera;
+class GpuProfiler;
 
 const std::vector<const char*> validationLayers = {
 	"VK_LAYER_KHRONOS_validation",
@@ -47,61 +49,77 @@ const bool enableValidationLayers = false;
 const bool enableValidationLayers = true;
 #endif
 
-class Renderer {
+/// Vulkan backend of the RendererInterface
+class Renderer : public RendererInterface {
 	friend class Shader;
 	friend class DescriptorPools;
 public:
-	void Initialize();
-	void Cleanup();
-	void WaitForCleanup();
-	void BeginFrame();
-	void EndFrame();
-
-	void BeginCamera( Camera const* camera );
-	void EndCamera( Camera const* camera );
-
-	float GetSwapChainExtentRatio() const;
-
-	void DrawSingleBufferIndexed( VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, uint64_t vertexOffset = 0, uint64_t indexOffset = 0 );
-	void Draw( VertexBufferBinding const& vertexBinding );
-	void DrawIndexed( VertexBufferBinding const& vertexBinding, IndexBufferBinding const& indexBinding );
-
-	void BindShader( Shader* shader );
-	void BeginDrawCommands( UniformBufferBinding const& uniformBufferBinding, TextureBinding const& textureBinding );
-
-	void UpdateUniformBuffer( UniformBuffer* uniformBuffer, void* newData, size_t dataSize );
-	void UpdateSharedModelUniformBuffer( UniformBufferBinding const& binding, void* newData, size_t dataSize );
-	uint32_t GetCurFrameNumber() const;
-
-	Texture* CreateTextureFromFile( std::string const& fileName );
-	Texture* CreateTextureFromBuffer( unsigned char const* buffer, uint64_t size, uint32_t width, uint32_t height );
-	Texture* CreateWhiteTexture();
+	virtual void Initialize( RendererConfig const& config = RendererConfig() ) override;
+	virtual void Cleanup() override;
+	virtual void WaitForCleanup() override;
+	virtual void BeginFrame() override;
+	virtual void EndFrame() override;
+
+	virtual void BeginCamera( Camera const* camera ) override;
+	virtual void EndCamera( Camera const* camera ) override;
+
+	virtual float GetSwapChainExtentRatio() const override;
+
+	virtual void DrawSingleBufferIndexed( VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, uint64_t vertexOffset = 0, uint64_t indexOffset = 0 ) override;
+	virtual void Draw( VertexBufferBinding const& vertexBinding ) override;
+	virtual void DrawIndexed( VertexBufferBinding const& vertexBinding, IndexBufferBinding const& indexBinding ) override;
+	virtual void DrawQuads( VertexBufferBinding const& vertexBinding ) override;
+
+	virtual void BindShader( Shader* shader ) override;
+	virtual void BeginDrawCommands( UniformBufferBinding const& uniformBufferBinding, TextureBinding const& textureBinding ) override;
+
+	virtual void UpdateUniformBuffer( UniformBuffer* uniformBuffer, void* newData, size_t dataSize ) override;
+	virtual void UpdateSharedModelUniformBuffer( UniformBufferBinding const& binding, void* newData, size_t dataSize ) override;
+	virtual uint32_t GetCurFrameNumber() const override;
+	virtual uint32_t GetSharedUniformGeneration() const override;
+
+	virtual Texture* CreateTextureFromFile( std::string const& fileName ) override;
+	virtual Texture* CreateTextureFromBuffer( unsigned char const* buffer, uint64_t size, uint32_t width, uint32_t height ) override;
+	virtual Texture* CreateWhiteTexture() override;
+	virtual void UpdateTextureRegion( Texture* texture, uint32_t x, uint32_t y, uint32_t width, uint32_t height, unsigned char const* pixels ) override;
 	//Texture* CreateTexture();
-	IndexBuffer* CreateIndexBuffer( void* indexData, uint64_t size, uint32_t indexCount );
-	VertexBuffer* CreateVertexBuffer( void* vertexData, uint64_t size, uint32_t vertexCount );
-	UniformBuffer* CreateUniformBuffer( uint64_t size );
-	Shader* CreateShader( std::string const& fileName );
-
-	VertexBufferBinding AddVertsDataToSharedVertexBuffer( void* vertexData, uint64_t size, uint32_t vertexCount );
-	IndexBufferBinding AddIndicesDataToSharedIndexBuffer( void* indexData, uint64_t size, uint32_t indexCount );
-	UniformBufferBinding AddDataToSharedUniformBuffer( UniformBufferDataBindingFlags flags );
-	void ReturnMemoryToSharedBuffer( VertexBufferBinding const& vBinding, IndexBufferBinding const& iBinding, UniformBufferBinding const& uBinding );
-	void ReturnMemoryToSharedBuffer( VertexBufferBinding const& vBinding );
-	void ReturnMemoryToSharedBuffer( UniformBufferBinding const& uBinding );
-	void ReturnMemoryToSharedBuffer( IndexBufferBinding const& iBinding );
-
-	VertexBuffer* CreateDynamicVertexBuffer( uint64_t size );
+	virtual IndexBuffer* CreateIndexBuffer( void* indexData, uint64_t size, uint32_t indexCount ) override;
+	virtual VertexBuffer* CreateVertexBuffer( void* vertexData, uint64_t size, uint32_t vertexCount ) override;
+	virtual UniformBuffer* CreateUniformBuffer( uint64_t size ) override;
+	virtual Shader* CreateShader( std::string const& fileName ) override;
+	virtual Shader* CreateShader( ShaderSource const& source ) override;
+
+	virtual VertexBufferBinding AddVertsDataToSharedVertexBuffer( void* vertexData, uint64_t size, uint32_t vertexCount ) override;
+	virtual IndexBufferBinding AddIndicesDataToSharedIndexBuffer( void* indexData, uint64_t size, uint32_t indexCount ) override;
+	virtual UniformBufferBinding AddDataToSharedUniformBuffer( UniformBufferDataBindingFlags flags ) override;
+	virtual void ReturnMemoryToSharedBuffer( VertexBufferBinding const& vBinding, IndexBufferBinding const& iBinding, UniformBufferBinding const& uBinding ) override;
+	virtual void ReturnMemoryToSharedBuffer( VertexBufferBinding const& vBinding ) override;
+	virtual void ReturnMemoryToSharedBuffer( UniformBufferBinding const& uBinding ) override;
+	virtual void ReturnMemoryToSharedBuffer( IndexBufferBinding const& iBinding ) override;
+
+	virtual VertexBuffer* CreateDynamicVertexBuffer( uint64_t size ) override;
+	virtual TransientVertexAllocation AllocateTransientVertices( uint32_t vertexCount, VertexFormat format ) override;
 	/// buggy! do not use
 	void CopyDataToVertexBufferThroughStagingBuffer( void* buffer, uint64_t size, VertexBuffer* vertexBuffer, uint64_t dstOffset );
 	/// buggy! do not use
 	void CopyDataToUniformBufferThroughStagingBuffer( void* buffer, uint64_t size, UniformBuffer* uniformBuffer, uint64_t dstOffset );
 
-	void DeferredDestroyBuffer( UniformBuffer* buffer, bool isTransfer );
-	void DeferredDestroyBuffer( VertexBuffer* buffer, bool isTransfer );
-	void DeferredDestroyBuffer( IndexBuffer* buffer, bool isTransfer );
+	virtual void DeferredDestroyBuffer( UniformBuffer* buffer, bool isTransfer ) override;
+	virtual void DeferredDestroyBuffer( VertexBuffer* buffer, bool isTransfer ) override;
+	virtual void DeferredDestroyBuffer( IndexBuffer* buffer, bool isTransfer ) override;
 	void DeferredDestroyBuffer( VkBuffer buffer, VkDeviceMemory deviceMemory, bool isTransfer );
 
 	void LetDeviceWaitIdle();
+
+	virtual void BeginGpuSection( char const* name ) override;
+	virtual void EndGpuSection() override;
+	virtual GpuFrameTimings const& GetLastGpuFrameTimings() const override;
+	virtual RendererFrameStatistics const& GetLastFrameStatistics() const override;
+	virtual RendererStatisticsHistory const& GetFrameStatisticsHistory() const override;
+
+	virtual bool IsHeadless() const override;
+	/// (headless only) get the pixels of the last frame the GPU finished, tightly packed RGBA8 rows from top to bottom
+	virtual bool ReadLastFrame( std::vector<unsigned char>& out_pixels, uint32_t& out_width, uint32_t& out_height ) const override;
 protected:
 	void CreateInstance();
 
@@ -117,6 +135,17 @@ protected:
 
 	void CreateSwapChainImageViews();
 
+	void CreateOffscreenTargets();
+
+	void CreateReadbackBuffers();
+
+	void RecordFrameReadback();
+
+	/// size of the vertices a draw reads, dynamic vertex buffers have no stride and always hold VertexPCU3D
+	uint64_t GetVertexBytes( VertexBufferBinding const& vertexBinding ) const;
+
+	void CopyFinishedReadback( uint32_t frameIndex );
+
 	void CreateRenderPass();
 
 	void CreateFramebuffers();
@@ -152,8 +181,11 @@ protected:
 	VertexBuffer* CreateSharedVertexBuffer( uint64_t size, uint32_t stride );
 
 	IndexBuffer* CreateSharedIndexBuffer( uint64_t size );
+	void CreateQuadIndexBuffer();
 	
 	UniformBuffer* CreateSharedUniformBuffer( uint64_t size, uint32_t stride );
+	/// replace the buffer of a shared uniform buffer with a bigger one and keep its data and allocations
+	void EnlargeSharedUniformBuffer( UniformBuffer* uniformBuffer, uint64_t newSize );
 
 	void CreateBuffer( VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory );
 
@@ -163,6 +195,9 @@ protected:
 
 	void CopyBufferToImage( VkBuffer buffer, VkImage image, uint32_t width, uint32_t height );
 
+	/// record the pending texture region copies on the frame's command buffer, outside of the render pass
+	void RecordTextureRegionUpdates();
+
 	QueueFamilyIndices FindQueueFamilies( VkPhysicalDevice device );
 
 	SwapChainSupportDetails QuerySwapChainSupport( VkPhysicalDevice device );
@@ -195,6 +230,8 @@ protected:
 
 	std::vector<const char*> GetRequiredExtensions();
 
+	std::vector<const char*> GetRequiredDeviceExtensions() const;
+
 	bool CheckDeviceExtensionSupport( VkPhysicalDevice device );
 
 	static VKAPI_ATTR VkBool32 VKAPI_CALL DebugCallback(
@@ -211,7 +248,7 @@ protected:
 	VkQueue m_graphicsQueue;
 	VkQueue m_presentQueue;
 	VkQueue m_transferQueue;
-	VkSurfaceKHR m_surface;
+	VkSurfaceKHR m_surface = VK_NULL_HANDLE;
 	VkSwapchainKHR m_swapChain;
 	std::vector<VkImage> m_swapChainImages;
 	VkFormat m_swapChainImageFormat;
@@ -239,13 +276,33 @@ protected:
 	std::vector<VkFramebuffer> m_swapChainFramebuffers;
 	uint32_t m_currentFrame = 0;
 
+	RendererConfig m_config;
+	// headless: offscreen color images are stored in m_swapChainImages, their memory here
+	std::vector<VkDeviceMemory> m_offscreenImageMemories;
+	std::vector<VkBuffer> m_readbackBuffers;
+	std::vector<VkDeviceMemory> m_readbackBufferMemories;
+	std::vector<void*> m_readbackMappedData;
+	std::array<bool, MAX_FRAMES_IN_FLIGHT> m_isReadbackPending = {};
+	std::vector<unsigned char> m_lastReadbackPixels;
+
 	uint32_t m_curImageIndex = 0;
 
+	GpuProfiler* m_gpuProfiler = nullptr;
+	bool m_supportsPipelineStatistics = false;
+	GpuFrameTimings m_emptyGpuFrameTimings;
+	RendererFrameStatistics m_frameStatistics;
+	RendererStatisticsHistory m_statisticsHistory;
+
 	VertexBuffer* m_sharedMeshVertexBuffer = nullptr;
 	IndexBuffer* m_sharedMeshIndexBuffer = nullptr;
+	/// 0 1 2 2 3 0 for every quad, read by DrawQuads
+	IndexBuffer* m_quadIndexBuffer = nullptr;
 	std::array<UniformBuffer*, MAX_FRAMES_IN_FLIGHT> m_sharedModelUniformBuffers;
 
 	std::vector<BufferCopyCommand> m_copyCommands;
+	std::array<TransientVertexFrame, MAX_FRAMES_IN_FLIGHT> m_transientVertexFrames;
+	std::vector<TextureRegionUpdate> m_textureRegionUpdates;
+	std::vector<unsigned char> m_textureRegionPixels;
 	std::vector<BufferPendingToDestroy> m_pendingDestroyBuffers;
 	std::vector<StagingBuffer*> m_stagingBuffers;
 
@@ -0,0 +1,153 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/// Capture file: the header, then commands of a 16 bit type and a 32 bit payload size
+/// Renderer objects are numbered in the order they were created, 0 is null
+constexpr char RENDERER_CAPTURE_MAGIC[8] = { 'S', 'L', 'V', 'C', 'A', 'P', 'T', 'R' };
+constexpr uint32_t RENDERER_CAPTURE_VERSION = 5;
+
+enum class RendererCaptureCommand : uint16_t {
+	// resources, recorded from startup so the captured frames can be replayed alone
+	CREATE_TEXTURE_FROM_FILE,
+	CREATE_TEXTURE_FROM_BUFFER,
+	CREATE_WHITE_TEXTURE,
+	CREATE_INDEX_BUFFER,
+	CREATE_VERTEX_BUFFER,
+	CREATE_UNIFORM_BUFFER,
+	CREATE_DYNAMIC_VERTEX_BUFFER,
+	CREATE_SHADER_FROM_FILE,
+	CREATE_SHADER_FROM_SOURCE,
+	ADD_SHARED_VERTICES,
+	ADD_SHARED_INDICES,
+	ADD_SHARED_UNIFORM,
+	RETURN_SHARED_VERTICES,
+	RETURN_SHARED_INDICES,
+	RETURN_SHARED_UNIFORM,
+	DESTROY_UNIFORM_BUFFER,
+	DESTROY_VERTEX_BUFFER,
+	DESTROY_INDEX_BUFFER,
+	UPDATE_UNIFORM_BUFFER,
+	UPDATE_TEXTURE_REGION,
+	// frames, only recorded in the captured frame range
+	BEGIN_FRAME,
+	END_FRAME,
+	BEGIN_CAMERA,
+	END_CAMERA,
+	WRITE_DYNAMIC_VERTICES,
+	ALLOCATE_TRANSIENT_VERTICES,
+	DRAW,
+	DRAW_INDEXED,
+	DRAW_SINGLE_BUFFER_INDEXED,
+	DRAW_QUADS,
+	BIND_SHADER,
+	BEGIN_DRAW_COMMANDS,
+	UPDATE_SHARED_MODEL_UNIFORM,
+	BEGIN_GPU_SECTION,
+	END_GPU_SECTION,
+};
+
+class RendererCaptureWriter {
+public:
+	void BeginCommand( RendererCaptureCommand command )
+	{
+		Write( (uint16_t)command );
+		m_commandSizePos = m_data.size();
+		Write( (uint32_t)0 );
+	}
+
+	void EndCommand()
+	{
+		uint32_t size = (uint32_t)(m_data.size() - m_commandSizePos - sizeof( uint32_t ));
+		memcpy( m_data.data() + m_commandSizePos, &size, sizeof( size ) );
+	}
+
+	void WriteRaw( void const* data, size_t size )
+	{
+		unsigned char const* bytes = (unsigned char const*)data;
+		m_data.insert( m_data.end(), bytes, bytes + size );
+	}
+
+	template<typename T>
+	void Write( T const& value )
+	{
+		WriteRaw( &value, sizeof( T ) );
+	}
+
+	/// 64 bit size followed by the bytes
+	void WriteBytes( void const* data, uint64_t size )
+	{
+		Write( size );
+		WriteRaw( data, (size_t)size );
+	}
+
+	void WriteString( std::string const& string )
+	{
+		WriteBytes( string.data(), string.size() );
+	}
+
+	std::vector<unsigned char> m_data;
+	size_t m_commandSizePos = 0;
+};
+
+/// Reads past the end return zeros and mark the reader as failed
+class RendererCaptureReader {
+public:
+	RendererCaptureReader( unsigned char const* data, size_t size )
+		:m_data( data ), m_size( size )
+	{
+	}
+
+	bool ReadRaw( void* out_data, size_t size )
+	{
+		if (m_failed || size > m_size - m_pos) {
+			m_failed = true;
+			memset( out_data, 0, size );
+			return false;
+		}
+		memcpy( out_data, m_data + m_pos, size );
+		m_pos += size;
+		return true;
+	}
+
+	template<typename T>
+	T Read()
+	{
+		T value;
+		ReadRaw( &value, sizeof( T ) );
+		return value;
+	}
+
+	/// points into the capture, valid as long as the capture data
+	unsigned char const* ReadBytes( uint64_t& out_size )
+	{
+		out_size = Read<uint64_t>();
+		if (m_failed || out_size > m_size - m_pos) {
+			m_failed = true;
+			out_size = 0;
+			return nullptr;
+		}
+		unsigned char const* bytes = m_data + m_pos;
+		m_pos += (size_t)out_size;
+		return bytes;
+	}
+
+	std::string ReadString()
+	{
+		uint64_t size = 0;
+		unsigned char const* bytes = ReadBytes( size );
+		return bytes ? std::string( (char const*)bytes, (size_t)size ) : std::string();
+	}
+
+	bool IsAtEnd() const { return m_pos >= m_size; }
+	bool HasFailed() const { return m_failed; }
+	size_t GetPosition() const { return m_pos; }
+	void SetPosition( size_t pos ) { m_pos = pos; }
+
+	unsigned char const* m_data = nullptr;
+	size_t m_size = 0;
+	size_t m_pos = 0;
+	bool m_failed = false;
+};
@@ -0,0 +1,447 @@
+#include "Graphics/RendererCaptureReplayer.h"
+#include "Graphics/GraphicsFwd.h"
+#include "Core/Error.h"
+
+#include <cstdio>
+
+/// Camera with the matrices and uniform buffers a captured BeginCamera used
+struct CapturedCamera : public Camera {
+	virtual void BeginPlay() override {}
+	virtual Mat44 GetViewMatrix() const override { return m_viewMatrix; }
+	virtual Mat44 GetProjectionMatrix() const override { return m_projectionMatrix; }
+
+	Mat44 m_viewMatrix;
+	Mat44 m_projectionMatrix;
+};
+
+RendererCaptureReplayer::RendererCaptureReplayer( RendererInterface* renderer )
+	:m_renderer( renderer )
+{
+}
+
+RendererCaptureReplayer::~RendererCaptureReplayer()
+{
+	for (CapturedCamera* camera : m_cameras) {
+		delete camera;
+	}
+}
+
+void RendererCaptureReplayer::Load( std::string const& path )
+{
+	FILE* file = nullptr;
+	fopen_s( &file, path.c_str(), "rb" );
+	ASSERT_OR_ERROR( file, "Cannot open renderer capture " + path );
+	fseek( file, 0, SEEK_END );
+	long fileSize = ftell( file );
+	fseek( file, 0, SEEK_SET );
+	m_data.resize( fileSize > 0 ? (size_t)fileSize : 0 );
+	size_t readSize = fread( m_data.data(), 1, m_data.size(), file );
+	fclose( file );
+	ASSERT_OR_ERROR( readSize == m_data.size(), "Cannot read renderer capture " + path );
+
+	RendererCaptureReader reader( m_data.data(), m_data.size() );
+	char magic[sizeof( RENDERER_CAPTURE_MAGIC )] = {};
+	reader.ReadRaw( magic, sizeof( magic ) );
+	ASSERT_OR_ERROR( memcmp( magic, RENDERER_CAPTURE_MAGIC, sizeof( magic ) ) == 0, path + " is not a renderer capture" );
+	uint32_t version = reader.Read<uint32_t>();
+	ASSERT_OR_ERROR( version == RENDERER_CAPTURE_VERSION, "Renderer capture version " + std::to_string( version ) + " is not supported" );
+	m_pos = reader.GetPosition();
+
+	// count the frames and check that every command fits in the file before running any of them
+	size_t firstFramePos = m_data.size();
+	while (!reader.IsAtEnd()) {
+		size_t commandPos = reader.GetPosition();
+		RendererCaptureCommand command = (RendererCaptureCommand)reader.Read<uint16_t>();
+		uint32_t size = reader.Read<uint32_t>();
+		ASSERT_OR_ERROR( !reader.HasFailed() && size <= m_data.size() - reader.GetPosition(), "Renderer capture " + path + " is truncated" );
+		if (command == RendererCaptureCommand::BEGIN_FRAME) {
+			if (m_frameCount == 0) {
+				firstFramePos = commandPos;
+			}
+			++m_frameCount;
+		}
+		reader.SetPosition( reader.GetPosition() + size );
+	}
+
+	// create everything the game made before the captured frames
+	reader.SetPosition( m_pos );
+	while (reader.GetPosition() < firstFramePos) {
+		RendererCaptureCommand command = (RendererCaptureCommand)reader.Read<uint16_t>();
+		uint32_t size = reader.Read<uint32_t>();
+		size_t endPos = reader.GetPosition() + size;
+		ExecuteCommand( command, reader );
+		reader.SetPosition( endPos );
+	}
+	m_pos = reader.GetPosition();
+}
+
+bool RendererCaptureReplayer::ReplayNextFrame()
+{
+	if (m_replayedFrameCount >= m_frameCount) {
+		return false;
+	}
+	RendererCaptureReader reader( m_data.data(), m_data.size() );
+	reader.SetPosition( m_pos );
+	while (!reader.IsAtEnd()) {
+		RendererCaptureCommand command = (RendererCaptureCommand)reader.Read<uint16_t>();
+		uint32_t size = reader.Read<uint32_t>();
+		size_t endPos = reader.GetPosition() + size;
+		ExecuteCommand( command, reader );
+		ASSERT_OR_ERROR( !reader.HasFailed() && reader.GetPosition() <= endPos, "Renderer capture command " + std::to_string( (uint32_t)command ) + " is corrupt" );
+		reader.SetPosition( endPos );
+		if (command == RendererCaptureCommand::END_FRAME) {
+			break;
+		}
+	}
+	m_pos = reader.GetPosition();
+	++m_replayedFrameCount;
+	return true;
+}
+
+uint32_t RendererCaptureReplayer::GetFrameCount() const
+{
+	return m_frameCount;
+}
+
+uint32_t RendererCaptureReplayer::GetReplayedFrameCount() const
+{
+	return m_replayedFrameCount;
+}
+
+void RendererCaptureReplayer::ExecuteCommand( RendererCaptureCommand command, RendererCaptureReader& reader )
+{
+	uint64_t size = 0;
+	switch (command) {
+	case RendererCaptureCommand::CREATE_TEXTURE_FROM_FILE: {
+		uint32_t id = reader.Read<uint32_t>();
+		SetObject( id, m_renderer->CreateTextureFromFile( reader.ReadString() ) );
+		break;
+	}
+	case RendererCaptureCommand::CREATE_TEXTURE_FROM_BUFFER: {
+		uint32_t id = reader.Read<uint32_t>();
+		uint32_t width = reader.Read<uint32_t>();
+		uint32_t height = reader.Read<uint32_t>();
+		unsigned char const* pixels = reader.ReadBytes( size );
+		SetObject( id, m_renderer->CreateTextureFromBuffer( pixels, size, width, height ) );
+		break;
+	}
+	case RendererCaptureCommand::CREATE_WHITE_TEXTURE: {
+		uint32_t id = reader.Read<uint32_t>();
+		SetObject( id, m_renderer->CreateWhiteTexture() );
+		break;
+	}
+	case RendererCaptureCommand::CREATE_INDEX_BUFFER: {
+		uint32_t id = reader.Read<uint32_t>();
+		uint32_t indexCount = reader.Read<uint32_t>();
+		unsigned char const* indices = reader.ReadBytes( size );
+		SetObject( id, m_renderer->CreateIndexBuffer( (void*)indices, size, indexCount ) );
+		break;
+	}
+	case RendererCaptureCommand::CREATE_VERTEX_BUFFER: {
+		uint32_t id = reader.Read<uint32_t>();
+		uint32_t vertexCount = reader.Read<uint32_t>();
+		unsigned char const* vertices = reader.ReadBytes( size );
+		SetObject( id, m_renderer->CreateVertexBuffer( (void*)vertices, size, vertexCount ) );
+		break;
+	}
+	case RendererCaptureCommand::CREATE_UNIFORM_BUFFER: {
+		uint32_t id = reader.Read<uint32_t>();
+		SetObject( id, m_renderer->CreateUniformBuffer( reader.Read<uint64_t>() ) );
+		break;
+	}
+	case RendererCaptureCommand::CREATE_DYNAMIC_VERTEX_BUFFER: {
+		uint32_t id = reader.Read<uint32_t>();
+		uint64_t bufferSize = reader.Read<uint64_t>();
+		SetObject( id, m_renderer->CreateDynamicVertexBuffer( bufferSize ) );
+		m_dynamicVertexBufferSlices[id] = bufferSize / MAX_FRAMES_IN_FLIGHT;
+		break;
+	}
+	case RendererCaptureCommand::CREATE_SHADER_FROM_FILE: {
+		uint32_t id = reader.Read<uint32_t>();
+		SetObject( id, m_renderer->CreateShader( reader.ReadString() ) );
+		break;
+	}
+	case RendererCaptureCommand::CREATE_SHADER_FROM_SOURCE: {
+		uint32_t id = reader.Read<uint32_t>();
+		ShaderSource source;
+		source.m_name = reader.ReadString();
+		char const* vertexCode = (char const*)reader.ReadBytes( size );
+		source.m_vertexCode.assign( vertexCode, vertexCode + size );
+		char const* fragmentCode = (char const*)reader.ReadBytes( size );
+		source.m_fragmentCode.assign( fragmentCode, fragmentCode + size );
+		SetObject( id, m_renderer->CreateShader( source ) );
+		break;
+	}
+	case RendererCaptureCommand::ADD_SHARED_VERTICES: {
+		uint32_t vertexCount = reader.Read<uint32_t>();
+		unsigned char const* vertices = reader.ReadBytes( size );
+		uint32_t bufferId = reader.Read<uint32_t>();
+		uint64_t capturedOffset = reader.Read<uint64_t>();
+		reader.Read<uint32_t>();
+		VertexBufferBinding binding = m_renderer->AddVertsDataToSharedVertexBuffer( (void*)vertices, size, vertexCount );
+		m_sharedVertexBufferId = bufferId;
+		// the shared buffer can be recreated when it grows, always point the id at the current one
+		SetObject( bufferId, binding.m_vertexBuffer );
+		m_sharedVertexOffsets[capturedOffset] = binding.m_vertexBufferOffset;
+		break;
+	}
+	case RendererCaptureCommand::ADD_SHARED_INDICES: {
+		uint32_t indexCount = reader.Read<uint32_t>();
+		unsigned char const* indices = reader.ReadBytes( size );
+		uint32_t bufferId = reader.Read<uint32_t>();
+		uint64_t capturedOffset = reader.Read<uint64_t>();
+		reader.Read<uint32_t>();
+		IndexBufferBinding binding = m_renderer->AddIndicesDataToSharedIndexBuffer( (void*)indices, size, indexCount );
+		m_sharedIndexBufferId = bufferId;
+		SetObject( bufferId, binding.m_indexBuffer );
+		m_sharedIndexOffsets[capturedOffset] = binding.m_indexBufferOffset;
+		break;
+	}
+	case RendererCaptureCommand::ADD_SHARED_UNIFORM: {
+		UniformBufferDataBindingFlags flags = reader.Read<UniformBufferDataBindingFlags>();
+		reader.Read<uint32_t>();
+		uint64_t capturedOffset = reader.Read<uint64_t>();
+		UniformBufferBinding binding = m_renderer->AddDataToSharedUniformBuffer( flags );
+		m_sharedUniformOffsets[capturedOffset] = binding.m_modelUniformBufferOffset;
+		break;
+	}
+	case RendererCaptureCommand::RETURN_SHARED_VERTICES: {
+		VertexBufferBinding binding = ReadVertexBinding( reader );
+		m_renderer->ReturnMemoryToSharedBuffer( binding );
+		break;
+	}
+	case RendererCaptureCommand::RETURN_SHARED_INDICES: {
+		IndexBufferBinding binding = ReadIndexBinding( reader );
+		m_renderer->ReturnMemoryToSharedBuffer( binding );
+		break;
+	}
+	case RendererCaptureCommand::RETURN_SHARED_UNIFORM: {
+		UniformBufferBinding binding = ReadUniformBinding( reader );
+		m_renderer->ReturnMemoryToSharedBuffer( binding );
+		break;
+	}
+	case RendererCaptureCommand::DESTROY_UNIFORM_BUFFER: {
+		uint32_t id = reader.Read<uint32_t>();
+		bool isTransfer = reader.Read<bool>();
+		m_renderer->DeferredDestroyBuffer( (UniformBuffer*)GetObject( id ), isTransfer );
+		SetObject( id, nullptr );
+		break;
+	}
+	case RendererCaptureCommand::DESTROY_VERTEX_BUFFER: {
+		uint32_t id = reader.Read<uint32_t>();
+		bool isTransfer = reader.Read<bool>();
+		m_renderer->DeferredDestroyBuffer( (VertexBuffer*)GetObject( id ), isTransfer );
+		SetObject( id, nullptr );
+		m_dynamicVertexBufferSlices.erase( id );
+		break;
+	}
+	case RendererCaptureCommand::DESTROY_INDEX_BUFFER: {
+		uint32_t id = reader.Read<uint32_t>();
+		bool isTransfer = reader.Read<bool>();
+		m_renderer->DeferredDestroyBuffer( (IndexBuffer*)GetObject( id ), isTransfer );
+		SetObject( id, nullptr );
+		break;
+	}
+	case RendererCaptureCommand::UPDATE_UNIFORM_BUFFER: {
+		UniformBuffer* buffer = (UniformBuffer*)GetObject( reader.Read<uint32_t>() );
+		unsigned char const* data = reader.ReadBytes( size );
+		m_renderer->UpdateUniformBuffer( buffer, (void*)data, (size_t)size );
+		break;
+	}
+	case RendererCaptureCommand::UPDATE_TEXTURE_REGION: {
+		Texture* texture = (Texture*)GetObject( reader.Read<uint32_t>() );
+		uint32_t x = reader.Read<uint32_t>();
+		uint32_t y = reader.Read<uint32_t>();
+		uint32_t width = reader.Read<uint32_t>();
+		uint32_t height = reader.Read<uint32_t>();
+		unsigned char const* pixels = reader.ReadBytes( size );
+		m_renderer->UpdateTextureRegion( texture, x, y, width, height, pixels );
+		break;
+	}
+	case RendererCaptureCommand::BEGIN_FRAME:
+		m_renderer->BeginFrame();
+		m_transientVertexAllocations.clear();
+		break;
+	case RendererCaptureCommand::END_FRAME:
+		m_renderer->EndFrame();
+		break;
+	case RendererCaptureCommand::BEGIN_CAMERA: {
+		uint32_t id = reader.Read<uint32_t>();
+		if (id >= m_cameras.size()) {
+			m_cameras.resize( id + 1, nullptr );
+		}
+		if (!m_cameras[id]) {
+			m_cameras[id] = new CapturedCamera();
+		}
+		CapturedCamera* camera = m_cameras[id];
+		float values[16];
+		reader.ReadRaw( values, sizeof( values ) );
+		camera->m_projectionMatrix = Mat44( values );
+		reader.ReadRaw( values, sizeof( values ) );
+		camera->m_viewMatrix = Mat44( values );
+		uint32_t bufferCount = reader.Read<uint32_t>();
+		camera->m_cameraUniformBuffers.resize( bufferCount );
+		for (uint32_t i = 0; i < bufferCount; ++i) {
+			camera->m_cameraUniformBuffers[i] = (UniformBuffer*)GetObject( reader.Read<uint32_t>() );
+		}
+		m_renderer->BeginCamera( camera );
+		break;
+	}
+	case RendererCaptureCommand::END_CAMERA: {
+		uint32_t id = reader.Read<uint32_t>();
+		m_renderer->EndCamera( id < m_cameras.size() ? m_cameras[id] : nullptr );
+		break;
+	}
+	case RendererCaptureCommand::WRITE_DYNAMIC_VERTICES: {
+		uint32_t id = reader.Read<uint32_t>();
+		uint64_t capturedOffset = reader.Read<uint64_t>();
+		unsigned char const* vertices = reader.ReadBytes( size );
+		if (TransientVertexAllocation const* allocation = FindTransientVertices( id, capturedOffset )) {
+			uint64_t allocationSize = (uint64_t)allocation->m_binding.m_vertexBufferVertexCount * allocation->m_vertexSize;
+			memcpy( allocation->m_vertices, vertices, (size_t)(size < allocationSize ? size : allocationSize) );
+			break;
+		}
+		uint64_t offset = GetDynamicVertexOffset( id, capturedOffset );
+		VertexBuffer* buffer = (VertexBuffer*)GetObject( id );
+		if (buffer && buffer->m_mappedData) {
+			memcpy( (unsigned char*)buffer->m_mappedData + offset, vertices, (size_t)size );
+		}
+		break;
+	}
+	case RendererCaptureCommand::ALLOCATE_TRANSIENT_VERTICES: {
+		uint32_t id = reader.Read<uint32_t>();
+		uint64_t capturedOffset = reader.Read<uint64_t>();
+		uint32_t vertexCount = reader.Read<uint32_t>();
+		VertexFormat format = reader.Read<VertexFormat>();
+		m_transientVertexAllocations[{ id, capturedOffset }] = m_renderer->AllocateTransientVertices( vertexCount, format );
+		break;
+	}
+	case RendererCaptureCommand::DRAW:
+		m_renderer->Draw( ReadVertexBinding( reader ) );
+		break;
+	case RendererCaptureCommand::DRAW_QUADS:
+		m_renderer->DrawQuads( ReadVertexBinding( reader ) );
+		break;
+	case RendererCaptureCommand::DRAW_INDEXED: {
+		VertexBufferBinding vertexBinding = ReadVertexBinding( reader );
+		IndexBufferBinding indexBinding = ReadIndexBinding( reader );
+		m_renderer->DrawIndexed( vertexBinding, indexBinding );
+		break;
+	}
+	case RendererCaptureCommand::DRAW_SINGLE_BUFFER_INDEXED: {
+		VertexBuffer* vertexBuffer = (VertexBuffer*)GetObject( reader.Read<uint32_t>() );
+		IndexBuffer* indexBuffer = (IndexBuffer*)GetObject( reader.Read<uint32_t>() );
+		uint64_t vertexOffset = reader.Read<uint64_t>();
+		uint64_t indexOffset = reader.Read<uint64_t>();
+		m_renderer->DrawSingleBufferIndexed( vertexBuffer, indexBuffer, vertexOffset, indexOffset );
+		break;
+	}
+	case RendererCaptureCommand::BIND_SHADER:
+		m_renderer->BindShader( (Shader*)GetObject( reader.Read<uint32_t>() ) );
+		break;
+	case RendererCaptureCommand::BEGIN_DRAW_COMMANDS: {
+		UniformBufferBinding uniformBinding = ReadUniformBinding( reader );
+		TextureBinding textureBinding;
+		textureBinding.m_texture = (Texture*)GetObject( reader.Read<uint32_t>() );
+		m_renderer->BeginDrawCommands( uniformBinding, textureBinding );
+		break;
+	}
+	case RendererCaptureCommand::UPDATE_SHARED_MODEL_UNIFORM: {
+		UniformBufferBinding binding = ReadUniformBinding( reader );
+		unsigned char const* data = reader.ReadBytes( size );
+		m_renderer->UpdateSharedModelUniformBuffer( binding, (void*)data, (size_t)size );
+		break;
+	}
+	case RendererCaptureCommand::BEGIN_GPU_SECTION: {
+		std::string const& name = *m_gpuSectionNames.insert( reader.ReadString() ).first;
+		m_renderer->BeginGpuSection( name.c_str() );
+		break;
+	}
+	case RendererCaptureCommand::END_GPU_SECTION:
+		m_renderer->EndGpuSection();
+		break;
+	default:
+		// unknown commands of a newer writer are skipped by their size
+		break;
+	}
+}
+
+void RendererCaptureReplayer::SetObject( uint32_t id, void* object )
+{
+	if (id >= m_objects.size()) {
+		m_objects.resize( id + 1, nullptr );
+	}
+	m_objects[id] = object;
+}
+
+void* RendererCaptureReplayer::GetObject( uint32_t id ) const
+{
+	return id < m_objects.size() ? m_objects[id] : nullptr;
+}
+
+VertexBufferBinding RendererCaptureReplayer::ReadVertexBinding( RendererCaptureReader& reader ) const
+{
+	VertexBufferBinding binding;
+	uint32_t id = reader.Read<uint32_t>();
+	binding.m_vertexBuffer = (VertexBuffer*)GetObject( id );
+	binding.m_vertexBufferOffset = reader.Read<uint64_t>();
+	binding.m_vertexBufferVertexCount = reader.Read<uint32_t>();
+	if (TransientVertexAllocation const* allocation = FindTransientVertices( id, binding.m_vertexBufferOffset )) {
+		binding.m_vertexBuffer = allocation->m_binding.m_vertexBuffer;
+		binding.m_vertexBufferOffset = allocation->m_binding.m_vertexBufferOffset;
+	}
+	else if (id != 0 && id == m_sharedVertexBufferId) {
+		auto iter = m_sharedVertexOffsets.find( binding.m_vertexBufferOffset );
+		if (iter != m_sharedVertexOffsets.end()) {
+			binding.m_vertexBufferOffset = iter->second;
+		}
+	}
+	else {
+		binding.m_vertexBufferOffset = GetDynamicVertexOffset( id, binding.m_vertexBufferOffset );
+	}
+	return binding;
+}
+
+IndexBufferBinding RendererCaptureReplayer::ReadIndexBinding( RendererCaptureReader& reader ) const
+{
+	IndexBufferBinding binding;
+	uint32_t id = reader.Read<uint32_t>();
+	binding.m_indexBuffer = (IndexBuffer*)GetObject( id );
+	binding.m_indexBufferOffset = reader.Read<uint64_t>();
+	binding.m_indexBufferIndexCount = reader.Read<uint32_t>();
+	if (id != 0 && id == m_sharedIndexBufferId) {
+		auto iter = m_sharedIndexOffsets.find( binding.m_indexBufferOffset );
+		if (iter != m_sharedIndexOffsets.end()) {
+			binding.m_indexBufferOffset = iter->second;
+		}
+	}
+	return binding;
+}
+
+UniformBufferBinding RendererCaptureReplayer::ReadUniformBinding( RendererCaptureReader& reader ) const
+{
+	UniformBufferBinding binding;
+	binding.m_flags = reader.Read<uint32_t>();
+	binding.m_modelUniformBufferOffset = reader.Read<uint64_t>();
+	auto iter = m_sharedUniformOffsets.find( binding.m_modelUniformBufferOffset );
+	if (iter != m_sharedUniformOffsets.end()) {
+		binding.m_modelUniformBufferOffset = iter->second;
+	}
+	return binding;
+}
+
+TransientVertexAllocation const* RendererCaptureReplayer::FindTransientVertices( uint32_t id, uint64_t capturedOffset ) const
+{
+	auto iter = m_transientVertexAllocations.find( { id, capturedOffset } );
+	return iter != m_transientVertexAllocations.end() ? &iter->second : nullptr;
+}
+
+uint64_t RendererCaptureReplayer::GetDynamicVertexOffset( uint32_t id, uint64_t capturedOffset ) const
+{
+	auto iter = m_dynamicVertexBufferSlices.find( id );
+	if (iter == m_dynamicVertexBufferSlices.end() || iter->second == 0) {
+		return capturedOffset;
+	}
+	// the captured frame wrote its own slice, use the slice of the frame the replay renderer is recording
+	return capturedOffset % iter->second + (uint64_t)m_renderer->GetCurFrameNumber() * iter->second;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "Graphics/GraphicsCommon.h"
+#include "Graphics/RendererCaptureFormat.h"
+
+class RendererInterface;
+struct CapturedCamera;
+
+/// Re-executes a capture written by CaptureRenderer against any renderer, no game code involved
+/// Offsets into the shared buffers are remapped since the replay renderer may place the data elsewhere,
+/// dynamic vertex buffer offsets are moved to the slice of the replay frame (the buffers are MAX_FRAMES_IN_FLIGHT slices)
+/// and transient vertices are allocated again from the transient ring of the replay renderer
+class RendererCaptureReplayer {
+public:
+	RendererCaptureReplayer( RendererInterface* renderer );
+	~RendererCaptureReplayer();
+	RendererCaptureReplayer( RendererCaptureReplayer const& replayer ) = delete;
+
+	/// read the capture and create the resources made before the first captured frame
+	void Load( std::string const& path );
+	/// replay the next captured frame with the resource calls made before it, false once every frame was replayed
+	bool ReplayNextFrame();
+	uint32_t GetFrameCount() const;
+	uint32_t GetReplayedFrameCount() const;
+
+protected:
+	void ExecuteCommand( RendererCaptureCommand command, RendererCaptureReader& reader );
+	void SetObject( uint32_t id, void* object );
+	void* GetObject( uint32_t id ) const;
+	VertexBufferBinding ReadVertexBinding( RendererCaptureReader& reader ) const;
+	IndexBufferBinding ReadIndexBinding( RendererCaptureReader& reader ) const;
+	UniformBufferBinding ReadUniformBinding( RendererCaptureReader& reader ) const;
+	uint64_t GetDynamicVertexOffset( uint32_t id, uint64_t capturedOffset ) const;
+	/// the replay allocation made for a captured transient allocation of the current frame, nullptr if there is none
+	TransientVertexAllocation const* FindTransientVertices( uint32_t id, uint64_t capturedOffset ) const;
+
+	RendererInterface* m_renderer = nullptr;
+	std::vector<unsigned char> m_data;
+	size_t m_pos = 0;
+	uint32_t m_frameCount = 0;
+	uint32_t m_replayedFrameCount = 0;
+	std::vector<void*> m_objects;
+	std::vector<CapturedCamera*> m_cameras;
+	uint32_t m_sharedVertexBufferId = 0;
+	uint32_t m_sharedIndexBufferId = 0;
+	/// captured offset to replay offset
+	std::unordered_map<uint64_t, uint64_t> m_sharedVertexOffsets;
+	std::unordered_map<uint64_t, uint64_t> m_sharedIndexOffsets;
+	std::unordered_map<uint64_t, uint64_t> m_sharedUniformOffsets;
+	/// slice size of every dynamic vertex buffer by id
+	std::unordered_map<uint32_t, uint64_t> m_dynamicVertexBufferSlices;
+	/// captured ring id and offset to the replay allocation, cleared every frame
+	std::map<std::pair<uint32_t, uint64_t>, TransientVertexAllocation> m_transientVertexAllocations;
+	/// GPU section names must outlive the frame, the nodes of the set never move
+	std::unordered_set<std::string> m_gpuSectionNames;
+};
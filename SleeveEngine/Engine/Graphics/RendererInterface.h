@@ -0,0 +1,104 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Graphics/GraphicsCommon.h"
+#include "Graphics/Vertex.h"
+#include "Graphics/RendererStatistics.h"
+
+struct Camera;
+class Shader;
+struct ShaderSource;
+
+/// headless: no window, surface or swapchain, frames are rendered into offscreen images with the same render pass
+struct RendererConfig {
+	bool m_headless = false;
+	uint32_t m_offscreenWidth = WINDOW_WIDTH;
+	uint32_t m_offscreenHeight = WINDOW_HEIGHT;
+	/// (headless only) copy every frame back to host memory, see ReadLastFrame
+	bool m_readbackFrames = false;
+	/// timestamp queries around the render pass, the transfer copies and user GPU sections
+	bool m_gpuTimestamps = true;
+	/// pipeline statistics of the render pass, only if the device supports the query
+	bool m_gpuPipelineStatistics = false;
+};
+
+/// Everything the game and the entities call on g_theRenderer, implemented by the Vulkan Renderer and the NullRenderer
+class RendererInterface {
+public:
+	virtual ~RendererInterface() = default;
+
+	virtual void Initialize( RendererConfig const& config = RendererConfig() ) = 0;
+	virtual void Cleanup() = 0;
+	virtual void WaitForCleanup() = 0;
+	virtual void BeginFrame() = 0;
+	virtual void EndFrame() = 0;
+
+	virtual void BeginCamera( Camera const* camera ) = 0;
+	virtual void EndCamera( Camera const* camera ) = 0;
+
+	virtual float GetSwapChainExtentRatio() const = 0;
+
+	virtual void DrawSingleBufferIndexed( VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, uint64_t vertexOffset = 0, uint64_t indexOffset = 0 ) = 0;
+	virtual void Draw( VertexBufferBinding const& vertexBinding ) = 0;
+	virtual void DrawIndexed( VertexBufferBinding const& vertexBinding, IndexBufferBinding const& indexBinding ) = 0;
+	/// the vertices are quads of QUAD_VERTEX_COUNT, indexed with the renderer's shared quad index buffer
+	virtual void DrawQuads( VertexBufferBinding const& vertexBinding ) = 0;
+
+	virtual void BindShader( Shader* shader ) = 0;
+	virtual void BeginDrawCommands( UniformBufferBinding const& uniformBufferBinding, TextureBinding const& textureBinding ) = 0;
+
+	virtual void UpdateUniformBuffer( UniformBuffer* uniformBuffer, void* newData, size_t dataSize ) = 0;
+	virtual void UpdateSharedModelUniformBuffer( UniformBufferBinding const& binding, void* newData, size_t dataSize ) = 0;
+	/// index of the frame in flight being recorded, from 0 to MAX_FRAMES_IN_FLIGHT - 1
+	virtual uint32_t GetCurFrameNumber() const = 0;
+	/// changes when model uniforms written in earlier frames can no longer be relied on, like when a capture starts recording
+	/// code that skips rewriting unchanged model uniforms has to write them all again once it changes
+	virtual uint32_t GetSharedUniformGeneration() const = 0;
+
+	virtual Texture* CreateTextureFromFile( std::string const& fileName ) = 0;
+	virtual Texture* CreateTextureFromBuffer( unsigned char const* buffer, uint64_t size, uint32_t width, uint32_t height ) = 0;
+	virtual Texture* CreateWhiteTexture() = 0;
+	/// overwrite a rectangle of a texture with tightly packed RGBA8 rows, the pixels are copied at once
+	/// the copy is recorded at the next BeginFrame before the render pass, after the frames in flight finished reading the texture
+	virtual void UpdateTextureRegion( Texture* texture, uint32_t x, uint32_t y, uint32_t width, uint32_t height, unsigned char const* pixels ) = 0;
+	virtual IndexBuffer* CreateIndexBuffer( void* indexData, uint64_t size, uint32_t indexCount ) = 0;
+	virtual VertexBuffer* CreateVertexBuffer( void* vertexData, uint64_t size, uint32_t vertexCount ) = 0;
+	virtual UniformBuffer* CreateUniformBuffer( uint64_t size ) = 0;
+	virtual Shader* CreateShader( std::string const& fileName ) = 0;
+	virtual Shader* CreateShader( ShaderSource const& source ) = 0;
+
+	virtual VertexBufferBinding AddVertsDataToSharedVertexBuffer( void* vertexData, uint64_t size, uint32_t vertexCount ) = 0;
+	virtual IndexBufferBinding AddIndicesDataToSharedIndexBuffer( void* indexData, uint64_t size, uint32_t indexCount ) = 0;
+	virtual UniformBufferBinding AddDataToSharedUniformBuffer( UniformBufferDataBindingFlags flags ) = 0;
+	virtual void ReturnMemoryToSharedBuffer( VertexBufferBinding const& vBinding, IndexBufferBinding const& iBinding, UniformBufferBinding const& uBinding ) = 0;
+	virtual void ReturnMemoryToSharedBuffer( VertexBufferBinding const& vBinding ) = 0;
+	virtual void ReturnMemoryToSharedBuffer( UniformBufferBinding const& uBinding ) = 0;
+	virtual void ReturnMemoryToSharedBuffer( IndexBufferBinding const& iBinding ) = 0;
+
+	/// host visible vertex buffer, write to VertexBuffer::m_mappedData directly
+	virtual VertexBuffer* CreateDynamicVertexBuffer( uint64_t size ) = 0;
+	/// vertices for this frame only from a ring per frame in flight, no buffer to own and no fixed cap
+	/// the ring is reused once the frame's fence signaled, so the binding must not be drawn in a later frame
+	/// draw the binding with a shader reading the same vertex format
+	virtual TransientVertexAllocation AllocateTransientVertices( uint32_t vertexCount, VertexFormat format = VertexFormat::PCU3D ) = 0;
+
+	virtual void DeferredDestroyBuffer( UniformBuffer* buffer, bool isTransfer ) = 0;
+	virtual void DeferredDestroyBuffer( VertexBuffer* buffer, bool isTransfer ) = 0;
+	virtual void DeferredDestroyBuffer( IndexBuffer* buffer, bool isTransfer ) = 0;
+
+	/// named GPU timestamp section on the frame's command buffer, sections can nest and names must be static strings
+	virtual void BeginGpuSection( char const* name ) = 0;
+	virtual void EndGpuSection() = 0;
+	/// GPU timings of the newest frame whose queries finished, usually the frame MAX_FRAMES_IN_FLIGHT frames ago
+	virtual GpuFrameTimings const& GetLastGpuFrameTimings() const = 0;
+	/// draws, descriptor writes and uploads of the last finished frame
+	virtual RendererFrameStatistics const& GetLastFrameStatistics() const = 0;
+	/// statistics of the last RENDERER_STATISTICS_HISTORY_FRAMES frames for rolling averages
+	virtual RendererStatisticsHistory const& GetFrameStatisticsHistory() const = 0;
+
+	virtual bool IsHeadless() const = 0;
+	/// (headless only) get the pixels of the last frame the GPU finished, tightly packed RGBA8 rows from top to bottom
+	virtual bool ReadLastFrame( std::vector<unsigned char>& out_pixels, uint32_t& out_width, uint32_t& out_height ) const = 0;
+};
@@ -0,0 +1,69 @@
+#include "Graphics/RendererStatistics.h"
+
+SharedBufferOccupancy GetSharedBufferOccupancy( std::vector<BufferMemoryBlock> const& freeBlocks, uint64_t size )
+{
+	SharedBufferOccupancy occupancy;
+	occupancy.m_size = size;
+	uint64_t freeBytes = 0;
+	for (auto const& block : freeBlocks) {
+		freeBytes += block.m_size;
+		if (block.m_size > occupancy.m_largestFreeBlock) {
+			occupancy.m_largestFreeBlock = block.m_size;
+		}
+	}
+	occupancy.m_freeBlockCount = freeBlocks.size();
+	occupancy.m_usedBytes = freeBytes < size ? size - freeBytes : 0;
+	return occupancy;
+}
+
+float GetSharedBufferFragmentation( SharedBufferOccupancy const& occupancy )
+{
+	uint64_t freeBytes = occupancy.m_size - occupancy.m_usedBytes;
+	if (freeBytes == 0) {
+		return 0.f;
+	}
+	return 1.f - (float)((double)occupancy.m_largestFreeBlock / (double)freeBytes);
+}
+
+void RendererStatisticsHistory::AddFrame( RendererFrameStatistics const& statistics )
+{
+	m_frames[m_nextIndex] = statistics;
+	m_nextIndex = (m_nextIndex + 1) % RENDERER_STATISTICS_HISTORY_FRAMES;
+	if (m_frameCount < RENDERER_STATISTICS_HISTORY_FRAMES) {
+		++m_frameCount;
+	}
+}
+
+RendererFrameStatistics const& RendererStatisticsHistory::GetLast() const
+{
+	return m_frames[(m_nextIndex + RENDERER_STATISTICS_HISTORY_FRAMES - 1) % RENDERER_STATISTICS_HISTORY_FRAMES];
+}
+
+uint32_t RendererStatisticsHistory::GetFrameCount() const
+{
+	return m_frameCount;
+}
+
+double RendererStatisticsHistory::GetAverage( uint64_t RendererFrameStatistics::* counter ) const
+{
+	if (m_frameCount == 0) {
+		return 0.0;
+	}
+	// frames not written yet are zero, so the whole ring can be summed
+	uint64_t sum = 0;
+	for (auto const& frame : m_frames) {
+		sum += frame.*counter;
+	}
+	return (double)sum / (double)m_frameCount;
+}
+
+uint64_t RendererStatisticsHistory::GetMax( uint64_t RendererFrameStatistics::* counter ) const
+{
+	uint64_t maxValue = 0;
+	for (auto const& frame : m_frames) {
+		if (frame.*counter > maxValue) {
+			maxValue = frame.*counter;
+		}
+	}
+	return maxValue;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <array>
+#include "Graphics/GraphicsCommon.h"
+
+constexpr uint32_t RENDERER_STATISTICS_HISTORY_FRAMES = 120; // around two seconds at 60 fps
+
+/// Occupancy of a first fit buffer from its sorted list of free blocks
+SharedBufferOccupancy GetSharedBufferOccupancy( std::vector<BufferMemoryBlock> const& freeBlocks, uint64_t size );
+/// 0 if all free bytes are in one block, close to 1 if the largest free block is only a small part of them
+float GetSharedBufferFragmentation( SharedBufferOccupancy const& occupancy );
+
+/// Ring of the statistics of the last finished frames, the renderers add every frame in EndFrame
+class RendererStatisticsHistory {
+public:
+	void AddFrame( RendererFrameStatistics const& statistics );
+
+	/// statistics of the last finished frame, all zero before the first frame
+	RendererFrameStatistics const& GetLast() const;
+	uint32_t GetFrameCount() const;
+	/// rolling average and maximum of one counter over the frames in the history, e.g. GetAverage( &RendererFrameStatistics::m_draws )
+	double GetAverage( uint64_t RendererFrameStatistics::* counter ) const;
+	uint64_t GetMax( uint64_t RendererFrameStatistics::* counter ) const;
+
+protected:
+	std::array<RendererFrameStatistics, RENDERER_STATISTICS_HISTORY_FRAMES> m_frames = {};
+	uint32_t m_nextIndex = 0;
+	uint32_t m_frameCount = 0;
+};
@@ -0,0 +1,170 @@
+#include "Graphics/RendererStatisticsOverlay.h"
+#include "Graphics/GraphicsFwd.h"
+#include "Graphics/Font.h"
+#include "Core/ResourceManager.h"
+#include "Core/AllocationTracker.h"
+#include "Core/Clock.h"
+#include "Core/HitchDetector.h"
+
+#include <cstdio>
+#include <cstring>
+
+/// formats into the caller's buffer and returns it, so a line costs no heap allocation
+static char const* FormatBytes( double bytes, char* buffer, size_t bufferSize )
+{
+	if (bytes >= 1024.0 * 1024.0) {
+		snprintf( buffer, bufferSize, "%.2f MB", bytes / (1024.0 * 1024.0) );
+	}
+	else if (bytes >= 1024.0) {
+		snprintf( buffer, bufferSize, "%.1f KB", bytes / 1024.0 );
+	}
+	else {
+		snprintf( buffer, bufferSize, "%.0f B", bytes );
+	}
+	return buffer;
+}
+
+static char const* FormatOccupancy( char const* name, SharedBufferOccupancy const& occupancy, char* buffer, size_t bufferSize )
+{
+	char usedBytes[32];
+	char size[32];
+	snprintf( buffer, bufferSize, "%-16s %s / %s  free blocks %llu  fragmentation %.0f%%", name,
+		FormatBytes( (double)occupancy.m_usedBytes, usedBytes, sizeof( usedBytes ) ), FormatBytes( (double)occupancy.m_size, size, sizeof( size ) ),
+		occupancy.m_freeBlockCount, GetSharedBufferFragmentation( occupancy ) * 100.f );
+	return buffer;
+}
+
+RendererStatisticsOverlay::RendererStatisticsOverlay( Font* font, AABB2 const& screenBounds )
+	:m_font( font ), m_screenBounds( screenBounds )
+{
+	m_uniformBufferBinding = g_theRenderer->AddDataToSharedUniformBuffer( UNIFORM_BUFFER_USE_MODEL_CONSTANTS_BINDING_2 );
+	m_fontTextureBinding.m_texture = m_font->GetTexture();
+	m_shader = g_theResourceManager->GetOrLoadShader( m_font->GetShaderName( VertexFormat::PCU2D ) );
+	m_modelMatrix = Mat44( Vec3( 1.f, 0.f, 0.f ), Vec3( 0.f, 1.f, 0.f ), Vec3( 0.f, 0.f, 1.f ), Vec3( 0.f, 0.f, 0.f ) );
+}
+
+RendererStatisticsOverlay::~RendererStatisticsOverlay()
+{
+	g_theRenderer->ReturnMemoryToSharedBuffer( m_uniformBufferBinding );
+}
+
+void RendererStatisticsOverlay::Update( float deltaSeconds )
+{
+	// frame times are recorded while hidden so the averages are ready when it is shown
+	m_frameSeconds[m_nextFrameIndex] = deltaSeconds;
+	m_nextFrameIndex = (m_nextFrameIndex + 1) % RENDERER_STATISTICS_HISTORY_FRAMES;
+	if (m_frameCount < RENDERER_STATISTICS_HISTORY_FRAMES) {
+		++m_frameCount;
+	}
+	if (!m_isVisible) {
+		return;
+	}
+	ALLOCATION_TAG_SCOPE( "RendererStatisticsOverlay" );
+
+	RendererStatisticsHistory const& history = g_theRenderer->GetFrameStatisticsHistory();
+	RendererFrameStatistics const& last = history.GetLast();
+	m_textVerts.clear();
+	m_nextLineY = m_screenBounds.m_maxs.y - m_textSize * 1.5f;
+	char line[160];
+
+	float frameSecondsSum = 0.f;
+	float frameSecondsMax = 0.f;
+	for (uint32_t i = 0; i < m_frameCount; ++i) {
+		frameSecondsSum += m_frameSeconds[i];
+		frameSecondsMax = m_frameSeconds[i] > frameSecondsMax ? m_frameSeconds[i] : frameSecondsMax;
+	}
+	float frameSecondsAverage = m_frameCount > 0 ? frameSecondsSum / m_frameCount : 0.f;
+	snprintf( line, sizeof( line ), "frame %.2f ms  avg %.2f ms (%.0f fps)  max %.2f ms  over %u frames", deltaSeconds * 1000.f,
+		frameSecondsAverage * 1000.f, frameSecondsAverage > 0.f ? 1.f / frameSecondsAverage : 0.f, frameSecondsMax * 1000.f, history.GetFrameCount() );
+	AddLine( line, Rgba8( 255, 255, 255 ) );
+
+	HitchDetector const& hitchDetector = Clock::GetSystemHitchDetector();
+	FrameTimePercentiles const& window = hitchDetector.GetLastWindow();
+	snprintf( line, sizeof( line ), "real frame p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms  %llu hitches", window.m_p50Milliseconds,
+		window.m_p95Milliseconds, window.m_p99Milliseconds, window.m_maxMilliseconds, hitchDetector.GetHitchCount() );
+	AddLine( line, Rgba8( 255, 255, 255 ) );
+
+	AllocationFrameStatistics const& allocations = AllocationTracker::GetLastFrame();
+	char bytes[3][32];
+	snprintf( line, sizeof( line ), "heap %llu allocations  %s  %llu frees", allocations.m_allocations,
+		FormatBytes( (double)allocations.m_bytes, bytes[0], sizeof( bytes[0] ) ), allocations.m_frees );
+	AddLine( line, Rgba8( 255, 128, 255 ) );
+
+	auto addCounter = [&]( char const* name, uint64_t RendererFrameStatistics::* counter ) {
+		snprintf( line, sizeof( line ), "%-16s %8llu  avg %10.1f  max %8llu", name, last.*counter, history.GetAverage( counter ), history.GetMax( counter ) );
+		AddLine( line, Rgba8( 255, 255, 0 ) );
+	};
+	auto addBytes = [&]( char const* name, uint64_t RendererFrameStatistics::* counter ) {
+		snprintf( line, sizeof( line ), "%-16s %10s  avg %10s  max %10s", name, FormatBytes( (double)(last.*counter), bytes[0], sizeof( bytes[0] ) ),
+			FormatBytes( history.GetAverage( counter ), bytes[1], sizeof( bytes[1] ) ), FormatBytes( (double)history.GetMax( counter ), bytes[2], sizeof( bytes[2] ) ) );
+		AddLine( line, Rgba8( 255, 255, 0 ) );
+	};
+	addCounter( "draws", &RendererFrameStatistics::m_draws );
+	addCounter( "instanced draws", &RendererFrameStatistics::m_instancedDraws );
+	addCounter( "pipeline binds", &RendererFrameStatistics::m_pipelineBinds );
+	addCounter( "sets allocated", &RendererFrameStatistics::m_descriptorSetsAllocated );
+	addCounter( "sets written", &RendererFrameStatistics::m_descriptorSetWrites );
+	addBytes( "vertex drawn", &RendererFrameStatistics::m_vertexBytesDrawn );
+	addBytes( "index drawn", &RendererFrameStatistics::m_indexBytesDrawn );
+	addBytes( "vertex upload", &RendererFrameStatistics::m_vertexUploadBytes );
+	addBytes( "index upload", &RendererFrameStatistics::m_indexUploadBytes );
+	addBytes( "uniform upload", &RendererFrameStatistics::m_uniformUploadBytes );
+	addBytes( "texture upload", &RendererFrameStatistics::m_textureUploadBytes );
+	addBytes( "transient verts", &RendererFrameStatistics::m_transientVertexBytes );
+	addBytes( "staging used", &RendererFrameStatistics::m_stagingBytesUsed );
+	addCounter( "copy commands", &RendererFrameStatistics::m_copyCommands );
+	addCounter( "pending deletes", &RendererFrameStatistics::m_pendingDeletions );
+
+	AddLine( FormatOccupancy( "vertex buffer", last.m_sharedVertexBuffer, line, sizeof( line ) ), Rgba8( 0, 255, 255 ) );
+	AddLine( FormatOccupancy( "index buffer", last.m_sharedIndexBuffer, line, sizeof( line ) ), Rgba8( 0, 255, 255 ) );
+	AddLine( FormatOccupancy( "uniform buffer", last.m_sharedUniformBuffer, line, sizeof( line ) ), Rgba8( 0, 255, 255 ) );
+
+	// top level GPU sections only, nested ones are in the profiler trace
+	for (auto const& section : g_theRenderer->GetLastGpuFrameTimings().m_sections) {
+		if (section.m_depth == 0) {
+			snprintf( line, sizeof( line ), "gpu %-12s %8.3f ms", section.m_name, section.m_durationMilliseconds );
+			AddLine( line, Rgba8( 0, 255, 0 ) );
+		}
+	}
+
+	// the lines change every frame, so they go straight into this frame's transient vertices
+	// screen space text has no use for z, the compact vertices cut the bytes the GPU reads by a third
+	TransientVertexAllocation allocation = g_theRenderer->AllocateTransientVertices( (uint32_t)m_textVerts.size(), VertexFormat::PCU2D );
+	ConvertVertices( m_textVerts.data(), m_textVerts.size(), (VertexPCU2D*)allocation.m_vertices );
+	m_textVertexBufferBinding = allocation.m_binding;
+}
+
+void RendererStatisticsOverlay::Render() const
+{
+	if (!m_isVisible || m_textVertexBufferBinding.m_vertexBufferVertexCount == 0) {
+		return;
+	}
+	g_theRenderer->BindShader( m_shader );
+	g_theRenderer->BeginDrawCommands( m_uniformBufferBinding, m_fontTextureBinding );
+	g_theRenderer->UpdateSharedModelUniformBuffer( m_uniformBufferBinding, (void*)&m_modelMatrix, sizeof( m_modelMatrix ) );
+	g_theRenderer->DrawQuads( m_textVertexBufferBinding );
+}
+
+void RendererStatisticsOverlay::SetVisible( bool isVisible )
+{
+	m_isVisible = isVisible;
+	if (!m_isVisible) {
+		m_textVertexBufferBinding.m_vertexBufferVertexCount = 0;
+	}
+}
+
+void RendererStatisticsOverlay::ToggleVisible()
+{
+	SetVisible( !m_isVisible );
+}
+
+bool RendererStatisticsOverlay::IsVisible() const
+{
+	return m_isVisible;
+}
+
+void RendererStatisticsOverlay::AddLine( std::string_view line, Rgba8 const& color )
+{
+	m_font->AddVertsForText2D( m_textVerts, line, Vec2( m_screenBounds.m_mins.x + m_textSize * 0.5f, m_nextLineY ), color, m_textSize );
+	m_nextLineY -= m_textSize * 1.2f;
+}
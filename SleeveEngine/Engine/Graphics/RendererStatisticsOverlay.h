@@ -0,0 +1,45 @@
+#pragma once
+#include <array>
+#include <string_view>
+#include <vector>
+#include "Graphics/RendererStatistics.h"
+#include "Graphics/Vertex.h"
+
+class Font;
+class Shader;
+
+/// Text panel with the renderer statistics of the last frame and their rolling averages
+/// Render it between BeginCamera and EndCamera of an orthographic camera whose bounds are the given screen bounds
+/// Its own draw is counted in the statistics it shows
+class RendererStatisticsOverlay {
+public:
+	RendererStatisticsOverlay( Font* font, AABB2 const& screenBounds );
+	~RendererStatisticsOverlay();
+
+	void Update( float deltaSeconds );
+	void Render() const;
+
+	void SetVisible( bool isVisible );
+	void ToggleVisible();
+	bool IsVisible() const;
+
+protected:
+	void AddLine( std::string_view line, Rgba8 const& color );
+
+	Font* m_font = nullptr;
+	Shader* m_shader = nullptr;
+	AABB2 m_screenBounds;
+	bool m_isVisible = false;
+	float m_textSize = 14.f;
+	float m_nextLineY = 0.f;
+
+	std::array<float, RENDERER_STATISTICS_HISTORY_FRAMES> m_frameSeconds = {};
+	uint32_t m_nextFrameIndex = 0;
+	uint32_t m_frameCount = 0;
+
+	std::vector<VertexPCU3D> m_textVerts;
+	VertexBufferBinding m_textVertexBufferBinding;
+	UniformBufferBinding m_uniformBufferBinding;
+	TextureBinding m_fontTextureBinding;
+	Mat44 m_modelMatrix;
+};
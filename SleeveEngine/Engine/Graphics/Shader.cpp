@@ -15,7 +15,7 @@ void Shader::UpdateDescriptorSets( UniformBufferBinding const& uniformBufferBind
 	VkDescriptorSet set = m_pools->AcquireDescriptorSet( m_descriptorSetLayout );
 
 	VkDescriptorBufferInfo vpBufferInfo{};
-	vpBufferInfo.buffer = g_theRenderer->m_currentCamera->m_cameraUniformBuffers[m_renderer->GetCurFrameNumber()]->m_buffer;
+	vpBufferInfo.buffer = m_renderer->m_currentCamera->m_cameraUniformBuffers[m_renderer->GetCurFrameNumber()]->m_buffer;
 	vpBufferInfo.offset = 0;
 	vpBufferInfo.range = sizeof( CameraUniformBufferObject );
 
@@ -58,22 +58,44 @@ void Shader::UpdateDescriptorSets( UniformBufferBinding const& uniformBufferBind
 	// update the set
 	vkUpdateDescriptorSets( m_device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr );
 	// bind the set
-	vkCmdBindDescriptorSets( g_theRenderer->m_commandBuffers[g_theRenderer->m_currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1, &set, 0, nullptr );
+	vkCmdBindDescriptorSets( m_renderer->m_commandBuffers[m_renderer->m_currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1, &set, 0, nullptr );
 }
 
 Shader::~Shader()
 {
-	vkDestroyDescriptorSetLayout( m_device, m_descriptorSetLayout, nullptr );
-	vkDestroyPipeline( m_device, m_graphicsPipeline, nullptr );
-	vkDestroyPipelineLayout( m_device, m_pipelineLayout, nullptr );
+	if (m_device) {
+		vkDestroyDescriptorSetLayout( m_device, m_descriptorSetLayout, nullptr );
+		vkDestroyPipeline( m_device, m_graphicsPipeline, nullptr );
+		vkDestroyPipelineLayout( m_device, m_pipelineLayout, nullptr );
+	}
+}
+
+VertexFormat Shader::GetVertexFormat() const
+{
+	return m_vertexFormat;
+}
+
+ShaderSource Shader::ReadShaderSource( std::string const& shaderName )
+{
+	ShaderSource source;
+	source.m_name = shaderName;
+	source.m_vertexCode = ReadFile( std::format( "Data/Shaders/{}_vert.spv", shaderName ) );
+	source.m_fragmentCode = ReadFile( std::format( "Data/Shaders/{}_frag.spv", shaderName ) );
+	return source;
 }
 
 void Shader::LoadShader( std::string const& fileName )
 {
-	m_name = fileName;
+	LoadShader( ReadShaderSource( fileName ) );
+}
+
+void Shader::LoadShader( ShaderSource const& source )
+{
+	m_name = source.m_name;
+	m_vertexFormat = GetShaderVertexFormat( m_name );
 	CreateDescriptorSetLayout();
-	CreateGraphicsPipeline();
-	m_pools = g_theRenderer->GetOrCreateDescriptorPools( 2, 1 );
+	CreateGraphicsPipeline( source );
+	m_pools = m_renderer->GetOrCreateDescriptorPools( 2, 1 );
 }
 
 void Shader::CreateDescriptorSetLayout()
@@ -111,46 +133,10 @@ void Shader::CreateDescriptorSetLayout()
 }
 
 
-/// (Vulkan) get binding description of the vertex buffer
-static VkVertexInputBindingDescription GetBindingDescriptionVertexPCU3D() 
-{
-	VkVertexInputBindingDescription bindingDescription{};
-	bindingDescription.binding = 0;
-	bindingDescription.stride = sizeof( VertexPCU3D );
-	bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
-	return bindingDescription;
-}
-
-/// (Vulkan) get attribute description of the vertex in the shader
-static std::array<VkVertexInputAttributeDescription, 3> GetAttributeDescriptionsVertexPCU3D() 
-{
-	std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions{};
-
-	attributeDescriptions[0].binding = 0;
-	attributeDescriptions[0].location = 0;
-	attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
-	attributeDescriptions[0].offset = offsetof( VertexPCU3D, m_position );
-
-	attributeDescriptions[1].binding = 0;
-	attributeDescriptions[1].location = 1;
-	attributeDescriptions[1].format = VK_FORMAT_R8G8B8A8_UNORM;
-	attributeDescriptions[1].offset = offsetof( VertexPCU3D, m_color );
-
-	attributeDescriptions[2].binding = 0;
-	attributeDescriptions[2].location = 2;
-	attributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
-	attributeDescriptions[2].offset = offsetof( VertexPCU3D, m_uvCoord );
-
-	return attributeDescriptions;
-}
-
-void Shader::CreateGraphicsPipeline()
+void Shader::CreateGraphicsPipeline( ShaderSource const& source )
 {
-	auto vertShaderCode = ReadFile( std::format("Data/Shaders/{}_vert.spv", m_name) );
-	auto fragShaderCode = ReadFile( std::format("Data/Shaders/{}_frag.spv", m_name) );
-	VkShaderModule vertShaderModule = CreateShaderModule( vertShaderCode );
-	VkShaderModule fragShaderModule = CreateShaderModule( fragShaderCode );
+	VkShaderModule vertShaderModule = CreateShaderModule( source.m_vertexCode );
+	VkShaderModule fragShaderModule = CreateShaderModule( source.m_fragmentCode );
 
 	VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
 	vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -166,15 +152,15 @@ void Shader::CreateGraphicsPipeline()
 
 	VkPipelineShaderStageCreateInfo shaderStages[] = { vertShaderStageInfo, fragShaderStageInfo };
 
-	auto bindingDescription = GetBindingDescriptionVertexPCU3D();
-	auto attributeDescriptions = GetAttributeDescriptionsVertexPCU3D();
+	// generated at compile time from the vertex struct, see VertexLayoutOf
+	VertexLayout const& vertexLayout = GetVertexLayout( m_vertexFormat );
 
 	VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
 	vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
 	vertexInputInfo.vertexBindingDescriptionCount = 1;
-	vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-	vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-	vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+	vertexInputInfo.vertexAttributeDescriptionCount = vertexLayout.m_attributeCount;
+	vertexInputInfo.pVertexBindingDescriptions = &vertexLayout.m_binding;
+	vertexInputInfo.pVertexAttributeDescriptions = vertexLayout.m_attributes.data();
 
 	VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
 	inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
@@ -8,12 +8,24 @@ class DescriptorPools;
 struct Legacy_EntityUniformBuffers;
 struct UniformBufferBinding;
 
+/// SPIR-V code of a shader, can be read from disk on any thread before the device exists
+struct ShaderSource {
+	std::string m_name;
+	std::vector<char> m_vertexCode;
+	std::vector<char> m_fragmentCode;
+};
+
 class Shader {
 public:
 	void UpdateDescriptorSets( UniformBufferBinding const& uniformBufferBinding, TextureBinding const& textureBinding );
+	/// the vertex struct the pipeline reads, shaders are picked per format by name, see GetShaderVertexFormat
+	VertexFormat GetVertexFormat() const;
+
+	static ShaderSource ReadShaderSource( std::string const& shaderName );
 
 protected:
 	friend class Renderer;
+	friend class NullRenderer;
 	friend class ResourceManager;
 
 	Shader( VkDevice device, Renderer* renderer ) : m_device( device ), m_renderer(renderer) {};
@@ -21,15 +33,18 @@ protected:
 
 	void LoadShader( std::string const& fileName );
 
+	void LoadShader( ShaderSource const& source );
+
 	void CreateDescriptorSetLayout();
 
-	void CreateGraphicsPipeline();
+	void CreateGraphicsPipeline( ShaderSource const& source );
 
 	static std::vector<char> ReadFile( const std::string& filename );
 
 	VkShaderModule CreateShaderModule( const std::vector<char>& code );
 
 	std::string m_name;
+	VertexFormat m_vertexFormat = VertexFormat::PCU3D;
 	VkDevice m_device;
 	Renderer* m_renderer;
 	VkDescriptorSetLayout m_descriptorSetLayout;
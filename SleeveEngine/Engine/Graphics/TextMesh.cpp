@@ -0,0 +1,122 @@
+#include "Graphics/TextMesh.h"
+#include "Graphics/GraphicsFwd.h"
+
+#include <algorithm>
+#include <cstring>
+
+static_assert(MAX_FRAMES_IN_FLIGHT <= 32, "TextMesh keeps one bit per frame in flight");
+
+static bool IsSameBox( AABB2 const& a, AABB2 const& b )
+{
+	return a.m_mins == b.m_mins && a.m_maxs == b.m_maxs;
+}
+
+/// glyphs past ASCII come from the font's glyph cache, which can move or evict them
+static bool UsesGlyphCache( std::string_view text )
+{
+	return std::any_of( text.begin(), text.end(), []( char c ) { return (unsigned char)c >= 0x7f; } );
+}
+
+static bool IsSameColor( Rgba8 const& a, Rgba8 const& b )
+{
+	return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+TextMesh::~TextMesh()
+{
+	if (m_vertexBufferBinding.m_vertexBuffer) {
+		g_theRenderer->DeferredDestroyBuffer( m_vertexBufferBinding.m_vertexBuffer, false );
+	}
+}
+
+void TextMesh::BeginTexts()
+{
+	m_entryCount = 0;
+}
+
+void TextMesh::AddTextInBox2D( Font const* font, std::string_view text, AABB2 const& box, Rgba8 const& color, float textSize, Vec2 const& alignment, TextBoxMode mode, float zHeight )
+{
+	if (m_entryCount == m_entries.size()) {
+		m_entries.emplace_back();
+		m_isDirty = true;
+	}
+	TextMeshEntry& entry = m_entries[m_entryCount++];
+	uint64_t glyphGeneration = UsesGlyphCache( text ) ? font->GetGlyphGeneration() : 0;
+	if (entry.m_font != font || entry.m_glyphGeneration != glyphGeneration || entry.m_text != text || !IsSameBox( entry.m_box, box ) || !IsSameColor( entry.m_color, color )
+		|| entry.m_textSize != textSize || entry.m_alignment != alignment || entry.m_mode != mode || entry.m_zHeight != zHeight) {
+		entry.m_font = font;
+		entry.m_text.assign( text );
+		entry.m_box = box;
+		entry.m_color = color;
+		entry.m_textSize = textSize;
+		entry.m_alignment = alignment;
+		entry.m_mode = mode;
+		entry.m_zHeight = zHeight;
+		entry.m_glyphGeneration = glyphGeneration;
+		m_isDirty = true;
+	}
+}
+
+void TextMesh::EndTexts()
+{
+	if (m_entryCount != m_entries.size()) {
+		m_entries.resize( m_entryCount );
+		m_isDirty = true;
+	}
+	if (m_isDirty) {
+		Layout();
+	}
+}
+
+void TextMesh::UploadTexts()
+{
+	if (m_verts.size() > m_capacity) {
+		// the frames still in flight draw from the old buffer, it goes once they are done
+		if (m_vertexBufferBinding.m_vertexBuffer) {
+			g_theRenderer->DeferredDestroyBuffer( m_vertexBufferBinding.m_vertexBuffer, false );
+		}
+		m_capacity = std::max( (uint32_t)m_verts.size(), m_capacity * 2 );
+		m_vertexBufferBinding.m_vertexBuffer = g_theRenderer->CreateDynamicVertexBuffer( (uint64_t)m_capacity * sizeof( VertexPCU3D ) * MAX_FRAMES_IN_FLIGHT );
+		m_upToDateFrames = 0;
+	}
+	if (m_verts.empty()) {
+		m_vertexBufferBinding.m_vertexBufferVertexCount = 0;
+		return;
+	}
+
+	// the copy of this frame in flight is no longer read by the GPU, so it can be written now
+	uint32_t frameIndex = g_theRenderer->GetCurFrameNumber();
+	uint64_t offset = (uint64_t)frameIndex * m_capacity * sizeof( VertexPCU3D );
+	if ((m_upToDateFrames & (1u << frameIndex)) == 0) {
+		memcpy( (char*)m_vertexBufferBinding.m_vertexBuffer->m_mappedData + offset, m_verts.data(), m_verts.size() * sizeof( VertexPCU3D ) );
+		m_upToDateFrames |= 1u << frameIndex;
+	}
+	m_vertexBufferBinding.m_vertexBufferOffset = offset;
+	m_vertexBufferBinding.m_vertexBufferVertexCount = (uint32_t)m_verts.size();
+}
+
+VertexBufferBinding const& TextMesh::GetVertexBufferBinding() const
+{
+	return m_vertexBufferBinding;
+}
+
+bool TextMesh::IsEmpty() const
+{
+	return m_vertexBufferBinding.m_vertexBufferVertexCount == 0;
+}
+
+uint64_t TextMesh::GetLayoutCount() const
+{
+	return m_layoutCount;
+}
+
+void TextMesh::Layout()
+{
+	m_verts.clear();
+	for (TextMeshEntry const& entry : m_entries) {
+		entry.m_font->AddVertsForTextInBox2D( m_verts, entry.m_text, entry.m_box, entry.m_color, entry.m_textSize, entry.m_alignment, entry.m_mode, entry.m_zHeight );
+	}
+	m_isDirty = false;
+	m_upToDateFrames = 0;
+	++m_layoutCount;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Graphics/Font.h"
+#include "Graphics/GraphicsCommon.h"
+
+/// Everything the layout of one text depends on
+struct TextMeshEntry {
+	Font const* m_font = nullptr;
+	std::string m_text;
+	AABB2 m_box;
+	Rgba8 m_color;
+	float m_textSize = 0.f;
+	Vec2 m_alignment;
+	TextBoxMode m_mode = TextBoxMode::SHRINK_TO_FIT;
+	float m_zHeight = 0.f;
+	/// glyph cache generation of the font when laid out, 0 for ASCII only text which does not use the cache
+	uint64_t m_glyphGeneration = 0;
+};
+
+/// Texts laid out once, laid out again only when one of them changes
+/// Describe every text each frame between BeginTexts and EndTexts, an unchanged text only costs a comparison
+/// The vertices stay in a dynamic buffer across frames, after a layout each frame in flight copy is written once
+/// Describing and laying out touch only the mesh and can run on any thread, UploadTexts has to run on the main thread
+class TextMesh {
+public:
+	TextMesh() = default;
+	~TextMesh();
+	TextMesh( TextMesh const& textMesh ) = delete;
+
+	void BeginTexts();
+	void AddTextInBox2D( Font const* font, std::string_view text, AABB2 const& box, Rgba8 const& color, float textSize, Vec2 const& alignment, TextBoxMode mode = TextBoxMode::SHRINK_TO_FIT, float zHeight = 0.f );
+	/// lay the texts out if they changed
+	void EndTexts();
+	/// point the binding at the copy of the current frame in flight, writing it only if the texts were laid out since, once a frame after EndTexts
+	/// the buffer grows when a layout has more vertices than it holds
+	void UploadTexts();
+
+	/// a quad per glyph, draw it with RendererInterface::DrawQuads
+	VertexBufferBinding const& GetVertexBufferBinding() const;
+	/// true before the first UploadTexts and when there is nothing to draw
+	bool IsEmpty() const;
+	/// number of times the texts were laid out, stays constant while they do not change
+	uint64_t GetLayoutCount() const;
+
+protected:
+	void Layout();
+
+	std::vector<TextMeshEntry> m_entries;
+	uint32_t m_entryCount = 0;
+	bool m_isDirty = true;
+	uint64_t m_layoutCount = 0;
+	/// bit per frame in flight whose copy holds the current vertices
+	uint32_t m_upToDateFrames = 0;
+	/// vertices of one frame in flight copy
+	uint32_t m_capacity = 0;
+	std::vector<VertexPCU3D> m_verts;
+	VertexBufferBinding m_vertexBufferBinding;
+};
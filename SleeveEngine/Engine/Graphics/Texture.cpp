@@ -2,7 +2,9 @@
 
 Texture::~Texture()
 {
-	vkDestroyImageView( m_device, m_textureImageView, nullptr );
-	vkDestroyImage( m_device, m_textureImage, nullptr );
-	vkFreeMemory( m_device, m_textureDeviceMemory, nullptr );
+	if (m_device) {
+		vkDestroyImageView( m_device, m_textureImageView, nullptr );
+		vkDestroyImage( m_device, m_textureImage, nullptr );
+		vkFreeMemory( m_device, m_textureDeviceMemory, nullptr );
+	}
 }
@@ -4,6 +4,7 @@
 
 class Texture {
 	friend class Renderer;
+	friend class NullRenderer;
 	friend class Shader;
 	friend class ResourceManager;
 	friend class Font;
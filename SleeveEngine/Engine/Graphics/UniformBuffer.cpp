@@ -33,6 +33,21 @@ bool UniformBuffer::FindProperPositionForSizeInBuffer( uint64_t& out_pos, uint64
 	return false;
 }
 
+void UniformBuffer::EnlargeBuffer( uint64_t newSize )
+{
+	if (newSize <= m_maxSize) {
+		return;
+	}
+	// grow the free block at the end or add one
+	if (!m_memoryBlocks.empty() && m_memoryBlocks.back().m_startPos + m_memoryBlocks.back().m_size == m_maxSize) {
+		m_memoryBlocks.back().m_size += newSize - m_maxSize;
+	}
+	else {
+		m_memoryBlocks.emplace_back( BufferMemoryBlock{ m_maxSize, newSize - m_maxSize } );
+	}
+	m_maxSize = newSize;
+}
+
 void UniformBuffer::ReturnMemory( uint64_t offset, uint64_t size )
 {
 	if (size > 0) {
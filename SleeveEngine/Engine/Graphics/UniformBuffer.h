@@ -6,14 +6,18 @@
 class UniformBuffer {
 public:
 	~UniformBuffer() {
-		vkDestroyBuffer( m_device, m_buffer, nullptr );
-		vkFreeMemory( m_device, m_uniformBufferMemory, nullptr );
+		if (m_device) {
+			vkDestroyBuffer( m_device, m_buffer, nullptr );
+			vkFreeMemory( m_device, m_uniformBufferMemory, nullptr );
+		}
 	}
 protected:
 	friend class Renderer;
+	friend class NullRenderer;
 	friend class Shader;
 	UniformBuffer( VkDevice device, uint64_t size );
 	bool FindProperPositionForSizeInBuffer( uint64_t& out_pos, uint64_t size );
+	void EnlargeBuffer( uint64_t newSize );
 	void ReturnMemory( uint64_t offset, uint64_t size );
 	VkDevice m_device = nullptr;
 	VkBuffer m_buffer = nullptr;
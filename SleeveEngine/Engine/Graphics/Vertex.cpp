@@ -1 +1,42 @@
 #include "Graphics/Vertex.h"
+
+#include <cmath>
+
+static uint16_t PackUnorm16( float value )
+{
+	value = value < 0.f ? 0.f : (value > 1.f ? 1.f : value);
+	return (uint16_t)std::lround( value * 65535.f );
+}
+
+VertexPCU2D::VertexPCU2D( Vec2 const& position, Rgba8 const& color, Vec2 const& uvCoord )
+	:m_position( position ), m_color( color ), m_uvCoord{ PackUnorm16( uvCoord.x ), PackUnorm16( uvCoord.y ) }
+{
+}
+
+VertexLayout const& GetVertexLayout( VertexFormat format )
+{
+	switch (format) {
+	case VertexFormat::PCU2D:
+		return VertexLayoutOf<VertexPCU2D>::LAYOUT;
+	case VertexFormat::PCU3D:
+	default:
+		return VertexLayoutOf<VertexPCU3D>::LAYOUT;
+	}
+}
+
+uint32_t GetVertexSize( VertexFormat format )
+{
+	return GetVertexLayout( format ).m_binding.stride;
+}
+
+VertexFormat GetShaderVertexFormat( std::string_view shaderName )
+{
+	return shaderName.ends_with( VERTEX_FORMAT_PCU2D_SHADER_SUFFIX ) ? VertexFormat::PCU2D : VertexFormat::PCU3D;
+}
+
+void ConvertVertices( VertexPCU3D const* vertices, size_t vertexCount, VertexPCU2D* out_vertices )
+{
+	for (size_t i = 0; i < vertexCount; ++i) {
+		out_vertices[i] = VertexPCU2D( Vec2( vertices[i].m_position.x, vertices[i].m_position.y ), vertices[i].m_color, vertices[i].m_uvCoord );
+	}
+}
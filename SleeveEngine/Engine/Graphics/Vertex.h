@@ -3,17 +3,97 @@
 #include "Math/MathFwd.h"
 #include "Core/Color.h"
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
 
-// ToDo: 2D version of vertex
-struct VertexPCU2D {
-	Vec2 m_position;
-	Rgba8 m_color;
-	Vec2 m_uvCoord;
+/// Vertex structs the pipelines can read, every format has its VertexLayoutOf specialization below
+enum class VertexFormat : uint8_t {
+	PCU3D,
+	PCU2D,
+};
+
+/// shader names ending with this read VertexPCU2D, see GetShaderVertexFormat
+constexpr char const* VERTEX_FORMAT_PCU2D_SHADER_SUFFIX = "_2d";
+constexpr uint32_t MAX_VERTEX_ATTRIBUTES = 4;
+
+/// One input of the vertex shader, locations follow the order the attributes are declared in
+struct VertexAttribute {
+	VkFormat m_format = VK_FORMAT_UNDEFINED;
+	uint32_t m_offset = 0;
 };
 
+/// Vulkan vertex input descriptions of one vertex struct, made at compile time by MakeVertexLayout
+struct VertexLayout {
+	VkVertexInputBindingDescription m_binding = {};
+	std::array<VkVertexInputAttributeDescription, MAX_VERTEX_ATTRIBUTES> m_attributes = {};
+	uint32_t m_attributeCount = 0;
+};
+
+template<typename Vertex, size_t AttributeCount>
+constexpr VertexLayout MakeVertexLayout( std::array<VertexAttribute, AttributeCount> const& attributes )
+{
+	static_assert(AttributeCount <= MAX_VERTEX_ATTRIBUTES, "raise MAX_VERTEX_ATTRIBUTES");
+	VertexLayout layout;
+	layout.m_binding.binding = 0;
+	layout.m_binding.stride = (uint32_t)sizeof( Vertex );
+	layout.m_binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+	for (uint32_t i = 0; i < (uint32_t)AttributeCount; ++i) {
+		layout.m_attributes[i].binding = 0;
+		layout.m_attributes[i].location = i;
+		layout.m_attributes[i].format = attributes[i].m_format;
+		layout.m_attributes[i].offset = attributes[i].m_offset;
+	}
+	layout.m_attributeCount = (uint32_t)AttributeCount;
+	return layout;
+}
+
+/// Specialized next to every vertex struct with its constexpr VertexLayout LAYOUT
+template<typename Vertex>
+struct VertexLayoutOf;
+
 // 3D version of vertex without normal
 struct VertexPCU3D {
 	Vec3 m_position; // position of the vertex
 	Rgba8 m_color; // color of the vertex, uses 8 bit RGBA from 0 - 255
 	Vec2 m_uvCoord; // uv in texture
-};
\ No newline at end of file
+};
+
+template<>
+struct VertexLayoutOf<VertexPCU3D> {
+	static constexpr VertexFormat FORMAT = VertexFormat::PCU3D;
+	static constexpr VertexLayout LAYOUT = MakeVertexLayout<VertexPCU3D, 3>( { {
+		{ VK_FORMAT_R32G32B32_SFLOAT, offsetof( VertexPCU3D, m_position ) },
+		{ VK_FORMAT_R8G8B8A8_UNORM, offsetof( VertexPCU3D, m_color ) },
+		{ VK_FORMAT_R32G32_SFLOAT, offsetof( VertexPCU3D, m_uvCoord ) },
+	} } );
+};
+
+/// Compact vertex of screen space UI and text, 16 bytes instead of the 24 of VertexPCU3D
+/// Positions stay 32 bit floats so pixel coordinates are exact, uvs are 16 bit unorm which is exact to 1/65535 of the texture
+struct VertexPCU2D {
+	VertexPCU2D() = default;
+	VertexPCU2D( Vec2 const& position, Rgba8 const& color, Vec2 const& uvCoord );
+
+	Vec2 m_position;
+	Rgba8 m_color;
+	std::array<uint16_t, 2> m_uvCoord = {};
+};
+static_assert(sizeof( VertexPCU2D ) == 16, "VertexPCU2D is expected to be 16 bytes");
+
+template<>
+struct VertexLayoutOf<VertexPCU2D> {
+	static constexpr VertexFormat FORMAT = VertexFormat::PCU2D;
+	static constexpr VertexLayout LAYOUT = MakeVertexLayout<VertexPCU2D, 3>( { {
+		{ VK_FORMAT_R32G32_SFLOAT, offsetof( VertexPCU2D, m_position ) },
+		{ VK_FORMAT_R8G8B8A8_UNORM, offsetof( VertexPCU2D, m_color ) },
+		{ VK_FORMAT_R16G16_UNORM, offsetof( VertexPCU2D, m_uvCoord ) },
+	} } );
+};
+
+VertexLayout const& GetVertexLayout( VertexFormat format );
+uint32_t GetVertexSize( VertexFormat format );
+/// the vertex struct the shader's pipeline reads, from the naming convention of VERTEX_FORMAT_PCU2D_SHADER_SUFFIX
+VertexFormat GetShaderVertexFormat( std::string_view shaderName );
+/// drop z, the transform of the draw places the 2D vertices
+void ConvertVertices( VertexPCU3D const* vertices, size_t vertexCount, VertexPCU2D* out_vertices );
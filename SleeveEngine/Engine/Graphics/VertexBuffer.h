@@ -7,14 +7,18 @@ class VertexBuffer {
 public:
 	~VertexBuffer()
 	{
-		vkDestroyBuffer( m_device, m_buffer, nullptr );
-		vkFreeMemory( m_device, m_deviceMemory, nullptr );
+		// buffers of the null renderer have no device
+		if (m_device) {
+			vkDestroyBuffer( m_device, m_buffer, nullptr );
+			vkFreeMemory( m_device, m_deviceMemory, nullptr );
+		}
 	};
 
 public:
 	void* m_mappedData = nullptr;
 protected:
 	friend class Renderer;
+	friend class NullRenderer;
 	VertexBuffer( VkDevice device, uint64_t size );
 	bool FindProperPositionForSizeInBuffer( uint64_t& out_pos, uint64_t size );
 	void EnlargeBuffer( uint64_t newSize );
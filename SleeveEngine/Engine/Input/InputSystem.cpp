@@ -22,6 +22,10 @@ void InputSystem::Initialize()
 
 void InputSystem::BeginFrame()
 {
+	// headless runs have no window to read the cursor from
+	if (!g_mainWindow) {
+		return;
+	}
 	double xPos, yPos;
 	glfwGetCursorPos( g_mainWindow->GetGLFWWindow(), &xPos, &yPos );
 	Vec2 thisFramePos = Vec2( (float)xPos, (float)yPos );
@@ -0,0 +1,161 @@
+#include "Engine/Graphics/Renderer.h"
+#include "Engine/Graphics/NullRenderer.h"
+#include "Engine/Graphics/RendererCaptureReplayer.h"
+#include "Engine/Core/EngineCommon.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct ReplayConfig {
+	std::string m_capturePath;
+	std::string m_outputPath;
+	bool m_useNullRenderer = false;
+	/// replays of the whole capture, the resources are created again for every one
+	uint32_t m_repetitions = 1;
+};
+
+/// Windows paths are full of backslashes
+static void WriteJsonString( FILE* file, char const* string )
+{
+	fputc( '"', file );
+	for (char const* c = string; *c; ++c) {
+		if (*c == '"' || *c == '\\') {
+			fputc( '\\', file );
+		}
+		fputc( *c, file );
+	}
+	fputc( '"', file );
+}
+
+static ReplayConfig ParseCommandLine( int argc, char* argv[] )
+{
+	ReplayConfig config;
+	for (int i = 1; i < argc; ++i) {
+		std::string_view arg = argv[i];
+		if (arg == "-nullrenderer") {
+			config.m_useNullRenderer = true;
+		}
+		else if (arg.starts_with( "-out=" )) {
+			config.m_outputPath = argv[i] + strlen( "-out=" );
+		}
+		else if (arg.starts_with( "-repetitions=" )) {
+			config.m_repetitions = std::max( 1u, (uint32_t)std::strtoul( argv[i] + strlen( "-repetitions=" ), nullptr, 10 ) );
+		}
+		else if (!arg.starts_with( "-" )) {
+			config.m_capturePath = argv[i];
+		}
+	}
+	return config;
+}
+
+static double GetPercentile( std::vector<double> sortedValues, double percentile )
+{
+	if (sortedValues.empty()) {
+		return 0.0;
+	}
+	size_t index = (size_t)(percentile * (double)(sortedValues.size() - 1) + 0.5);
+	return sortedValues[std::min( index, sortedValues.size() - 1 )];
+}
+
+/// Replays a capture written with the game's -capture=path option, no window and no game code
+/// RendererReplay capture.bin [-nullrenderer] [-repetitions=N] [-out=results.json]
+/// Run from CardGame/Run so textures and shaders captured by path are found
+int main( int argc, char* argv[] )
+{
+	ReplayConfig config = ParseCommandLine( argc, argv );
+	if (config.m_capturePath.empty()) {
+		printf( "usage: RendererReplay capture.bin [-nullrenderer] [-repetitions=N] [-out=results.json]\n" );
+		return 1;
+	}
+
+	std::vector<double> cpuFrameMilliseconds;
+	RendererFrameStatistics statisticsSum;
+	uint32_t frameCount = 0;
+	for (uint32_t repetition = 0; repetition < config.m_repetitions; ++repetition) {
+		RendererConfig rendererConfig;
+		rendererConfig.m_headless = true;
+		if (config.m_useNullRenderer) {
+			g_theRenderer = new NullRenderer();
+		}
+		else {
+			g_theRenderer = new Renderer();
+		}
+		g_theRenderer->Initialize( rendererConfig );
+
+		RendererCaptureReplayer* replayer = new RendererCaptureReplayer( g_theRenderer );
+		replayer->Load( config.m_capturePath );
+		frameCount = replayer->GetFrameCount();
+		while (true) {
+			auto startTime = std::chrono::steady_clock::now();
+			if (!replayer->ReplayNextFrame()) {
+				break;
+			}
+			auto endTime = std::chrono::steady_clock::now();
+			cpuFrameMilliseconds.push_back( std::chrono::duration<double, std::milli>( endTime - startTime ).count() );
+			RendererFrameStatistics const& statistics = g_theRenderer->GetLastFrameStatistics();
+			statisticsSum.m_draws += statistics.m_draws;
+			statisticsSum.m_pipelineBinds += statistics.m_pipelineBinds;
+			statisticsSum.m_descriptorSetsAllocated += statistics.m_descriptorSetsAllocated;
+			statisticsSum.m_descriptorSetWrites += statistics.m_descriptorSetWrites;
+			statisticsSum.m_vertexBytesDrawn += statistics.m_vertexBytesDrawn;
+			statisticsSum.m_indexBytesDrawn += statistics.m_indexBytesDrawn;
+			statisticsSum.m_uniformUploadBytes += statistics.m_uniformUploadBytes;
+		}
+
+		g_theRenderer->WaitForCleanup();
+		delete replayer;
+		g_theRenderer->Cleanup();
+		delete g_theRenderer;
+		g_theRenderer = nullptr;
+	}
+
+	size_t measuredFrames = std::max( (size_t)1, cpuFrameMilliseconds.size() );
+	double meanMilliseconds = 0.0;
+	for (double milliseconds : cpuFrameMilliseconds) {
+		meanMilliseconds += milliseconds;
+	}
+	meanMilliseconds /= (double)measuredFrames;
+	std::vector<double> sortedMilliseconds = cpuFrameMilliseconds;
+	std::sort( sortedMilliseconds.begin(), sortedMilliseconds.end() );
+	double p50Milliseconds = GetPercentile( sortedMilliseconds, 0.5 );
+	double p99Milliseconds = GetPercentile( sortedMilliseconds, 0.99 );
+	char const* rendererName = config.m_useNullRenderer ? "null" : "vulkan";
+
+	printf( "Replayed %s: %u frames x %u on the %s renderer\n", config.m_capturePath.c_str(), frameCount, config.m_repetitions, rendererName );
+	printf( "  cpu frame ms      mean %.3f  p50 %.3f  p99 %.3f\n", meanMilliseconds, p50Milliseconds, p99Milliseconds );
+	printf( "  per frame         %.1f draws, %.1f pipeline binds, %.1f descriptor sets, %.1f descriptor writes\n",
+		(double)statisticsSum.m_draws / measuredFrames, (double)statisticsSum.m_pipelineBinds / measuredFrames,
+		(double)statisticsSum.m_descriptorSetsAllocated / measuredFrames, (double)statisticsSum.m_descriptorSetWrites / measuredFrames );
+	printf( "  bytes per frame   %.0f vertex, %.0f index, %.0f uniform upload\n",
+		(double)statisticsSum.m_vertexBytesDrawn / measuredFrames, (double)statisticsSum.m_indexBytesDrawn / measuredFrames,
+		(double)statisticsSum.m_uniformUploadBytes / measuredFrames );
+
+	if (!config.m_outputPath.empty()) {
+		FILE* file = nullptr;
+		fopen_s( &file, config.m_outputPath.c_str(), "w" );
+		if (!file) {
+			printf( "Cannot write %s\n", config.m_outputPath.c_str() );
+			return 1;
+		}
+		fprintf( file, "{\n" );
+		fprintf( file, "  \"capture\": " );
+		WriteJsonString( file, config.m_capturePath.c_str() );
+		fprintf( file, ",\n" );
+		fprintf( file, "  \"renderer\": \"%s\",\n", rendererName );
+		fprintf( file, "  \"frames\": %zu,\n", cpuFrameMilliseconds.size() );
+		fprintf( file, "  \"cpuFrameMeanMs\": %.6f,\n", meanMilliseconds );
+		fprintf( file, "  \"cpuFrameP50Ms\": %.6f,\n", p50Milliseconds );
+		fprintf( file, "  \"cpuFrameP99Ms\": %.6f,\n", p99Milliseconds );
+		fprintf( file, "  \"drawsPerFrame\": %.3f,\n", (double)statisticsSum.m_draws / measuredFrames );
+		fprintf( file, "  \"pipelineBindsPerFrame\": %.3f,\n", (double)statisticsSum.m_pipelineBinds / measuredFrames );
+		fprintf( file, "  \"descriptorSetWritesPerFrame\": %.3f\n", (double)statisticsSum.m_descriptorSetWrites / measuredFrames );
+		fprintf( file, "}\n" );
+		fclose( file );
+	}
+	return 0;
+}